@@ -156,7 +156,7 @@ char *dmi_get_str_abs(const char *id_str) {
 
     /* try dmidecode, but may require root */
     snprintf(full_path, PATH_MAX, "dmidecode -s %s", id_str);
-    spawned = g_spawn_command_line_sync(full_path,
+    spawned = h_spawn_command_line_sync(full_path,
             &out, &err, &i, NULL);
     if (spawned) {
         if (i == 0)
@@ -236,6 +236,7 @@ char *dmi_chassis_type_str(int chassis_type, gboolean with_val) {
 
 /* TODO: something better maybe */
 static char *dd_cache[128] = {};
+G_LOCK_DEFINE_STATIC(dd_cache);
 void dmidecode_cache_free()
 { int i; for(i = 0; i < 128; i++) g_free(dd_cache[i]); }
 
@@ -245,19 +246,22 @@ char *dmidecode_read(const dmi_type *type) {
     gboolean spawned;
     gchar *out, *err;
 
-    int i = 0;
+    int i = 0, slot = type ? *type : 127;
+
+    /* read from several threads during a report; dmidecode itself runs
+     * unlocked, and the first result stored is the one kept */
+    G_LOCK(dd_cache);
+    ret = g_strdup(dd_cache[slot]);
+    G_UNLOCK(dd_cache);
+    if (ret)
+        return ret;
 
-    if (type) {
-        if (dd_cache[*type])
-            return g_strdup(dd_cache[*type]);
+    if (type)
         snprintf(full_path, PATH_MAX, "dmidecode -t %"PRId32, *type);
-    } else {
-        if (dd_cache[127])
-            return g_strdup(dd_cache[127]);
+    else
         snprintf(full_path, PATH_MAX, "dmidecode");
-    }
 
-    spawned = g_spawn_command_line_sync(full_path,
+    spawned = h_spawn_command_line_sync(full_path,
             &out, &err, &i, NULL);
     if (spawned) {
         if (i == 0)
@@ -269,10 +273,10 @@ char *dmidecode_read(const dmi_type *type) {
     }
 
     if (ret) {
-        if (*type)
-            dd_cache[*type] = g_strdup(ret);
-        else
-            dd_cache[127] = g_strdup(ret);
+        G_LOCK(dd_cache);
+        if (!dd_cache[slot])
+            dd_cache[slot] = g_strdup(ret);
+        G_UNLOCK(dd_cache);
     }
 
     return ret;
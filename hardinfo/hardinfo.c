@@ -21,6 +21,7 @@
 
 #include <report.h>
 #include <hardinfo.h>
+#include <profiler.h>
 #include <iconcache.h>
 #include <stock.h>
 #include <vendor.h>
@@ -91,7 +92,7 @@ int main(int argc, char **argv)
 	return 0;
     }
 
-    if (!params.create_report && !params.run_benchmark) {
+    if (!params.create_report && !params.run_benchmark && !params.import_results) {
         /* we only try to open the UI if the user didn't ask for a report. */
         params.gui_running = ui_init(&argc, &argv);
 
@@ -105,8 +106,10 @@ int main(int argc, char **argv)
         }
     }
 
-    if (params.use_modules) {
-	/* load only selected modules */
+    profiler_init(params.profile, params.profile_trace);
+
+    if (params.use_modules || params.use_entries) {
+	/* load only selected modules, or those of the selected entries */
 	DEBUG("loading user-selected modules");
 	modules = modules_load_selected();
     } else {
@@ -133,6 +136,17 @@ int main(int argc, char **argv)
           g_print("%s\n", result);
           g_free(result);
         }
+    } else if (params.import_results) {
+        gchar *result;
+
+        result = module_call_method("benchmark::importResults");
+        if (!result) {
+          fprintf(stderr, _("benchmark.so not loaded"));
+          exit_code = 1;
+        } else {
+          g_print("%s\n", result);
+          g_free(result);
+        }
     } else if (params.gui_running) {
 	/* initialize gui and start gtk+ main loop */
 	icon_cache_init();
@@ -144,17 +158,13 @@ int main(int argc, char **argv)
 
 	gtk_main();
     } else if (params.create_report) {
-	/* generate report */
-	gchar *report;
-
+	/* generate report, written to stdout as it is made */
 	DEBUG("generating report");
 
-	report = report_create_from_module_list_format(modules,
-						       params.
-						       report_format);
-	g_print("%s", report);
-
-	g_free(report);
+	fflush(stdout);
+	if (!report_create_from_module_list_fd(modules, params.report_format,
+					       STDOUT_FILENO))
+	    exit_code = 1;
     } else {
         g_error(_("Don't know what to do. Exiting."));
     }
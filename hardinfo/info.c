@@ -18,7 +18,7 @@
 
 #include "hardinfo.h"
 
-static const gchar *info_column_titles[] = {
+const gchar *info_column_titles[INFO_COLUMN_MAX] = {
     "TextValue", "Value", "Progress", "Extra1", "Extra2"
 };
 
@@ -101,6 +101,69 @@ void info_add_computed_group(struct Info *info, const gchar *name, const gchar *
     g_array_append_val(info->groups, group);
 }
 
+static struct InfoField info_field_copy(const struct InfoField *field)
+{
+    struct InfoField copy = *field;
+
+    copy.name = g_strdup(field->name);
+    copy.value = g_strdup(field->value);
+    copy.tag = g_strdup(field->tag);
+    copy.free_name_on_flatten = TRUE;
+    copy.free_value_on_flatten = TRUE;
+
+    return copy;
+}
+
+static void info_field_free(struct InfoField *field)
+{
+    if (field->free_value_on_flatten)
+        g_free((gchar *)field->value);
+    if (field->free_name_on_flatten)
+        g_free((gchar *)field->name);
+
+    g_free(field->tag);
+}
+
+GArray *info_fields_new(void)
+{
+    return g_array_new(FALSE, FALSE, sizeof(struct InfoField));
+}
+
+void info_fields_add(GArray *fields, struct InfoField field)
+{
+    struct InfoField copy = info_field_copy(&field);
+
+    g_array_append_val(fields, copy);
+}
+
+void info_fields_free(GArray *fields)
+{
+    guint i;
+
+    if (!fields)
+        return;
+
+    for (i = 0; i < fields->len; i++)
+        info_field_free(&g_array_index(fields, struct InfoField, i));
+    g_array_free(fields, TRUE);
+}
+
+struct InfoGroup *info_add_fields_group(struct Info *info, const gchar *group_name,
+                                        const GArray *fields)
+{
+    struct InfoGroup *group = info_add_group(info, group_name, info_field_last());
+    guint i;
+
+    for (i = 0; fields && i < fields->len; i++) {
+        struct InfoField copy =
+            info_field_copy(&g_array_index(fields, struct InfoField, i));
+
+        g_array_append_val(group->fields, copy);
+    }
+
+    return group;
+}
+
 void info_set_column_title(struct Info *info, const gchar *column, const gchar *title)
 {
     int i;
@@ -184,6 +247,155 @@ static const GCompareFunc sort_functions[INFO_GROUP_SORT_MAX] = {
     [INFO_GROUP_SORT_TAG_DESCENDING] = info_field_cmp_tag_descending,
 };
 
+static void info_group_sort(struct InfoGroup *group)
+{
+    if (group->fields && group->sort != INFO_GROUP_SORT_NONE)
+        g_array_sort(group->fields, sort_functions[group->sort]);
+}
+
+gchar *info_field_get_flags(const struct InfoField *field)
+{
+    const gchar *tag = field->tag ? field->tag : "";
+
+    if (!*tag && !field->highlight && !field->report_details)
+        return NULL;
+
+    return g_strdup_printf("$%s%s%s$", field->highlight ? "*" : "",
+                           field->report_details ? "!" : "", tag);
+}
+
+gchar *info_field_get_value(const struct InfoField *field)
+{
+    if (field->unit)
+        return g_strdup_printf("%s %s", field->value, field->unit);
+
+    return g_strdup(field->value);
+}
+
+static void info_add_parsed_group(GArray *groups, GKeyFile *key_file,
+                                  const gchar *group_name)
+{
+    struct InfoGroup group = {
+        .name = g_strdup(group_name),
+        .fields = g_array_new(FALSE, FALSE, sizeof(struct InfoField)),
+        .free_name_on_flatten = TRUE,
+    };
+    gchar **keys;
+    gint i;
+
+    strend((gchar *)group.name, '#');
+
+    keys = g_key_file_get_keys(key_file, group_name, NULL, NULL);
+    for (i = 0; keys && keys[i]; i++) {
+        gchar *flags = NULL, *tag = NULL, *name = NULL;
+        struct InfoField field = {
+            .value = g_key_file_get_value(key_file, group_name, keys[i], NULL),
+            .free_name_on_flatten = TRUE,
+            .free_value_on_flatten = TRUE,
+        };
+
+        key_get_components(keys[i], &flags, &tag, &name, NULL, NULL, TRUE);
+        strend(name, '#');
+
+        field.name = name;
+        field.tag = tag ? tag : g_strdup("");
+        field.highlight = key_is_highlighted(flags);
+        field.report_details = key_wants_details(flags);
+        g_free(flags);
+
+        g_array_append_val(group.fields, field);
+    }
+    g_strfreev(keys);
+
+    g_array_append_val(groups, group);
+}
+
+/* computed groups are INI text, and may bring their own group headers */
+static void info_expand_computed_group(GArray *groups, const struct InfoGroup *group)
+{
+    GKeyFile *key_file = g_key_file_new();
+    gchar *text;
+
+    if (group->name)
+        text = g_strdup_printf("[%s]\n%s", group->name, group->computed);
+    else
+        text = g_strdup(group->computed);
+
+    if (g_key_file_load_from_data(key_file, text, strlen(text), 0, NULL)) {
+        gchar **names = g_key_file_get_groups(key_file, NULL);
+        gint i;
+
+        for (i = 0; names[i]; i++) {
+            if (names[i][0] != '$')
+                info_add_parsed_group(groups, key_file, names[i]);
+        }
+
+        g_strfreev(names);
+    }
+
+    g_free(text);
+    g_key_file_free(key_file);
+}
+
+void info_prepare(struct Info *info)
+{
+    GArray *groups;
+    guint i, j;
+
+    groups = g_array_sized_new(FALSE, FALSE, sizeof(struct InfoGroup),
+                               info->groups->len);
+
+    for (i = 0; i < info->groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+
+        if (group->fields)
+            g_array_append_val(groups, *group);
+        else if (group->computed)
+            info_expand_computed_group(groups, group);
+        else if (group->free_name_on_flatten)
+            g_free((gchar *)group->name);
+    }
+
+    g_array_free(info->groups, TRUE);
+    info->groups = groups;
+
+    for (i = 0; i < groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(groups, struct InfoGroup, i);
+
+        info_group_sort(group);
+
+        for (j = 0; j < group->fields->len; j++) {
+            struct InfoField *field = &g_array_index(group->fields, struct InfoField, j);
+
+            if (!field->tag)
+                field->tag = g_strdup_printf("ITEM%d-%d", i, j);
+        }
+    }
+}
+
+void info_free(struct Info *info)
+{
+    guint i, j;
+
+    for (i = 0; info->groups && i < info->groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+
+        if (group->fields) {
+            for (j = 0; j < group->fields->len; j++)
+                info_field_free(&g_array_index(group->fields, struct InfoField, j));
+
+            g_array_free(group->fields, TRUE);
+        }
+
+        if (group->free_name_on_flatten)
+            g_free((gchar *)group->name);
+    }
+
+    if (info->groups)
+        g_array_free(info->groups, TRUE);
+    g_free(info);
+}
+
 static void flatten_group(GString *output, const struct InfoGroup *group, guint group_count)
 {
     guint i;
@@ -191,9 +403,7 @@ static void flatten_group(GString *output, const struct InfoGroup *group, guint
     if (group->name != NULL)
         g_string_append_printf(output, "[%s]\n", group->name);
 
-    if (group->sort != INFO_GROUP_SORT_NONE) {
-        g_array_sort(group->fields, sort_functions[group->sort]);
-    }
+    info_group_sort((struct InfoGroup *)group);
 
     if (group->fields) {
         for (i = 0; i < group->fields->len; i++) {
@@ -213,14 +423,11 @@ static void flatten_group(GString *output, const struct InfoGroup *group, guint
                     field.report_details ? "!" : "",
                     tag);
 
-            g_string_append_printf(output, "%s=%s\n", field.name, field.value);
-
-            if (field.free_value_on_flatten)
-                g_free((gchar *)field.value);
-            if (field.free_name_on_flatten)
-                g_free((gchar *)field.name);
-
-            g_free(field.tag);
+            if (field.unit)
+                g_string_append_printf(output, "%s=%s %s\n", field.name,
+                                       field.value, field.unit);
+            else
+                g_string_append_printf(output, "%s=%s\n", field.name, field.value);
         }
     } else if (group->computed) {
         g_string_append_printf(output, "%s\n", group->computed);
@@ -245,8 +452,12 @@ static void flatten_shell_param(GString *output, const struct InfoGroup *group,
         }
 
         if (field.icon) {
-            g_string_append_printf(output, "Icon$ITEM%d-%d$=%s\n",
-                group_count, i, field.icon);
+            if (field.tag && *field.tag)
+                g_string_append_printf(output, "Icon$%s$=%s\n",
+                    field.tag, field.icon);
+            else
+                g_string_append_printf(output, "Icon$ITEM%d-%d$=%s\n",
+                    group_count, i, field.icon);
         }
     }
 }
@@ -279,11 +490,9 @@ static void flatten_shell_param_global(GString *output, const struct Info *info)
 
 gchar *info_flatten(struct Info *info)
 {
-    /* This is a scaffolding method: eventually the HardInfo shell should
-     * understand a struct Info instead of parsing these strings, which are
-     * brittle and unnecessarily complicates things.  Being a temporary
-     * method, no attention is paid to improve the memory allocation
-     * strategy. */
+    /* The shell and reports walk a struct Info directly (see
+     * info_prepare()); this is only kept for code that still wants the
+     * INI text. No attention is paid to the memory allocation strategy. */
     GString *values;
     GString *shell_param;
     guint i;
@@ -293,24 +502,19 @@ gchar *info_flatten(struct Info *info)
 
     if (info->groups) {
         for (i = 0; i < info->groups->len; i++) {
-            struct InfoGroup group =
-                g_array_index(info->groups, struct InfoGroup, i);
-
-            flatten_group(values, &group, i);
-            flatten_shell_param(shell_param, &group, i);
+            struct InfoGroup *group =
+                &g_array_index(info->groups, struct InfoGroup, i);
 
-            if (group.fields)
-                g_array_free(group.fields, TRUE);
+            flatten_group(values, group, i);
+            flatten_shell_param(shell_param, group, i);
         }
-
-        g_array_free(info->groups, TRUE);
     }
 
     flatten_shell_param_global(shell_param, info);
     g_string_append_printf(values, "[$ShellParam$]\n%s", shell_param->str);
 
     g_string_free(shell_param, TRUE);
-    g_free(info);
+    info_free(info);
 
     return g_string_free(values, FALSE);
 }
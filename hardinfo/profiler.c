@@ -0,0 +1,314 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2007 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* Wall time of module scans, method calls, spawned commands and field
+ * updates, for --profile and --profile-trace. Calls nest per thread, so
+ * each one also counts the child processes started while it ran. The
+ * table adds calls up by name, and commands by program; the trace has
+ * every call as a Chrome trace event, which chrome://tracing and
+ * Perfetto can open. Times include those of nested calls. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "hardinfo.h"
+#include "profiler.h"
+
+#define PROFILE_MAX_EVENTS  (1 << 20)
+
+struct _ProfileFrame {
+    ProfileKind kind;
+    gchar *name;
+    gint64 start;
+    guint spawned;
+    ProfileFrame *parent;
+};
+
+typedef struct {
+    ProfileKind kind;
+    gchar *name;
+    guint calls;
+    guint spawned;
+    gint64 total, max;         /* microseconds */
+} ProfileStat;
+
+typedef struct {
+    ProfileKind kind;
+    gchar *name;
+    gint64 start, duration;    /* microseconds */
+    guint spawned;
+    gint tid;
+} ProfileEvent;
+
+static const gchar *kind_names[PROFILE_N_KINDS] = { "scan", "method", "spawn", "field" };
+
+static gboolean profiling = FALSE;
+static gboolean print_table = FALSE;
+static gchar *trace_path = NULL;
+static gint64 epoch;
+static GHashTable *stats[PROFILE_N_KINDS];
+static GArray *events = NULL;
+static guint dropped_events = 0;
+static gint last_tid = 0;
+static GPrivate current_frame;
+static GPrivate thread_id;
+
+G_LOCK_DEFINE_STATIC(profiler);
+
+static void profile_stat_free(gpointer data)
+{
+    ProfileStat *stat = data;
+
+    g_free(stat->name);
+    g_free(stat);
+}
+
+void profiler_init(gboolean table, const gchar *trace_file)
+{
+    gint i;
+
+    if (!table && !trace_file)
+        return;
+
+    print_table = table;
+    trace_path = g_strdup(trace_file);
+
+    for (i = 0; i < PROFILE_N_KINDS; i++)
+        stats[i] = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, profile_stat_free);
+    if (trace_path)
+        events = g_array_new(FALSE, FALSE, sizeof(ProfileEvent));
+
+    epoch = g_get_monotonic_time();
+    profiling = TRUE;
+
+    /* the GUI quits with exit(), without going back to main() */
+    atexit(profiler_report);
+}
+
+static gint profile_thread_id(void)
+{
+    gint tid = GPOINTER_TO_INT(g_private_get(&thread_id));
+
+    if (!tid) {
+        tid = g_atomic_int_add(&last_tid, 1) + 1;
+        g_private_set(&thread_id, GINT_TO_POINTER(tid));
+    }
+
+    return tid;
+}
+
+ProfileFrame *profiler_begin(ProfileKind kind, const gchar *format, ...)
+{
+    ProfileFrame *frame;
+    va_list args;
+
+    if (!profiling)
+        return NULL;
+
+    frame = g_new0(ProfileFrame, 1);
+    frame->kind = kind;
+
+    va_start(args, format);
+    frame->name = g_strdup_vprintf(format, args);
+    va_end(args);
+
+    frame->parent = g_private_get(&current_frame);
+    g_private_set(&current_frame, frame);
+
+    frame->start = g_get_monotonic_time();
+    return frame;
+}
+
+/* "/usr/bin/lspci -v" -> "lspci" */
+static gchar *profile_program_name(const gchar *command_line)
+{
+    gchar *program, *name;
+
+    command_line += strspn(command_line, " \t");
+    program = g_strndup(command_line, strcspn(command_line, " \t"));
+    name = g_path_get_basename(program);
+    g_free(program);
+
+    return name;
+}
+
+static void profile_stat_add(const ProfileFrame *frame, gint64 duration)
+{
+    ProfileStat *stat;
+    gchar *name;
+
+    if (frame->kind == PROFILE_SPAWN)
+        name = profile_program_name(frame->name);
+    else
+        name = g_strdup(frame->name);
+
+    stat = g_hash_table_lookup(stats[frame->kind], name);
+    if (stat) {
+        g_free(name);
+    } else {
+        stat = g_new0(ProfileStat, 1);
+        stat->kind = frame->kind;
+        stat->name = name;
+        g_hash_table_insert(stats[frame->kind], stat->name, stat);
+    }
+
+    stat->calls++;
+    stat->spawned += frame->spawned;
+    stat->total += duration;
+    stat->max = MAX(stat->max, duration);
+}
+
+void profiler_end(ProfileFrame *frame)
+{
+    gint64 duration;
+
+    if (!frame)
+        return;
+
+    duration = g_get_monotonic_time() - frame->start;
+
+    if (frame->kind == PROFILE_SPAWN)
+        frame->spawned++;
+    if (frame->parent)
+        frame->parent->spawned += frame->spawned;
+    g_private_set(&current_frame, frame->parent);
+
+    G_LOCK(profiler);
+    profile_stat_add(frame, duration);
+    if (events && events->len < PROFILE_MAX_EVENTS) {
+        ProfileEvent event = {
+            .kind = frame->kind,
+            .name = frame->name,
+            .start = frame->start - epoch,
+            .duration = duration,
+            .spawned = frame->spawned,
+            .tid = profile_thread_id(),
+        };
+
+        g_array_append_val(events, event);
+        frame->name = NULL;
+    } else if (events) {
+        dropped_events++;
+    }
+    G_UNLOCK(profiler);
+
+    g_free(frame->name);
+    g_free(frame);
+}
+
+static gint profile_stat_cmp(gconstpointer a, gconstpointer b)
+{
+    const ProfileStat *sa = *(ProfileStat * const *)a;
+    const ProfileStat *sb = *(ProfileStat * const *)b;
+
+    if (sa->total != sb->total)
+        return sa->total < sb->total ? 1 : -1;
+    return g_strcmp0(sa->name, sb->name);
+}
+
+static void profile_print_table(void)
+{
+    GPtrArray *rows = g_ptr_array_new();
+    GHashTableIter iter;
+    gpointer stat;
+    guint i;
+
+    for (i = 0; i < PROFILE_N_KINDS; i++) {
+        g_hash_table_iter_init(&iter, stats[i]);
+        while (g_hash_table_iter_next(&iter, NULL, &stat))
+            g_ptr_array_add(rows, stat);
+    }
+    g_ptr_array_sort(rows, profile_stat_cmp);
+
+    fprintf(stderr, _("\nProfile, %.1f ms since start (times include nested calls):\n"),
+            (g_get_monotonic_time() - epoch) / 1000.0);
+    fprintf(stderr, "%-7s %7s %11s %11s %8s  %s\n",
+            _("Kind"), _("Calls"), _("Total ms"), _("Max ms"), _("Spawned"), _("Name"));
+
+    for (i = 0; i < rows->len; i++) {
+        ProfileStat *s = g_ptr_array_index(rows, i);
+
+        fprintf(stderr, "%-7s %7u %11.1f %11.1f %8u  %s\n",
+                kind_names[s->kind], s->calls, s->total / 1000.0,
+                s->max / 1000.0, s->spawned, s->name);
+    }
+
+    g_ptr_array_free(rows, TRUE);
+}
+
+static void profile_json_string(FILE *out, const gchar *s)
+{
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fprintf(out, "\\%c", *s);
+        else if ((guchar)*s < 0x20)
+            fprintf(out, "\\u%04x", (guchar)*s);
+        else
+            fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void profile_write_trace(void)
+{
+    FILE *out;
+    guint i;
+
+    if (!(out = fopen(trace_path, "w"))) {
+        fprintf(stderr, _("Cannot write profile trace to %s: %s\n"),
+                trace_path, g_strerror(errno));
+        return;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (i = 0; i < events->len; i++) {
+        ProfileEvent *e = &g_array_index(events, ProfileEvent, i);
+
+        fprintf(out, "%s{\"name\": ", i ? ",\n" : "");
+        profile_json_string(out, e->name);
+        fprintf(out, ", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %" G_GINT64_FORMAT
+                ", \"dur\": %" G_GINT64_FORMAT ", \"pid\": %d, \"tid\": %d"
+                ", \"args\": {\"spawned\": %u}}",
+                kind_names[e->kind], e->start, e->duration, (int)getpid(),
+                e->tid, e->spawned);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (fclose(out) != 0)
+        fprintf(stderr, _("Cannot write profile trace to %s: %s\n"),
+                trace_path, g_strerror(errno));
+    if (dropped_events)
+        fprintf(stderr, _("Profile trace is missing the last %u calls\n"), dropped_events);
+}
+
+void profiler_report(void)
+{
+    if (!profiling)
+        return;
+
+    G_LOCK(profiler);
+    if (print_table)
+        profile_print_table();
+    if (trace_path)
+        profile_write_trace();
+    G_UNLOCK(profiler);
+}
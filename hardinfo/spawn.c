@@ -0,0 +1,297 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2007 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* Every external command goes through here, so that a hung tool can't
+ * stall a report or the GUI: commands run in their own process group,
+ * which is killed when they take longer than their timeout or write
+ * more than H_SPAWN_MAX_OUTPUT. A command that timed out is reported as
+ * unavailable, like one that isn't installed. h_popen() runs the
+ * command to completion the same way and reads its output from memory. */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "hardinfo.h"
+#include "profiler.h"
+
+static void spawn_child_setup(gpointer data)
+{
+    /* its own process group, so a kill also takes its children */
+    setpgid(0, 0);
+}
+
+static void spawn_kill(GPid pid)
+{
+    kill(-pid, SIGKILL);
+    kill(pid, SIGKILL);
+}
+
+typedef enum {
+    SPAWN_DONE,
+    SPAWN_TIMED_OUT,
+    SPAWN_OUTPUT_CUT,
+} SpawnState;
+
+/* reads fds[] until both are closed */
+static SpawnState spawn_read(gint fds[2], GString *out[2], gint64 deadline,
+                             const gchar *name)
+{
+    gchar buffer[4096];
+
+    while (fds[0] >= 0 || fds[1] >= 0) {
+        struct pollfd pfd[2];
+        gint i, n = 0, timeout;
+
+        timeout = (deadline - g_get_monotonic_time()) / 1000;
+        if (timeout <= 0)
+            return SPAWN_TIMED_OUT;
+
+        for (i = 0; i < 2; i++) {
+            if (fds[i] >= 0) {
+                pfd[n].fd = fds[i];
+                pfd[n].events = POLLIN;
+                pfd[n].revents = 0;
+                n++;
+            }
+        }
+
+        if (poll(pfd, n, timeout) < 0) {
+            if (errno == EINTR)
+                continue;
+            return SPAWN_TIMED_OUT;    /* can't wait for it, give up */
+        }
+
+        for (i = 0; i < 2; i++) {
+            gint j;
+            gssize len;
+
+            for (j = 0; j < n && pfd[j].fd != fds[i]; j++);
+            if (fds[i] < 0 || j == n || !pfd[j].revents)
+                continue;
+
+            len = read(fds[i], buffer, sizeof(buffer));
+            if (len < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+            if (len <= 0) {
+                close(fds[i]);
+                fds[i] = -1;
+                continue;
+            }
+
+            if (out[i]->len + len > H_SPAWN_MAX_OUTPUT) {
+                g_string_append_len(out[i], buffer, H_SPAWN_MAX_OUTPUT - out[i]->len);
+                DEBUG("output of ``%s'' cut at %d bytes", name, H_SPAWN_MAX_OUTPUT);
+                return SPAWN_OUTPUT_CUT;
+            }
+            g_string_append_len(out[i], buffer, len);
+        }
+    }
+
+    return SPAWN_DONE;
+}
+
+/* the child may close its output and keep running */
+static gboolean spawn_wait(GPid pid, gint *status, gint64 deadline)
+{
+    gulong delay = 1000;
+
+    for (;;) {
+        pid_t ret = waitpid(pid, status, WNOHANG);
+
+        if (ret == pid || (ret < 0 && errno != EINTR))
+            return TRUE;
+        if (g_get_monotonic_time() >= deadline)
+            return FALSE;
+
+        g_usleep(delay);
+        delay = MIN(delay * 2, 50000);
+    }
+}
+
+static gboolean spawn_argv(gchar **argv, const gchar *name, gint timeout_ms,
+                           gchar **standard_output, gchar **standard_error,
+                           gint *exit_status, GError **error)
+{
+    ProfileFrame *frame;
+    GString *out[2];
+    gint fds[2] = { -1, -1 };
+    gint64 deadline;
+    SpawnState state;
+    gint i, status = 0;
+    GPid pid;
+
+    frame = profiler_begin(PROFILE_SPAWN, "%s", name);
+
+    if (!g_spawn_async_with_pipes(NULL, argv, NULL,
+                                  G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                                  spawn_child_setup, NULL, &pid, NULL,
+                                  standard_output ? &fds[0] : NULL,
+                                  standard_error ? &fds[1] : NULL, error)) {
+        profiler_end(frame);
+        return FALSE;
+    }
+
+    deadline = g_get_monotonic_time() + (gint64) timeout_ms * 1000;
+    out[0] = g_string_new(NULL);
+    out[1] = g_string_new(NULL);
+
+    state = spawn_read(fds, out, deadline, name);
+    if (state == SPAWN_DONE && !spawn_wait(pid, &status, deadline))
+        state = SPAWN_TIMED_OUT;
+    if (state != SPAWN_DONE) {
+        spawn_kill(pid);
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+    }
+    g_spawn_close_pid(pid);
+
+    for (i = 0; i < 2; i++) {
+        if (fds[i] >= 0)
+            close(fds[i]);
+    }
+
+    profiler_end(frame);
+
+    /* output that was cut short is still used */
+    if (state == SPAWN_TIMED_OUT) {
+        g_string_free(out[0], TRUE);
+        g_string_free(out[1], TRUE);
+
+        if (!params.gui_running)
+            fprintf(stderr, _("``%s'' timed out after %d ms and was stopped\n"),
+                    name, timeout_ms);
+        g_set_error(error, G_SPAWN_ERROR, G_SPAWN_ERROR_FAILED,
+                    _("``%s'' is unavailable (timed out)"), name);
+        return FALSE;
+    }
+
+    if (standard_output)
+        *standard_output = g_string_free(out[0], FALSE);
+    else
+        g_string_free(out[0], TRUE);
+    if (standard_error)
+        *standard_error = g_string_free(out[1], FALSE);
+    else
+        g_string_free(out[1], TRUE);
+    if (exit_status)
+        *exit_status = status;
+
+    return TRUE;
+}
+
+gboolean
+h_spawn_command_line_timeout(const gchar *command_line, gint timeout_ms,
+                             gchar **standard_output, gchar **standard_error,
+                             gint *exit_status, GError **error)
+{
+    gchar **argv;
+    gboolean spawned;
+
+    if (!g_shell_parse_argv(command_line, NULL, &argv, error))
+        return FALSE;
+
+    spawned = spawn_argv(argv, command_line, timeout_ms, standard_output,
+                         standard_error, exit_status, error);
+    g_strfreev(argv);
+
+    return spawned;
+}
+
+gboolean
+h_spawn_command_line_sync(const gchar *command_line, gchar **standard_output,
+                          gchar **standard_error, gint *exit_status, GError **error)
+{
+    return h_spawn_command_line_timeout(command_line, H_SPAWN_TIMEOUT,
+                                        standard_output, standard_error,
+                                        exit_status, error);
+}
+
+/* FILE * -> PopenResult *, for the streams h_popen() opened */
+typedef struct {
+    gchar *output;
+    gint status;
+} PopenResult;
+
+static GHashTable *popen_results = NULL;
+G_LOCK_DEFINE_STATIC(popen_results);
+
+FILE *
+h_popen(const gchar *command, const gchar *mode)
+{
+    gchar *argv[] = { "/bin/sh", "-c", (gchar *) command, NULL };
+    PopenResult *result;
+    FILE *stream;
+
+    g_return_val_if_fail(g_str_equal(mode, "r"), NULL);
+
+    result = g_new0(PopenResult, 1);
+    if (!spawn_argv(argv, command, H_SPAWN_TIMEOUT, &result->output, NULL,
+                    &result->status, NULL)) {
+        g_free(result);
+        return NULL;
+    }
+
+    /* fmemopen() of an empty buffer fails with older C libraries */
+    if (*result->output)
+        stream = fmemopen(result->output, strlen(result->output), "r");
+    else
+        stream = fopen("/dev/null", "r");
+
+    if (!stream) {
+        g_free(result->output);
+        g_free(result);
+        return NULL;
+    }
+
+    G_LOCK(popen_results);
+    if (!popen_results)
+        popen_results = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_insert(popen_results, stream, result);
+    G_UNLOCK(popen_results);
+
+    return stream;
+}
+
+int
+h_pclose(FILE *stream)
+{
+    PopenResult *result = NULL;
+    int status = -1;
+
+    G_LOCK(popen_results);
+    if (popen_results) {
+        result = g_hash_table_lookup(popen_results, stream);
+        g_hash_table_remove(popen_results, stream);
+    }
+    G_UNLOCK(popen_results);
+
+    fclose(stream);
+
+    if (result) {
+        status = result->status;
+        g_free(result->output);
+        g_free(result);
+    }
+
+    return status;
+}
@@ -34,6 +34,7 @@
 #include <shell.h>
 #include <iconcache.h>
 #include <hardinfo.h>
+#include <profiler.h>
 #include <gtk/gtk.h>
 
 #include <binreloc.h>
@@ -56,15 +57,20 @@ gchar *find_program(gchar *program_name)
     int i;
     char *temp;
     static GHashTable *cache = NULL;
+    G_LOCK_DEFINE_STATIC(cache);
     const char *path[] = { "/usr/local/bin", "/usr/local/sbin",
 		                   "/usr/bin", "/usr/sbin",
 		                   "/bin", "/sbin",
 		                   NULL };
 
+    /* report scans call this from several threads */
+    G_LOCK(cache);
+
     /* we don't need to call stat() every time: cache the results */
     if (!cache) {
     	cache = g_hash_table_new(g_str_hash, g_str_equal);
     } else if ((temp = g_hash_table_lookup(cache, program_name))) {
+    	G_UNLOCK(cache);
     	return g_strdup(temp);
     }
 
@@ -73,6 +79,7 @@ gchar *find_program(gchar *program_name)
 
     	if (g_file_test(temp, G_FILE_TEST_IS_EXECUTABLE)) {
     		g_hash_table_insert(cache, program_name, g_strdup(temp));
+		G_UNLOCK(cache);
 		return temp;
     	}
 
@@ -82,10 +89,10 @@ gchar *find_program(gchar *program_name)
     /* our search has failed; use GLib's search (which uses $PATH env var) */
     if ((temp = g_find_program_in_path(program_name))) {
     	g_hash_table_insert(cache, program_name, g_strdup(temp));
-    	return temp;
     }
 
-    return NULL;
+    G_UNLOCK(cache);
+    return temp;
 }
 
 gchar *seconds_to_string(unsigned int seconds)
@@ -393,8 +400,17 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
     static gchar *report_format = NULL;
     static gchar *run_benchmark = NULL;
     static gchar *result_format = NULL;
+    static gchar *bench_duration = NULL;
+    static gint bench_sustained = 0;
+    static gboolean bench_progress = FALSE;
     static gchar **use_modules = NULL;
+    static gchar **use_entries = NULL;
+    static gchar **import_results = NULL;
     static gint max_bench_results = 10;
+    static gboolean bench_similar = FALSE;
+    static gint report_jobs = 0;
+    static gboolean profile = FALSE;
+    static gchar *profile_trace = NULL;
 
     static GOptionEntry options[] = {
 	{
@@ -408,7 +424,13 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 	 .short_name = 'f',
 	 .arg = G_OPTION_ARG_STRING,
 	 .arg_data = &report_format,
-	 .description = N_("chooses a report format ([text], html)")},
+	 .description = N_("chooses a report format ([text], html, json)")},
+	{
+	 .long_name = "jobs",
+	 .short_name = 'j',
+	 .arg = G_OPTION_ARG_INT,
+	 .arg_data = &report_jobs,
+	 .description = N_("scan up to N report entries at once ([0] for one per CPU, 1 to scan in order)")},
 	{
 	 .long_name = "run-benchmark",
 	 .short_name = 'b',
@@ -420,13 +442,54 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 	 .short_name = 'g',
 	 .arg = G_OPTION_ARG_STRING,
 	 .arg_data = &result_format,
-	 .description = N_("benchmark result format ([short], conf, shell)")},
+	 .description = N_("benchmark result format ([short], conf, shell, json)")},
+	{
+	 .long_name = "bench-duration",
+	 .short_name = 'd',
+	 .arg = G_OPTION_ARG_STRING,
+	 .arg_data = &bench_duration,
+	 .description = N_("how long each benchmark runs (quick, [standard], extended)")},
+	{
+	 .long_name = "sustained",
+	 .short_name = 'u',
+	 .arg = G_OPTION_ARG_INT,
+	 .arg_data = &bench_sustained,
+	 .description = N_("run throughput benchmarks under sustained load for 5 to 30 minutes, to show throttling")},
+	{
+	 .long_name = "bench-progress",
+	 .flags = G_OPTION_FLAG_HIDDEN,
+	 .arg = G_OPTION_ARG_NONE,
+	 .arg_data = &bench_progress,
+	 .description = "print benchmark progress for the GUI"},
+	{
+	 .long_name = "import-results",
+	 .short_name = 'i',
+	 .arg = G_OPTION_ARG_FILENAME_ARRAY,
+	 .arg_data = &import_results,
+	 .description = N_("import benchmark result files or directories into the local result store; requires benchmark.so to be loaded")},
 	{
 	 .long_name = "max-results",
 	 .short_name = 'n',
 	 .arg = G_OPTION_ARG_INT,
 	 .arg_data = &max_bench_results,
 	 .description = N_("maximum number of benchmark results to include (-1 for no limit, default is 10)")},
+	{
+	 .long_name = "similar-results",
+	 .short_name = 'y',
+	 .arg = G_OPTION_ARG_NONE,
+	 .arg_data = &bench_similar,
+	 .description = N_("compare benchmark results with the most similar saved machines")},
+	{
+	 .long_name = "profile",
+	 .arg = G_OPTION_ARG_NONE,
+	 .arg_data = &profile,
+	 .description = N_("print the time taken by each scan, method call, command and field update on exit")},
+	{
+	 .long_name = "profile-trace",
+	 .arg = G_OPTION_ARG_FILENAME,
+	 .arg_data = &profile_trace,
+	 .description = N_("write the same timings as Chrome trace events to FILE on exit"),
+	 .arg_description = N_("FILE")},
 	{
 	 .long_name = "list-modules",
 	 .short_name = 'l',
@@ -439,6 +502,13 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 	 .arg = G_OPTION_ARG_STRING_ARRAY,
 	 .arg_data = &use_modules,
 	 .description = N_("specify module to load")},
+	{
+	 .long_name = "entries",
+	 .short_name = 'e',
+	 .arg = G_OPTION_ARG_STRING_ARRAY,
+	 .arg_data = &use_entries,
+	 .description = N_("creates a report of only these entries, loading just the modules needed (e.g. devices:processor,devices:sensors)"),
+	 .arg_description = N_("MODULE:ENTRY,...")},
 	{
 	 .long_name = "autoload-deps",
 	 .short_name = 'a',
@@ -484,6 +554,23 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 
     g_option_context_free(ctx);
 
+    /* -i takes one path per option; the paths after it go along too,
+     * as in ``hardinfo -i results/*.conf'' */
+    if (import_results && *argc >= 2) {
+	GPtrArray *paths = g_ptr_array_new();
+	gint i;
+
+	for (i = 0; import_results[i]; i++)
+	    g_ptr_array_add(paths, import_results[i]);
+	for (i = 1; i < *argc; i++)
+	    g_ptr_array_add(paths, g_strdup((*argv)[i]));
+	g_ptr_array_add(paths, NULL);
+
+	g_free(import_results);
+	import_results = (gchar **)g_ptr_array_free(paths, FALSE);
+	*argc = 1;
+    }
+
     if (*argc >= 2) {
 	g_print(_("Unrecognized arguments.\n"
 		"Try ``%s --help'' for more information.\n"), *(argv)[0]);
@@ -492,23 +579,78 @@ void parameters_init(int *argc, char ***argv, ProgramParameters * param)
 
     param->create_report = create_report;
     param->report_format = REPORT_FORMAT_TEXT;
+    param->report_jobs = report_jobs;
     param->show_version = show_version;
     param->list_modules = list_modules;
     param->use_modules = use_modules;
+    param->use_entries = NULL;
     param->run_benchmark = run_benchmark;
+    param->import_results = import_results;
     param->result_format = result_format;
+    param->bench_duration = bench_duration;
+    param->bench_sustained = bench_sustained;
+    param->bench_progress = bench_progress;
     param->max_bench_results = max_bench_results;
+    param->bench_similar = bench_similar;
+    param->profile = profile;
+    param->profile_trace = profile_trace;
     param->autoload_deps = autoload_deps;
     param->run_xmlrpc_server = run_xmlrpc_server;
     param->skip_benchmarks = skip_benchmarks;
     param->force_all_details = force_all_details;
     param->argv0 = *(argv)[0];
 
+    if (bench_duration && !g_str_equal(bench_duration, "quick") &&
+        !g_str_equal(bench_duration, "standard") && !g_str_equal(bench_duration, "extended")) {
+	g_print(_("Unknown benchmark duration ``%s''.\n"
+		"Try ``%s --help'' for more information.\n"), bench_duration, *(argv)[0]);
+	exit(1);
+    }
+
+    if (bench_sustained && (bench_sustained < 5 || bench_sustained > 30)) {
+	g_print(_("Sustained load runs take 5 to 30 minutes.\n"));
+	exit(1);
+    }
+
+    if (use_entries) {
+	/* -e a:b,c:d -e e:f; implies -r and loading dependencies */
+	GPtrArray *specs = g_ptr_array_new();
+	gint i, j;
+
+	for (i = 0; use_entries[i]; i++) {
+	    gchar **list = g_strsplit(use_entries[i], ",", -1);
+
+	    for (j = 0; list[j]; j++) {
+		gchar *spec = g_strstrip(list[j]);
+		gchar *colon = strchr(spec, ':');
+
+		if (!*spec) {
+		    g_free(spec);
+		    continue;
+		}
+		if (!colon || colon == spec || !colon[1]) {
+		    g_print(_("Entries are given as module:entry, not ``%s''.\n"
+			    "Try ``%s --help'' for more information.\n"), spec, *(argv)[0]);
+		    exit(1);
+		}
+		g_ptr_array_add(specs, spec);
+	    }
+	    g_free(list);
+	}
+	g_ptr_array_add(specs, NULL);
+
+	param->use_entries = (gchar **) g_ptr_array_free(specs, FALSE);
+	param->create_report = TRUE;
+	param->autoload_deps = TRUE;
+    }
+
     if (report_format) {
         if (g_str_equal(report_format, "html"))
             param->report_format = REPORT_FORMAT_HTML;
         if (g_str_equal(report_format, "shell"))
             param->report_format = REPORT_FORMAT_SHELL;
+        if (g_str_equal(report_format, "json"))
+            param->report_format = REPORT_FORMAT_JSON;
     }
 
     /* html ok?
@@ -593,7 +735,31 @@ gchar *strreplace(gchar *string, gchar *replace, gchar *replacement)
     return ret;
 }
 
+typedef struct {
+    ShellModule *module;
+    gpointer function;
+} ModuleMethod;
+
 static GHashTable *__module_methods = NULL;
+static GRecMutex __module_init_lock;
+
+/* runs hi_module_init() the first time anything of the module is used;
+ * a module's init may use its dependencies, hence the recursive lock */
+static void module_init(ShellModule * module)
+{
+    if (g_atomic_int_get(&module->initialized))
+	return;
+
+    g_rec_mutex_lock(&__module_init_lock);
+    if (!module->initialized) {
+	if (module->init) {
+	    DEBUG("initializing module ``%s''", g_module_name(module->dll));
+	    module->init();
+	}
+	g_atomic_int_set(&module->initialized, TRUE);
+    }
+    g_rec_mutex_unlock(&__module_init_lock);
+}
 
 static void module_register_methods(ShellModule * module)
 {
@@ -601,7 +767,8 @@ static void module_register_methods(ShellModule * module)
     gchar *method_name;
 
     if (__module_methods == NULL) {
-	__module_methods = g_hash_table_new(g_str_hash, g_str_equal);
+	__module_methods = g_hash_table_new_full(g_str_hash, g_str_equal,
+						 g_free, g_free);
     }
 
     if (g_module_symbol
@@ -609,15 +776,17 @@ static void module_register_methods(ShellModule * module)
 	ShellModuleMethod *methods;
 
 	for (methods = get_methods(); methods->name; methods++) {
-	    ShellModuleMethod method = *methods;
+	    ModuleMethod *method = g_new(ModuleMethod, 1);
 	    gchar *name = g_path_get_basename(g_module_name(module->dll));
 	    gchar *simple_name = strreplace(name, "lib", "");
 
 	    strend(simple_name, '.');
 
-	    method_name = g_strdup_printf("%s::%s", simple_name, method.name);
-	    g_hash_table_insert(__module_methods, method_name,
-				method.function);
+	    method->module = module;
+	    method->function = methods->function;
+
+	    method_name = g_strdup_printf("%s::%s", simple_name, methods->name);
+	    g_hash_table_insert(__module_methods, method_name, method);
 	    g_free(name);
 	    g_free(simple_name);
 	}
@@ -625,29 +794,53 @@ static void module_register_methods(ShellModule * module)
 
 }
 
+/* the function behind "module::method", with its module initialized */
+static gpointer module_method_lookup(gchar * method)
+{
+    ModuleMethod *mm;
+
+    if (__module_methods == NULL ||
+	!(mm = g_hash_table_lookup(__module_methods, method))) {
+	return NULL;
+    }
+
+    module_init(mm->module);
+    return mm->function;
+}
+
 gchar *module_call_method(gchar * method)
 {
     gchar *(*function) (void);
+    ProfileFrame *frame;
+    gchar *ret;
 
-    if (__module_methods == NULL) {
+    if (!(function = module_method_lookup(method))) {
 	return NULL;
     }
 
-    function = g_hash_table_lookup(__module_methods, method);
-    return function ? g_strdup(function()) : NULL;
+    frame = profiler_begin(PROFILE_METHOD, "%s", method);
+    ret = g_strdup(function());
+    profiler_end(frame);
+
+    return ret;
 }
 
 /* FIXME: varargs? */
 gchar *module_call_method_param(gchar * method, gchar * parameter)
 {
     gchar *(*function) (gchar *param);
+    ProfileFrame *frame;
+    gchar *ret;
 
-    if (__module_methods == NULL) {
+    if (!(function = module_method_lookup(method))) {
 	return NULL;
     }
 
-    function = g_hash_table_lookup(__module_methods, method);
-    return function ? g_strdup(function(parameter)) : NULL;
+    frame = profiler_begin(PROFILE_METHOD, "%s", method);
+    ret = g_strdup(function(parameter));
+    profiler_end(frame);
+
+    return ret;
 }
 
 static gboolean remove_module_methods(gpointer key, gpointer value, gpointer data)
@@ -662,7 +855,7 @@ static void module_unload(ShellModule * module)
     if (module->dll) {
         gchar *name;
 
-        if (module->deinit) {
+        if (module->deinit && module->initialized) {
         	DEBUG("cleaning up module \"%s\"", module->name);
 		module->deinit();
 	} else {
@@ -720,6 +913,91 @@ void module_unload_all(void)
     shell->selected = NULL;
 }
 
+/* -e module:entry, e.g. "devices:processor" */
+typedef struct {
+    gchar *spec;
+    gchar *module;		/* "devices.so" */
+    gchar *entry;		/* normalized, "processor" */
+    gboolean found;
+    GString *available;		/* entries the module has, for errors */
+} EntrySpec;
+
+static GSList *__entry_specs = NULL;
+
+/* "Operating System", "operating-system" -> "operatingsystem" */
+static gchar *entry_name_normalize(const gchar * name)
+{
+    GString *normalized = g_string_new(NULL);
+
+    for (; *name; name++) {
+	if (g_ascii_isalnum(*name))
+	    g_string_append_c(normalized, g_ascii_tolower(*name));
+	else if ((guchar) *name >= 0x80)
+	    g_string_append_c(normalized, *name);
+    }
+
+    return g_string_free(normalized, FALSE);
+}
+
+static void entry_specs_init(void)
+{
+    gint i;
+
+    for (i = 0; params.use_entries[i]; i++) {
+	EntrySpec *es = g_new0(EntrySpec, 1);
+	gchar *colon = strchr(params.use_entries[i], ':');
+
+	es->spec = params.use_entries[i];
+	/* module files are lowercase: Devices:processor is devices.so */
+	es->module = g_ascii_strdown(es->spec, colon - es->spec);
+	if (!g_str_has_suffix(es->module, "." G_MODULE_SUFFIX)) {
+	    gchar *tmp = es->module;
+
+	    es->module = g_strconcat(tmp, "." G_MODULE_SUFFIX, NULL);
+	    g_free(tmp);
+	}
+	es->entry = entry_name_normalize(colon + 1);
+	es->available = g_string_new(NULL);
+
+	__entry_specs = g_slist_append(__entry_specs, es);
+    }
+}
+
+/* with -e, a module only gets the entries asked for, or all of them if
+ * it was also given with -m */
+static gboolean module_entry_selected(const gchar * filename, const gchar * name)
+{
+    gchar *normalized, *translated;
+    gboolean selected = FALSE;
+    GSList *l;
+
+    if (!params.use_entries)
+	return TRUE;
+
+    normalized = entry_name_normalize(name);
+    translated = entry_name_normalize(_(name));
+
+    for (l = __entry_specs; l; l = l->next) {
+	EntrySpec *es = (EntrySpec *) l->data;
+
+	if (!g_str_equal(es->module, filename))
+	    continue;
+
+	if (g_str_equal(es->entry, normalized) ||
+	    g_str_equal(es->entry, translated)) {
+	    es->found = selected = TRUE;
+	}
+	g_string_append_printf(es->available, "%s%s",
+			       es->available->len ? ", " : "", normalized);
+    }
+
+    g_free(normalized);
+    g_free(translated);
+
+    return selected || (params.use_modules &&
+			g_strv_contains((const gchar * const *) params.use_modules, filename));
+}
+
 static ShellModule *module_load(gchar * filename)
 {
     ShellModule *module;
@@ -751,7 +1029,6 @@ static ShellModule *module_load(gchar * filename)
     g_free(tmp);
 
     if (module->dll) {
-	void (*init) (void);
 	ModuleEntry *(*get_module_entries) (void);
 	gint(*weight_func) (void);
 	gchar *(*name_func) (void);
@@ -764,9 +1041,10 @@ static ShellModule *module_load(gchar * filename)
 	    goto failed;
 	}
 
-	if (g_module_symbol(module->dll, "hi_module_init", (gpointer) & init)) {
-	    DEBUG("initializing module ``%s''", filename);
-	    init();
+	/* with -e, only modules that end up being used are initialized */
+	g_module_symbol(module->dll, "hi_module_init", (gpointer) & (module->init));
+	if (!params.use_entries) {
+	    module_init(module);
 	}
 
 	g_module_symbol(module->dll, "hi_module_get_weight",
@@ -785,6 +1063,7 @@ static ShellModule *module_load(gchar * filename)
 	entries = get_module_entries();
 	while (entries[i].name) {
         if (*entries[i].name == '#') { i++; continue; } /* skip */
+        if (!module_entry_selected(filename, entries[i].name)) { i++; continue; }
 
 	    ShellModuleEntry *entry = g_new0(ShellModuleEntry, 1);
 
@@ -805,6 +1084,7 @@ static ShellModule *module_load(gchar * filename)
 	    entry->func = entries[i].callback;
 	    entry->number = i;
 	    entry->flags = entries[i].flags;
+	    entry->module = module;
 
 	    module->entries = g_slist_append(module->entries, entry);
 
@@ -1001,7 +1281,65 @@ static GSList *modules_load(gchar ** module_list)
 
 GSList *modules_load_selected(void)
 {
-    return modules_load(params.use_modules);
+    GPtrArray *files;
+    GSList *modules, *selected = NULL, *l;
+    gint i;
+
+    if (!params.use_entries) {
+	return modules_load(params.use_modules);
+    }
+
+    entry_specs_init();
+
+    /* before modules_load(), which gives up when nothing loads at all */
+    for (l = __entry_specs; l; l = l->next) {
+	EntrySpec *es = (EntrySpec *) l->data;
+	gchar *path = g_build_filename(params.path_lib, "modules", es->module, NULL);
+	gboolean exists = g_file_test(path, G_FILE_TEST_EXISTS);
+
+	g_free(path);
+	if (!exists) {
+	    g_print(_("Unknown module in ``%s''.\n"
+		    "Try ``%s -l'' for a list of modules.\n"), es->spec, params.argv0);
+	    exit(1);
+	}
+    }
+
+    files = g_ptr_array_new();
+    for (i = 0; params.use_modules && params.use_modules[i]; i++)
+	g_ptr_array_add(files, params.use_modules[i]);
+    for (l = __entry_specs; l; l = l->next)
+	g_ptr_array_add(files, ((EntrySpec *) l->data)->module);
+    g_ptr_array_add(files, NULL);
+
+    modules = modules_load((gchar **) files->pdata);
+    g_ptr_array_free(files, TRUE);
+
+    for (l = __entry_specs; l; l = l->next) {
+	EntrySpec *es = (EntrySpec *) l->data;
+
+	if (es->found)
+	    continue;
+
+	if (es->available->len) {
+	    g_print(_("Unknown entry ``%s''; %s has: %s\n"),
+		    es->spec, es->module, es->available->str);
+	} else {
+	    g_print(_("Unknown module in ``%s''.\n"
+		    "Try ``%s -l'' for a list of modules.\n"), es->spec, params.argv0);
+	}
+	exit(1);
+    }
+
+    /* modules only loaded as dependencies are left out of the report */
+    for (l = modules; l; l = l->next) {
+	ShellModule *module = (ShellModule *) l->data;
+
+	if (module->entries)
+	    selected = g_slist_append(selected, module);
+    }
+
+    return selected;
 }
 
 GSList *modules_load_all(void)
@@ -1071,7 +1409,10 @@ void module_entry_scan_all_except(ModuleEntry * entries, gint except_entry)
 	g_free(text);
 
 	if ((scan_callback = entry.scan_callback)) {
+	    ProfileFrame *frame = profiler_begin(PROFILE_SCAN, "%s", _(entry.name));
+
 	    scan_callback(FALSE);
+	    profiler_end(frame);
 	}
     }
 
@@ -1084,25 +1425,41 @@ void module_entry_scan_all(ModuleEntry * entries)
     module_entry_scan_all_except(entries, -1);
 }
 
-void module_entry_reload(ShellModuleEntry * module_entry)
+static void module_entry_scan_profiled(ShellModuleEntry * module_entry, gboolean reload)
 {
+    ProfileFrame *frame;
 
     if (module_entry->scan_func) {
-	module_entry->scan_func(TRUE);
+	module_init(module_entry->module);
+
+	frame = profiler_begin(PROFILE_SCAN, "%s: %s",
+			       module_entry->module->name, module_entry->name);
+	module_entry->scan_func(reload);
+	profiler_end(frame);
     }
 }
 
+void module_entry_reload(ShellModuleEntry * module_entry)
+{
+    module_entry_scan_profiled(module_entry, TRUE);
+}
+
 void module_entry_scan(ShellModuleEntry * module_entry)
 {
-    if (module_entry->scan_func) {
-	module_entry->scan_func(FALSE);
-    }
+    module_entry_scan_profiled(module_entry, FALSE);
 }
 
 gchar *module_entry_get_field(ShellModuleEntry * module_entry, gchar * field)
 {
+   ProfileFrame *frame;
+   gchar *value;
+
    if (module_entry->fieldfunc) {
-   	return module_entry->fieldfunc(field);
+	frame = profiler_begin(PROFILE_FIELD, "%s: %s", module_entry->name, field);
+	value = module_entry->fieldfunc(field);
+	profiler_end(frame);
+
+	return value;
    }
 
    return NULL;
@@ -1111,12 +1468,32 @@ gchar *module_entry_get_field(ShellModuleEntry * module_entry, gchar * field)
 gchar *module_entry_function(ShellModuleEntry * module_entry)
 {
     if (module_entry->func) {
+	module_init(module_entry->module);
+
+	if (module_entry->flags & MODULE_FLAG_INFO)
+	    return info_flatten(((struct Info *(*)(void)) module_entry->func)());
+
 	return module_entry->func();
     }
 
     return NULL;
 }
 
+/* NULL if the entry only gives INI text; use module_entry_function() then */
+struct Info *module_entry_get_info(ShellModuleEntry * module_entry)
+{
+    struct Info *info;
+
+    if (!module_entry->func || !(module_entry->flags & MODULE_FLAG_INFO))
+	return NULL;
+
+    module_init(module_entry->module);
+    info = ((struct Info *(*)(void)) module_entry->func)();
+    info_prepare(info);
+
+    return info;
+}
+
 gchar *module_entry_get_moreinfo(ShellModuleEntry * module_entry, gchar * field)
 {
     if (module_entry->morefunc) {
@@ -1192,6 +1569,70 @@ gchar *h_strconcat(gchar * string1, ...)
     return concat;
 }
 
+/*
+ * Module output with a row per device is built with the functions below,
+ * in time linear in the number of rows; h_strdup_cprintf() and
+ * h_strconcat() copy everything built so far on each call.
+ */
+
+/* string, emptied but keeping its buffer, or a new GString: output
+ * rebuilt on every scan then lives in the same memory each time */
+GString *h_string_reuse(GString *string)
+{
+    if (!string)
+	return g_string_sized_new(1024);
+
+    return g_string_truncate(string, 0);
+}
+
+static void h_string_flatten_lines(GString *string, gsize from, const gchar *chars)
+{
+    for (; from < string->len; from++) {
+	if (strchr(chars, string->str[from]))
+	    string->str[from] = ' ';
+    }
+}
+
+/* Appends the key of an INI line, "$<tag>$<name>"; tag may start with
+ * the '*' and '!' flags, and may be NULL. A name that would be read as a
+ * group, a comment or flags gets an empty "$$" in front, and '=' and line
+ * breaks in it become spaces. */
+void h_string_append_key(GString *string, const gchar *tag, const gchar *name)
+{
+    gsize start;
+
+    if (tag) {
+	g_string_append_c(string, '$');
+	g_string_append(string, tag);
+	g_string_append_c(string, '$');
+    } else if (*name == '[' || *name == '#' || *name == '$') {
+	g_string_append(string, "$$");
+    }
+
+    start = string->len;
+    g_string_append(string, name);
+    h_string_flatten_lines(string, start, "=\r\n");
+}
+
+/* Appends a whole "key=value" line; line breaks in the value become spaces */
+void h_string_append_field(GString *string, const gchar *tag, const gchar *name,
+			   const gchar *format, ...)
+{
+    va_list args;
+    gsize start;
+
+    h_string_append_key(string, tag, name);
+    g_string_append_c(string, '=');
+
+    start = string->len;
+    va_start(args, format);
+    g_string_append_vprintf(string, format, args);
+    va_end(args);
+    h_string_flatten_lines(string, start, "\r\n");
+
+    g_string_append_c(string, '\n');
+}
+
 static gboolean h_hash_table_remove_all_true(gpointer key, gpointer data, gpointer user_data)
 {
     return TRUE;
@@ -1256,7 +1697,31 @@ h_sysfs_read_string(const gchar *endpoint, const gchar *entry)
 	return return_value;
 }
 
+/* Details are kept per section, "PREFIX:SECTION" -> (key -> value), the
+ * section being the leading capitals of the key: "DEV", "PCI0000:00:02.0"
+ * go in "DEV:PCI". A section that rescans drops its whole table instead
+ * of every entry being compared against its name. Section names are
+ * interned, there are only a few dozen of them.
+ *
+ * A detail may also be added as a function to write it, which is only
+ * called the first time the detail is looked up. The function may be
+ * slow (processor_meta() runs dmidecode), so it runs without the lock;
+ * threads looking the detail up at the same time each run it, and the
+ * first value stored is kept. */
 static GHashTable *_moreinfo = NULL;
+/* modules may be scanned from several threads for a report */
+static GRecMutex moreinfo_lock;
+
+typedef struct {
+	gchar *value;
+	MoreInfoFunc func;
+	gpointer data;
+	GDestroyNotify data_free;
+	gint running;		/* threads running func */
+	gboolean dropped;	/* no longer in the table */
+} MoreInfoEntry;
+
+#define MOREINFO_NAME_MAX 64
 
 void
 moreinfo_init(void)
@@ -1266,7 +1731,34 @@ moreinfo_init(void)
 		return;
 	}
 	DEBUG("initializing moreinfo");
-	_moreinfo = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	_moreinfo = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+					  (GDestroyNotify) g_hash_table_destroy);
+}
+
+/* called with the lock held; data goes once func has written the value
+ * or the detail was dropped, and no thread is running func any more */
+static void
+moreinfo_entry_release(MoreInfoEntry *entry)
+{
+	if (entry->running || (entry->func && !entry->dropped))
+		return;
+
+	if (entry->data_free)
+		entry->data_free(entry->data);
+	entry->data = NULL;
+	entry->data_free = NULL;
+
+	if (entry->dropped) {
+		g_free(entry->value);
+		g_free(entry);
+	}
+}
+
+static void
+moreinfo_entry_drop(MoreInfoEntry *entry)
+{
+	entry->dropped = TRUE;
+	moreinfo_entry_release(entry);
 }
 
 void
@@ -1281,21 +1773,104 @@ moreinfo_shutdown(void)
 	_moreinfo = NULL;
 }
 
+/* "DEV:MemTotal" without a prefix is prefix "DEV", key "MemTotal" */
+static const gchar *
+moreinfo_split_key(const gchar *prefix, const gchar *key,
+		   gchar prefix_buf[MOREINFO_NAME_MAX], const gchar **prefix_out)
+{
+	const gchar *colon;
+
+	if (prefix || !(colon = strchr(key, ':')) ||
+	    colon - key >= MOREINFO_NAME_MAX) {
+		*prefix_out = prefix ? prefix : "";
+		return key;
+	}
+
+	memcpy(prefix_buf, key, colon - key);
+	prefix_buf[colon - key] = '\0';
+	*prefix_out = prefix_buf;
+
+	return colon + 1;
+}
+
+/* the table for prefix:key, created if asked to; called with the lock held */
+static GHashTable *
+moreinfo_section(const gchar *prefix, const gchar *key, gboolean create)
+{
+	gchar buf[MOREINFO_NAME_MAX], *name = buf;
+	gsize prefix_len = strlen(prefix), section_len = 0;
+	GHashTable *section;
+
+	while (g_ascii_isupper(key[section_len]))
+		section_len++;
+
+	if (prefix_len + section_len + 2 > sizeof(buf))
+		name = g_malloc(prefix_len + section_len + 2);
+	memcpy(name, prefix, prefix_len);
+	name[prefix_len] = ':';
+	memcpy(name + prefix_len + 1, key, section_len);
+	name[prefix_len + section_len + 1] = '\0';
+
+	section = g_hash_table_lookup(_moreinfo, name);
+	if (!section && create) {
+		section = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+						(GDestroyNotify) moreinfo_entry_drop);
+		g_hash_table_insert(_moreinfo, (gpointer) g_intern_string(name), section);
+	}
+
+	if (name != buf)
+		g_free(name);
+
+	return section;
+}
+
+static void
+moreinfo_insert(const gchar *prefix, const gchar *key, MoreInfoEntry *entry)
+{
+	gchar prefix_buf[MOREINFO_NAME_MAX];
+	const gchar *p, *k;
+
+	k = moreinfo_split_key(prefix, key, prefix_buf, &p);
+
+	g_rec_mutex_lock(&moreinfo_lock);
+	g_hash_table_insert(moreinfo_section(p, k, TRUE), g_strdup(k), entry);
+	g_rec_mutex_unlock(&moreinfo_lock);
+}
+
 void
 moreinfo_add_with_prefix(gchar *prefix, gchar *key, gchar *value)
 {
+	MoreInfoEntry *entry;
+
 	if (G_UNLIKELY(!_moreinfo)) {
 		DEBUG("moreinfo not initialized");
+		g_free(value);
 		return;
 	}
 
-	if (prefix) {
-		gchar *hashkey = g_strconcat(prefix, ":", key, NULL);
-		g_hash_table_insert(_moreinfo, hashkey, value);
+	entry = g_new0(MoreInfoEntry, 1);
+	entry->value = value;
+	moreinfo_insert(prefix, key, entry);
+}
+
+void
+moreinfo_add_func_with_prefix(gchar *prefix, gchar *key, MoreInfoFunc func,
+			      gpointer data, GDestroyNotify data_free)
+{
+	MoreInfoEntry *entry;
+
+	if (G_UNLIKELY(!_moreinfo)) {
+		DEBUG("moreinfo not initialized");
+		if (data_free)
+			data_free(data);
 		return;
 	}
 
-	g_hash_table_insert(_moreinfo, g_strdup(key), value);
+	entry = g_new0(MoreInfoEntry, 1);
+	entry->func = func;
+	entry->data = data;
+	entry->data_free = data_free;
+	moreinfo_insert(prefix, key, entry);
 }
 
 void
@@ -1310,6 +1885,26 @@ _moreinfo_del_cb(gpointer key, gpointer value, gpointer data)
 	return g_str_has_prefix(key, data);
 }
 
+/* drops every detail whose "PREFIX:key" starts with prefix */
+static gboolean
+_moreinfo_del_section_cb(gpointer name, gpointer section, gpointer data)
+{
+	const gchar *prefix = data, *key_prefix;
+
+	if (g_str_has_prefix(name, prefix))
+		return TRUE;
+
+	/* "DEV:PCI0000:00" only drops part of "DEV:PCI"; the keys of "DEV:"
+	 * can't start with a capital, so "DEV:PCI" has nothing to do there */
+	if (g_str_has_prefix(prefix, name)) {
+		key_prefix = prefix + (strchr(name, ':') + 1 - (const gchar *) name);
+		if (!g_ascii_isupper(prefix[strlen(name)]))
+			g_hash_table_foreach_remove(section, _moreinfo_del_cb, (gpointer) key_prefix);
+	}
+
+	return FALSE;
+}
+
 void
 moreinfo_del_with_prefix(gchar *prefix)
 {
@@ -1318,7 +1913,9 @@ moreinfo_del_with_prefix(gchar *prefix)
 		return;
 	}
 
-	g_hash_table_foreach_remove(_moreinfo, _moreinfo_del_cb, prefix);
+	g_rec_mutex_lock(&moreinfo_lock);
+	g_hash_table_foreach_remove(_moreinfo, _moreinfo_del_section_cb, prefix);
+	g_rec_mutex_unlock(&moreinfo_lock);
 }
 
 void
@@ -1328,25 +1925,59 @@ moreinfo_clear(void)
 		DEBUG("moreinfo not initialized");
 		return;
 	}
+	g_rec_mutex_lock(&moreinfo_lock);
 	h_hash_table_remove_all(_moreinfo);
+	g_rec_mutex_unlock(&moreinfo_lock);
 }
 
 gchar *
 moreinfo_lookup_with_prefix(gchar *prefix, gchar *key)
 {
+	gchar prefix_buf[MOREINFO_NAME_MAX];
+	const gchar *p, *k;
+	GHashTable *section;
+	MoreInfoEntry *entry = NULL;
+	MoreInfoFunc func;
+	const gchar *result = NULL;
+	gchar *value;
+
 	if (G_UNLIKELY(!_moreinfo)) {
 		DEBUG("moreinfo not initialized");
 		return 0;
 	}
 
-	if (prefix) {
-		gchar *lookup_key = g_strconcat(prefix, ":", key, NULL);
-		gchar *result = g_hash_table_lookup(_moreinfo, lookup_key);
-		g_free(lookup_key);
-		return result;
+	k = moreinfo_split_key(prefix, key, prefix_buf, &p);
+
+	g_rec_mutex_lock(&moreinfo_lock);
+	section = moreinfo_section(p, k, FALSE);
+	if (section)
+		entry = g_hash_table_lookup(section, k);
+	if (!entry || !entry->func) {
+		result = entry ? entry->value : NULL;
+		g_rec_mutex_unlock(&moreinfo_lock);
+		return (gchar *) result;
+	}
+	func = entry->func;
+	entry->running++;
+	g_rec_mutex_unlock(&moreinfo_lock);
+
+	value = func(entry->data);
+
+	g_rec_mutex_lock(&moreinfo_lock);
+	entry->running--;
+	if (entry->func && !entry->dropped) {
+		entry->value = value;
+		entry->func = NULL;
+		result = value;
+	} else {
+		g_free(value);
+		if (!entry->dropped)
+			result = entry->value;
 	}
+	moreinfo_entry_release(entry);
+	g_rec_mutex_unlock(&moreinfo_lock);
 
-	return g_hash_table_lookup(_moreinfo, key);
+	return (gchar *) result;
 }
 
 gchar *
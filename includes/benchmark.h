@@ -9,38 +9,61 @@ enum {
     BENCHMARK_BLOWFISH_SINGLE,
     BENCHMARK_BLOWFISH_THREADS,
     BENCHMARK_BLOWFISH_CORES,
+    BENCHMARK_CONTENTION,
     BENCHMARK_CRYPTOHASH,
-    BENCHMARK_FIB,
+    BENCHMARK_DRAWING,
+    BENCHMARK_INTSORT,
+    BENCHMARK_INTERP_SINGLE,
+    BENCHMARK_INTERP_THREADS,
     BENCHMARK_NQUEENS,
+    BENCHMARK_TEXTPROC,
     BENCHMARK_ZLIB,
     BENCHMARK_FFT,
     BENCHMARK_RAYTRACE,
-    BENCHMARK_GUI,
+    BENCHMARK_RAYTRACE2,
+    BENCHMARK_PAGEFAULT,
+    BENCHMARK_NUMA,
+    BENCHMARK_SYSCALLS,
     BENCHMARK_N_ENTRIES
 } BenchmarkEntries;
 
 void benchmark_bfish_single(void);
 void benchmark_bfish_threads(void);
 void benchmark_bfish_cores(void);
+void benchmark_contention(void);
 void benchmark_cryptohash(void);
+void benchmark_drawing(void);
 void benchmark_fft(void);
-void benchmark_fib(void);
 void benchmark_fish(void);
-void benchmark_gui(void);
+void benchmark_interp_single(void);
+void benchmark_interp_threads(void);
+void benchmark_intsort(void);
 void benchmark_nqueens(void);
+void benchmark_numa(void);
+void benchmark_pagefault(void);
 void benchmark_raytrace(void);
+void benchmark_raytrace2(void);
+void benchmark_syscalls(void);
+void benchmark_textproc(void);
 void benchmark_zlib(void);
 
 typedef struct {
     double result;
     double elapsed_time;
     int threads_used;
+    char extra[1024]; /* "key=value;key=value", shown and saved with the result;
+                       * see bench_value_add_extra() */
 } bench_value;
 
 #define EMPTY_BENCH_VALUE {-1.0f,0,0}
 
 char *bench_value_to_str(bench_value r);
 bench_value bench_value_from_str(const char* str);
+void bench_value_add_extra(bench_value *r, const char *key, const char *fmt, ...);
+/* Saves a table too large for extra as <kind>-<benchmark>.csv in the
+ * user's config directory, next to the result store, and keeps its file
+ * name as "Table" in extra. */
+void bench_value_add_table(bench_value *r, const char *kind, const char *csv);
 
 /* Note:
  *    benchmark_parallel_for(): element [start] included, but [end] is excluded.
@@ -54,6 +77,57 @@ bench_value benchmark_parallel(gint n_threads, gpointer callback, gpointer callb
 bench_value benchmark_crunch_for(float seconds, gint n_threads,
                                gpointer callback, gpointer callback_data);
 
+/* benchmark_crunch_for(), but with --sustained it runs for that many
+ * minutes instead and keeps the burst and steady-state scores, the time
+ * to throttle and a load curve with the result; the whole 1 s series is
+ * saved as sustained-<benchmark>.csv in the user's config directory.
+ * scale turns completions/second into the benchmark's score. result is
+ * set so that result / elapsed_time is the steady-state rate. */
+bench_value benchmark_crunch_for_load(float seconds, gint n_threads, double scale,
+                                      gpointer callback, gpointer callback_data);
+
+/* Like benchmark_parallel_for() over [0, n), with n calibrated so the
+ * run takes about seconds; n is returned in *size and kept as
+ * "Work Size" in the result's extra. */
+bench_value benchmark_parallel_for_time(gint n_threads, double seconds, guint *size,
+                               gpointer callback, gpointer callback_data);
+
+/* For results kept in seconds of an old fixed workload: the time
+ * old_items items would have taken with the threads of r, a run of
+ * benchmark_parallel_for_time() over size items. */
+double benchmark_fixed_work_time(bench_value r, guint size, guint old_items);
+
+/* NUMA nodes from /sys/devices/system/node, numbered 0..n-1 in order
+ * of their node id; without NUMA there is one node with every CPU.
+ * benchmark_numa_pin() moves the calling thread to the node's CPUs and
+ * benchmark_numa_alloc() returns populated memory bound to the node
+ * (first-touch from the node if mbind() fails). */
+gint benchmark_numa_nodes(void);
+gint benchmark_numa_node_id(gint node);
+gint benchmark_numa_node_cpus(gint node);
+gboolean benchmark_numa_node_has_memory(gint node);
+gint benchmark_numa_distance(gint from, gint to);
+gboolean benchmark_numa_pin(gint node);
+gpointer benchmark_numa_alloc(gsize size, gint node);
+void benchmark_numa_free(gpointer p, gsize size);
+
+/* Suite profiles, chosen with --bench-duration: every benchmark scales
+ * its running time by the profile and reports a rate, so results from
+ * different profiles compare. */
+typedef enum {
+    BENCH_PROFILE_QUICK,
+    BENCH_PROFILE_STANDARD,
+    BENCH_PROFILE_EXTENDED,
+    BENCH_PROFILE_N
+} bench_profile;
+
+bench_profile benchmark_profile(void);
+const gchar *benchmark_profile_name(bench_profile profile);
+
+/* seconds to run something that takes standard_seconds in the
+ * standard profile */
+double benchmark_time(double standard_seconds);
+
 extern bench_value bench_results[BENCHMARK_N_ENTRIES];
 
 #endif /* __BENCHMARK_H__ */
@@ -29,6 +29,7 @@ void cb_refresh();
 void cb_copy_to_clipboard();
 void cb_side_pane();
 void cb_toolbar();
+void cb_similar_results();
 void cb_open_web_page();
 void cb_open_online_docs();
 void cb_open_online_docs_context();
@@ -101,12 +101,12 @@ struct _OperatingSystem {
     gchar *homedir;
     gchar *kernel_version;
 
-    gchar *languages;
+    GArray *languages;  /* of struct InfoField */
 
     gchar *desktop;
     gchar *username;
 
-    gchar *boots;
+    GArray *boots;      /* of struct InfoField */
 
     gchar *entropy_avail;
 };
@@ -140,12 +140,13 @@ struct _Distro {
     continue;                                 \
   }
 
-extern gchar *users;
-extern gchar *groups;
-extern gchar *fs_list;
+/* of struct InfoField, shown by the callbacks */
+extern GArray *users;
+extern GArray *groups;
+extern GArray *fs_list;
 extern GHashTable *_module_hash_table;
 extern Computer *computer;
-extern gchar *module_list;
+extern GArray *module_list;
 
 gchar *computer_get_formatted_loadavg();
 gchar *computer_get_formatted_uptime();
@@ -40,6 +40,9 @@ typedef enum {
   MODULE_FLAG_NONE = 0,
   MODULE_FLAG_NO_REMOTE = 1<<0,
   MODULE_FLAG_HAS_HELP = 1<<1,
+  MODULE_FLAG_NO_PARALLEL = 1<<2,   /* never scanned alongside other entries */
+  MODULE_FLAG_INFO = 1<<3,          /* callback returns a struct Info * */
+  MODULE_FLAG_INDEPENDENT = 1<<4,   /* scan shares no state with other entries */
 } ModuleEntryFlags;
 
 typedef struct _ModuleEntry		ModuleEntry;
@@ -56,6 +59,9 @@ struct _ProgramParameters {
   gboolean autoload_deps;
   gboolean run_xmlrpc_server;
   gboolean skip_benchmarks;
+  gboolean bench_similar;
+  gboolean bench_progress;   /* benchmark run for the GUI: print "@load" samples */
+  gboolean profile;          /* print where the time went on exit */
 
   /*
    * OK to use the common parts of HTML(4.0) and Pango Markup
@@ -67,10 +73,16 @@ struct _ProgramParameters {
 
   gint     report_format;
   gint     max_bench_results;
+  gint     bench_sustained;   /* minutes, 0 for normal runs */
+  gint     report_jobs;       /* threads scanning ahead for a report, 0 for one per CPU */
 
   gchar  **use_modules;
+  gchar  **use_entries;      /* -e module:entry, one per element */
   gchar   *run_benchmark;
+  gchar  **import_results;
   gchar   *result_format;
+  gchar   *bench_duration;
+  gchar   *profile_trace;    /* Chrome trace-event file written on exit */
   gchar   *path_lib;
   gchar   *path_data;
   gchar   *argv0;
@@ -137,6 +149,10 @@ gchar        *seconds_to_string(unsigned int seconds);
 
 gchar        *h_strdup_cprintf(const gchar *format, gchar *source, ...);
 gchar	     *h_strconcat(gchar *string1, ...);
+GString      *h_string_reuse(GString *string);
+void          h_string_append_key(GString *string, const gchar *tag, const gchar *name);
+void          h_string_append_field(GString *string, const gchar *tag, const gchar *name,
+                                    const gchar *format, ...) G_GNUC_PRINTF(4, 5);
 void          h_hash_table_remove_all (GHashTable *hash_table);
 
 void	      module_entry_scan_all_except(ModuleEntry *entries, gint except_entry);
@@ -144,6 +160,7 @@ void	      module_entry_scan_all(ModuleEntry *entries);
 void	      module_entry_reload(ShellModuleEntry *module_entry);
 void	      module_entry_scan(ShellModuleEntry *module_entry);
 gchar	     *module_entry_function(ShellModuleEntry *module_entry);
+struct Info  *module_entry_get_info(ShellModuleEntry *module_entry);
 const gchar  *module_entry_get_note(ShellModuleEntry *module_entry);
 gchar        *module_entry_get_field(ShellModuleEntry * module_entry, gchar * field);
 gchar        *module_entry_get_moreinfo(ShellModuleEntry * module_entry, gchar * field);
@@ -160,6 +177,27 @@ extern   ProgramParameters params;
 gchar		*module_call_method(gchar *method);
 gchar           *module_call_method_param(gchar * method, gchar * parameter);
 
+/* Child processes, in their own process group, killed after a timeout
+ * (milliseconds) and with at most H_SPAWN_MAX_OUTPUT bytes of output
+ * each on stdout and stderr; a timeout fails like a missing command.
+ * These are also counted and timed by --profile. */
+#define H_SPAWN_TIMEOUT		10000
+#define H_SPAWN_TIMEOUT_PROBE	3000	/* --version and the like */
+#define H_SPAWN_MAX_OUTPUT	(8 << 20)
+
+gboolean	h_spawn_command_line_sync(const gchar *command_line,
+					  gchar **standard_output,
+					  gchar **standard_error,
+					  gint *exit_status, GError **error);
+gboolean	h_spawn_command_line_timeout(const gchar *command_line,
+					     gint timeout_ms,
+					     gchar **standard_output,
+					     gchar **standard_error,
+					     gint *exit_status, GError **error);
+/* only "r"; the command runs to completion before this returns */
+FILE	       *h_popen(const gchar *command, const gchar *mode);
+int		h_pclose(FILE *stream);
+
 /* Sysfs stuff */
 gfloat		h_sysfs_read_float(const gchar *endpoint, const gchar *entry);
 gint		h_sysfs_read_int(const gchar *endpoint, const gchar *entry);
@@ -171,9 +209,14 @@ gchar	       *h_sysfs_read_string(const gchar *endpoint, const gchar *entry);
 #define _CONCAT(a,b) a ## b
 #define CONCAT(a,b) _CONCAT(a,b)
 
+/* writes a detail page from data; called on the first lookup only */
+typedef gchar *(*MoreInfoFunc)(gpointer data);
+
 void moreinfo_init(void);
 void moreinfo_shutdown(void);
 void moreinfo_add_with_prefix(gchar *prefix, gchar *key, gchar *value);
+void moreinfo_add_func_with_prefix(gchar *prefix, gchar *key, MoreInfoFunc func,
+                                   gpointer data, GDestroyNotify data_free);
 void moreinfo_add(gchar *key, gchar *value);
 void moreinfo_del_with_prefix(gchar *prefix);
 void moreinfo_clear(void);
@@ -32,10 +32,23 @@ enum InfoGroupSort {
     INFO_GROUP_SORT_MAX,
 };
 
+enum InfoColumn {
+    INFO_COLUMN_TEXTVALUE,
+    INFO_COLUMN_VALUE,
+    INFO_COLUMN_PROGRESS,
+    INFO_COLUMN_EXTRA1,
+    INFO_COLUMN_EXTRA2,
+    INFO_COLUMN_MAX,
+};
+
+/* "TextValue", "Value", ...: the names used by info_set_column_title() and
+ * in flattened ColumnTitle$ keys */
+extern const gchar *info_column_titles[INFO_COLUMN_MAX];
+
 struct Info {
     GArray *groups;
 
-    const gchar *column_titles[5];
+    const gchar *column_titles[INFO_COLUMN_MAX];
 
     ShellViewType view_type;
 
@@ -54,15 +67,18 @@ struct InfoGroup {
 
      /* scaffolding fields */
     const gchar *computed;
+
+    gboolean free_name_on_flatten;
 };
 
 struct InfoField {
     const gchar *name;
     const gchar *value;
     const gchar *icon;
-          gchar *tag; /* moreinfo() lookup tag */
+    const gchar *unit;  /* shown after the value, separated by a space */
+          gchar *tag; /* moreinfo() lookup tag; "" for none */
 
-    int update_interval;
+    int update_interval; /* ms between hi_get_field() calls, for "..." values */
     gboolean highlight;      /* select in GUI, highlight in report (flag:*) */
     gboolean report_details; /* show moreinfo() in report (flag:!) */
 
@@ -75,6 +91,16 @@ struct Info *info_new(void);
 struct InfoGroup *info_add_group(struct Info *info, const gchar *group_name, ...);
 void info_add_computed_group(struct Info *info, const gchar *name, const gchar *value);
 
+/* Fields a module keeps between scans: info_fields_add() stores copies
+ * of the field's name, value and tag, and info_add_fields_group() shows
+ * copies of them all, so the list stays with the module. fields may be
+ * NULL for an empty group. */
+GArray *info_fields_new(void);
+void info_fields_add(GArray *fields, struct InfoField field);
+void info_fields_free(GArray *fields);
+struct InfoGroup *info_add_fields_group(struct Info *info, const gchar *group_name,
+                                        const GArray *fields);
+
 void info_group_add_fields(struct InfoGroup *group, ...);
 void info_group_add_fieldsv(struct InfoGroup *group, va_list ap);
 
@@ -101,4 +127,19 @@ void info_set_normalize_percentage(struct Info *info, gboolean setting);
 void info_set_view_type(struct Info *info, ShellViewType setting);
 void info_set_reload_interval(struct Info *info, int setting);
 
+/* Readies an Info for the shell and reports, which walk the struct instead
+ * of parsing info_flatten() output: computed groups become real groups,
+ * groups are sorted and every field gets its tag. */
+void info_prepare(struct Info *info);
+
+/* "$[*][!]TAG$", as used in flattened keys, or NULL if the field has
+ * neither a tag nor flags */
+gchar *info_field_get_flags(const struct InfoField *field);
+/* the value followed by its unit */
+gchar *info_field_get_value(const struct InfoField *field);
+
+void info_free(struct Info *info);
+
+/* Compatibility path for code that still wants INI text (remote
+ * clients, modules not returning a struct Info); frees info. */
 gchar *info_flatten(struct Info *info);
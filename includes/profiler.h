@@ -0,0 +1,47 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2007 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <glib.h>
+
+typedef enum {
+    PROFILE_SCAN,      /* ModuleEntry scan callbacks */
+    PROFILE_METHOD,    /* module_call_method() */
+    PROFILE_SPAWN,     /* child processes */
+    PROFILE_FIELD,     /* field update callbacks */
+    PROFILE_N_KINDS
+} ProfileKind;
+
+typedef struct _ProfileFrame ProfileFrame;
+
+/* trace_file may be NULL; without table or trace_file nothing is
+ * recorded, and profiler_begin() returns NULL */
+void          profiler_init(gboolean table, const gchar *trace_file);
+
+/* starts timing a call; the name is only formatted when profiling */
+ProfileFrame *profiler_begin(ProfileKind kind, const gchar *format, ...)
+              G_GNUC_PRINTF(2, 3);
+void          profiler_end(ProfileFrame *frame);
+
+/* prints the table to stderr and writes the trace file; profiler_init()
+ * registers it to run at exit */
+void          profiler_report(void);
+
+#endif	/* __PROFILER_H__ */
@@ -20,14 +20,20 @@
 #define __REPORT_H__
 #include <gtk/gtk.h>
 #include <shell.h>
+#include <info.h>
 
 typedef enum {
     REPORT_FORMAT_HTML,
     REPORT_FORMAT_TEXT,
     REPORT_FORMAT_SHELL,
+    REPORT_FORMAT_JSON,
     N_REPORT_FORMAT
 } ReportFormat;
 
+/* of the JSON report, see report.c */
+#define REPORT_JSON_SCHEMA_VERSION 1
+#define REPORT_JSON_LEVELS 6
+
 typedef enum {
     REPORT_COL_PROGRESS = 1<<0,
     REPORT_COL_VALUE    = 1<<1,
@@ -41,7 +47,10 @@ typedef struct _ReportContext	ReportContext;
 
 struct _ReportContext {
   ShellModuleEntry	*entry;
-  gchar			*output;
+  GString		*output;	/* everything, or what isn't written yet */
+  gint			fd;		/* -1, or where output is written */
+  GOutputStream		*stream;	/* or here */
+  gboolean		failed;		/* a write failed */
 
   void (*header)      	(ReportContext *ctx);
   void (*footer)      	(ReportContext *ctx);
@@ -65,6 +74,11 @@ struct _ReportContext {
   GHashTable		*column_titles;
   GHashTable *icon_refs;
   GHashTable *icon_data;
+
+  /* JSON: objects still open, and how many items each level has */
+  gint			json_depth;
+  const gchar		*json_close[REPORT_JSON_LEVELS];
+  guint			json_items[REPORT_JSON_LEVELS];
 };
 
 struct _ReportDialog {
@@ -84,6 +98,7 @@ void		 report_dialog_show();
 ReportContext	*report_context_html_new();
 ReportContext	*report_context_text_new();
 ReportContext	*report_context_shell_new();
+ReportContext	*report_context_json_new();
 
 void		 report_header		(ReportContext *ctx);
 void		 report_footer		(ReportContext *ctx);
@@ -93,9 +108,16 @@ void 		 report_subsubtitle	(ReportContext *ctx, gchar *text);
 void		 report_key_value	(ReportContext *ctx, gchar *key, gchar *value);
 void		 report_table		(ReportContext *ctx, gchar *text);
 void		 report_details		(ReportContext *ctx, gchar *key, gchar *value, gchar *details);
+void		 report_info		(ReportContext *ctx, struct Info *info);
+void		 report_module_entry	(ReportContext *ctx, ShellModuleEntry *entry);
 
 void             report_create_from_module_list(ReportContext *ctx, GSList *modules);
 gchar           *report_create_from_module_list_format(GSList *modules, ReportFormat format);
+gboolean         report_create_from_module_list_fd(GSList *modules, ReportFormat format, gint fd);
+
+void		 report_context_set_fd(ReportContext *ctx, gint fd);
+void		 report_context_set_stream(ReportContext *ctx, GOutputStream *stream);
+gboolean	 report_flush(ReportContext *ctx);
 
 void		 report_context_free(ReportContext *ctx);
 void             report_module_list_free(GSList *modules);
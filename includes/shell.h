@@ -141,7 +141,9 @@ struct _ShellModule {
 
     gpointer		(*aboutfunc) ();
     gchar		*(*summaryfunc) ();
+    void		(*init) ();
     void		(*deinit) ();
+    gint		 initialized;
 
     guchar		 weight;
 
@@ -160,6 +162,7 @@ struct _ShellModuleEntry {
     gboolean		 selected;
     gint		 number;
     guint32		 flags;
+    ShellModule		*module;
 
     gchar		*(*func) ();
     void		(*scan_func) ();
@@ -181,6 +184,7 @@ struct _ShellFieldUpdateSource {
 
 void		shell_init(GSList *modules);
 void		shell_do_reload(void);
+void		shell_do_redisplay(void);
 
 Shell	       *shell_get_main_shell();
 
@@ -33,3 +33,4 @@ void udisks2_init();
 void udisks2_shutdown();
 GSList *get_udisks2_temps();
 GSList *get_udisks2_all_drives_info();
+void udiskd_free(udiskd *u);
@@ -31,6 +31,8 @@ SYNC_MANAGER_ITEMS
 "		<menuitem name=\"SidePane\" action=\"SidePaneAction\"/>" \
 "		<menuitem name=\"Toolbar\" action=\"ToolbarAction\"/>" \
 "		<separator/>"\
+"		<menuitem name=\"SimilarResults\" action=\"SimilarResultsAction\"/>" \
+"		<separator/>"\
 "		<separator name=\"LastSep\"/>" \
 "		<menuitem name=\"Refresh\" action=\"RefreshAction\"/>" \
 "	</menu>" \
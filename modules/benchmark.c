@@ -31,6 +31,8 @@
 #include "benchmark.h"
 
 #include "benchmark/bench_results.c"
+#include "benchmark/bench_db.c"
+#include "benchmark/bench_import.c"
 
 bench_value bench_results[BENCHMARK_N_ENTRIES];
 
@@ -41,27 +43,127 @@ static gchar *benchmark_include_results(bench_value result, const gchar * benchm
 /* ModuleEntry entries, scan_*(), callback_*(), etc. */
 #include "benchmark/benches.c"
 
+#include "benchmark/bench_noise.c"
+
 static gboolean sending_benchmark_results = FALSE;
 
+/* name of the benchmark being run by do_benchmark() */
+static const gchar *running_benchmark = NULL;
+
 char *bench_value_to_str(bench_value r) {
+    if (*r.extra)
+        return g_strdup_printf("%lf; %lf; %d; %s", r.result, r.elapsed_time, r.threads_used, r.extra);
     return g_strdup_printf("%lf; %lf; %d", r.result, r.elapsed_time, r.threads_used);
 }
 
 bench_value bench_value_from_str(const char* str) {
     bench_value ret = EMPTY_BENCH_VALUE;
     double r, e;
-    int t, c;
+    int t, c, n = 0;
     if (str) {
-        c = sscanf(str, "%lf; %lf; %d", &r, &e, &t);
+        c = sscanf(str, "%lf; %lf; %d%n", &r, &e, &t, &n);
         if (c >= 3) {
             ret.result = r;
             ret.elapsed_time = e;
             ret.threads_used = t;
+            if (str[n] == ';') {
+                g_strlcpy(ret.extra, str + n + 1, sizeof(ret.extra));
+                g_strstrip(ret.extra);
+            }
         }
     }
     return ret;
 }
 
+/* Added to every result by the framework rather than by the benchmark;
+ * the benchmark's own details leave BENCH_EXTRA_RESERVED bytes of extra
+ * for them, and for the count of details that didn't fit. */
+#define BENCH_EXTRA_RESERVED 320
+static const gchar *bench_extra_required[] = {
+    "Validation", "Profile", "Work Size", "Sustained", "Burst", "Steady State",
+    "Time to Throttle", "Noise", "Noise Before", "Load Average", "Runs", "Table", NULL
+};
+
+/* counts a detail left out in "Omitted=N details", kept last */
+static void bench_value_omit_extra(bench_value *r) {
+    gchar **items = g_strsplit(r->extra, ";", -1);
+    GString *extra = g_string_new(NULL);
+    int omitted = 1, i;
+
+    for (i = 0; items[i]; i++) {
+        if (g_str_has_prefix(items[i], "Omitted=")) {
+            omitted += atoi(items[i] + strlen("Omitted="));
+            continue;
+        }
+        if (!*items[i])
+            continue;
+        if (extra->len)
+            g_string_append_c(extra, ';');
+        g_string_append(extra, items[i]);
+    }
+    g_string_append_printf(extra, "%sOmitted=%d details", extra->len ? ";" : "", omitted);
+    g_strlcpy(r->extra, extra->str, sizeof(r->extra));
+
+    g_string_free(extra, TRUE);
+    g_strfreev(items);
+}
+
+/* extra must fit on one line of benchmark.conf, so no '|' or newlines */
+void bench_value_add_extra(bench_value *r, const char *key, const char *fmt, ...) {
+    gchar *value, *item;
+    gsize limit = sizeof(r->extra);
+    va_list args;
+
+    va_start(args, fmt);
+    value = g_strdup_vprintf(fmt, args);
+    va_end(args);
+
+    item = g_strdup_printf("%s%s=%s", *r->extra ? ";" : "", key, value);
+    g_strdelimit(item, "|\n", ' ');
+
+    if (!g_strv_contains(bench_extra_required, key))
+        limit -= BENCH_EXTRA_RESERVED;
+    if (strlen(r->extra) + strlen(item) < limit) {
+        g_strlcat(r->extra, item, sizeof(r->extra));
+    } else {
+        DEBUG("no room in the result for %s=%s", key, value);
+        bench_value_omit_extra(r);
+    }
+
+    g_free(item);
+    g_free(value);
+}
+
+/* csv as <kind>-<benchmark>.csv next to the result store; the file
+ * name, or NULL if it was not saved */
+static gchar *benchmark_save_csv(const gchar *kind, const gchar *csv) {
+    gchar *file, *path;
+
+    if (!running_benchmark)
+        return NULL;
+
+    file = g_strdup_printf("%s-%s.csv", kind, running_benchmark);
+    g_strcanon(file, G_CSET_a_2_z G_CSET_A_2_Z G_CSET_DIGITS "-.", '_');
+    path = bench_db_path(file);
+
+    if (!g_file_set_contents(path, csv, -1, NULL)) {
+        DEBUG("could not save %s", path);
+        g_free(file);
+        file = NULL;
+    }
+
+    g_free(path);
+    return file;
+}
+
+void bench_value_add_table(bench_value *r, const char *kind, const char *csv) {
+    gchar *file = benchmark_save_csv(kind, csv);
+
+    if (file)
+        bench_value_add_extra(r, "Table", "%s", file);
+    g_free(file);
+}
+
 typedef struct _ParallelBenchTask ParallelBenchTask;
 
 struct _ParallelBenchTask {
@@ -69,21 +171,25 @@ struct _ParallelBenchTask {
     guint	start, end;
     gpointer	data, callback;
     int *stop;
+    gint *progress;     /* completions so far, for sampling; may be NULL */
 };
 
 static gpointer benchmark_crunch_for_dispatcher(gpointer data)
 {
     ParallelBenchTask 	*pbt = (ParallelBenchTask *)data;
     gpointer (*callback)(void *data, gint thread_number);
-    gpointer return_value = g_malloc(sizeof(int));
+    gpointer return_value = g_new(double, 1);
     int count = 0;
 
     if ((callback = pbt->callback)) {
         while(!*pbt->stop) {
             callback(pbt->data, pbt->thread_number);
             /* don't count if didn't finish in time */
-            if (!*pbt->stop)
+            if (!*pbt->stop) {
                 count++;
+                if (pbt->progress)
+                    g_atomic_int_inc(pbt->progress);
+            }
         }
     } else {
         DEBUG("this is thread %p; callback is NULL and it should't be!", g_thread_self());
@@ -95,11 +201,16 @@ static gpointer benchmark_crunch_for_dispatcher(gpointer data)
     return return_value;
 }
 
-bench_value benchmark_crunch_for(float seconds, gint n_threads,
-                               gpointer callback, gpointer callback_data) {
+/* with series, the completion rate of every second is appended to it
+ * (and printed for the GUI's load graph with --bench-progress, times
+ * scale) */
+static bench_value crunch_for(float seconds, gint n_threads,
+                              gpointer callback, gpointer callback_data,
+                              GArray *series, double scale) {
     int cpu_procs, cpu_cores, cpu_threads, thread_number, stop = 0;
     GSList *threads = NULL, *t;
     GTimer *timer;
+    gint *progress = NULL;
     bench_value ret = EMPTY_BENCH_VALUE;
 
     timer = g_timer_new();
@@ -112,6 +223,9 @@ bench_value benchmark_crunch_for(float seconds, gint n_threads,
     else
         ret.threads_used = cpu_threads;
 
+    if (series)
+        progress = g_new0(gint, ret.threads_used);
+
     g_timer_start(timer);
     for (thread_number = 0; thread_number < ret.threads_used; thread_number++) {
         ParallelBenchTask *pbt = g_new0(ParallelBenchTask, 1);
@@ -123,6 +237,7 @@ bench_value benchmark_crunch_for(float seconds, gint n_threads,
         pbt->data     = callback_data;
         pbt->callback = callback;
         pbt->stop = &stop;
+        pbt->progress = progress ? &progress[thread_number] : NULL;
 
         thread = g_thread_new("dispatcher",
             (GThreadFunc)benchmark_crunch_for_dispatcher, pbt);
@@ -132,8 +247,32 @@ bench_value benchmark_crunch_for(float seconds, gint n_threads,
     }
 
     /* wait for time */
-    //while ( g_timer_elapsed(timer, NULL) < seconds ) { }
-    g_usleep(seconds * 1000000);
+    if (series) {
+        double now, last_time = 0;
+        gint last_count = 0;
+
+        while ((now = g_timer_elapsed(timer, NULL)) < seconds) {
+            double rate;
+            gint count = 0;
+
+            g_usleep(MIN(1.0, seconds - now) * 1000000);
+
+            for (thread_number = 0; thread_number < ret.threads_used; thread_number++)
+                count += g_atomic_int_get(&progress[thread_number]);
+            now = g_timer_elapsed(timer, NULL);
+            rate = (count - last_count) / (now - last_time);
+            g_array_append_val(series, rate);
+            last_count = count;
+            last_time = now;
+
+            if (params.bench_progress) {
+                printf("@load %f\n", rate * scale);
+                fflush(stdout);
+            }
+        }
+    } else {
+        g_usleep(seconds * 1000000);
+    }
 
     /* signal all threads to stop */
     stop = 1;
@@ -152,6 +291,97 @@ bench_value benchmark_crunch_for(float seconds, gint n_threads,
 
     g_slist_free(threads);
     g_timer_destroy(timer);
+    g_free(progress);
+
+    return ret;
+}
+
+bench_value benchmark_crunch_for(float seconds, gint n_threads,
+                               gpointer callback, gpointer callback_data) {
+    return crunch_for(seconds, n_threads, callback, callback_data, NULL, 0);
+}
+
+/* mean of series[first, last) */
+static double series_mean(GArray *series, guint first, guint last) {
+    double sum = 0;
+    guint i;
+
+    for (i = first; i < last; i++)
+        sum += g_array_index(series, double, i);
+    return last > first ? sum / (last - first) : 0;
+}
+
+/* the 1 s series as "seconds,rate" lines, next to the result store */
+static void sustained_save_series(GArray *series, double scale) {
+    GString *csv = g_string_new("seconds,score\n");
+    guint i;
+
+    for (i = 0; i < series->len; i++)
+        g_string_append_printf(csv, "%u,%f\n", i + 1, g_array_index(series, double, i) * scale);
+    g_free(benchmark_save_csv("sustained", csv->str));
+
+    g_string_free(csv, TRUE);
+}
+
+/* Burst is the best SUSTAINED_WINDOW-second average in the first
+ * SUSTAINED_BURST seconds, steady state the average of the last quarter
+ * of the run; it throttled when a SUSTAINED_WINDOW-second average after
+ * the burst first falls below SUSTAINED_THROTTLE of the burst. */
+#define SUSTAINED_BURST     30
+#define SUSTAINED_WINDOW    5
+#define SUSTAINED_THROTTLE  0.95
+#define SUSTAINED_CURVE     30      /* points kept with the result */
+
+bench_value benchmark_crunch_for_load(float seconds, gint n_threads, double scale,
+                                      gpointer callback, gpointer callback_data) {
+    bench_value ret;
+    GArray *series;
+    gchar *curve = NULL;
+    double burst = 0, steady, mean;
+    guint i, n, step, burst_at = 0;
+
+    if (params.bench_sustained <= 0)
+        return crunch_for(seconds, n_threads, callback, callback_data, NULL, 0);
+
+    series = g_array_new(FALSE, FALSE, sizeof(double));
+    ret = crunch_for(params.bench_sustained * 60, n_threads, callback, callback_data,
+                     series, scale);
+    n = series->len;
+
+    for (i = 0; i + SUSTAINED_WINDOW <= MIN(n, SUSTAINED_BURST); i++) {
+        if ((mean = series_mean(series, i, i + SUSTAINED_WINDOW)) > burst) {
+            burst = mean;
+            burst_at = i;
+        }
+    }
+    steady = series_mean(series, n - n / 4, n);
+    bench_value_add_extra(&ret, "Sustained", "%d min", params.bench_sustained);
+    bench_value_add_extra(&ret, "Burst", "%.2f", burst * scale);
+    bench_value_add_extra(&ret, "Steady State", "%.2f (%.0f%% of burst)",
+                          steady * scale, burst > 0 ? 100 * steady / burst : 0);
+
+    for (i = burst_at; i + SUSTAINED_WINDOW <= n; i++) {
+        if (series_mean(series, i, i + SUSTAINED_WINDOW) < burst * SUSTAINED_THROTTLE)
+            break;
+    }
+    if (i + SUSTAINED_WINDOW <= n)
+        bench_value_add_extra(&ret, "Time to Throttle", "%u s", i + SUSTAINED_WINDOW);
+    else
+        bench_value_add_extra(&ret, "Time to Throttle", "%s", _("(None)"));
+
+    step = MAX(1, (n + SUSTAINED_CURVE - 1) / SUSTAINED_CURVE);
+    for (i = 0; i < n; i += step)
+        curve = h_strdup_cprintf("%s%.3g", curve, curve ? " " : "",
+                                 series_mean(series, i, MIN(n, i + step)) * scale);
+    bench_value_add_extra(&ret, "Load Curve", "%s", curve ? curve : "");
+    g_free(curve);
+
+    sustained_save_series(series, scale);
+    g_array_free(series, TRUE);
+
+    /* callers compute their rate from result / elapsed_time, which
+     * should be the steady state, not the average of the whole run */
+    ret.result = steady * ret.elapsed_time;
 
     return ret;
 }
@@ -272,6 +502,89 @@ bench_value benchmark_parallel_for(gint n_threads, guint start, guint end,
     return ret;
 }
 
+static const struct {
+    const gchar *name;
+    double time_scale;
+} bench_profiles[] = {
+    [BENCH_PROFILE_QUICK]    = { "quick", 0.25 },
+    [BENCH_PROFILE_STANDARD] = { "standard", 1.0 },
+    [BENCH_PROFILE_EXTENDED] = { "extended", 4.0 },
+};
+
+bench_profile benchmark_profile(void)
+{
+    bench_profile p;
+
+    if (params.bench_duration) {
+        for (p = 0; p < BENCH_PROFILE_N; p++) {
+            if (g_str_equal(params.bench_duration, bench_profiles[p].name))
+                return p;
+        }
+    }
+    return BENCH_PROFILE_STANDARD;
+}
+
+const gchar *benchmark_profile_name(bench_profile profile)
+{
+    return bench_profiles[profile].name;
+}
+
+double benchmark_time(double standard_seconds)
+{
+    return standard_seconds * bench_profiles[benchmark_profile()].time_scale;
+}
+
+/* Calibration runs double the size until one takes a tenth of the
+ * target, then the real run is sized from that rate; the calibration
+ * runs also serve as warm-up. */
+bench_value benchmark_parallel_for_time(gint n_threads, double seconds, guint *size,
+                               gpointer callback, gpointer callback_data) {
+    int cpu_procs, cpu_cores, cpu_threads;
+    bench_value ret;
+    double n;
+
+    cpu_procs_cores_threads(&cpu_procs, &cpu_cores, &cpu_threads);
+    if (n_threads > 0)
+        *size = n_threads;
+    else if (n_threads < 0)
+        *size = cpu_cores;
+    else
+        *size = cpu_threads;
+
+    for (;;) {
+        ret = benchmark_parallel_for(n_threads, 0, *size, callback, callback_data);
+        if (ret.elapsed_time >= seconds / 10 || *size >= G_MAXUINT / 2)
+            break;
+        *size *= 2;
+    }
+
+    if (ret.elapsed_time < seconds) {
+        n = *size * seconds / MAX(ret.elapsed_time, 1e-6);
+        *size = (guint)MIN(n, (double)G_MAXUINT);
+        DEBUG("calibrated to %u items for %.1f seconds", *size, seconds);
+        ret = benchmark_parallel_for(n_threads, 0, *size, callback, callback_data);
+    }
+    bench_value_add_extra(&ret, "Work Size", "%u", *size);
+
+    return ret;
+}
+
+/* benchmark_parallel_for() gives each thread n / threads items and the
+ * last one the remainder too, which sets the run's time */
+static guint parallel_for_busiest_thread(guint n, gint threads)
+{
+    guint t = MIN((guint)MAX(threads, 1), MAX(n, 1));
+
+    return n / t + n % t;
+}
+
+double benchmark_fixed_work_time(bench_value r, guint size, guint old_items)
+{
+    double item_time = r.elapsed_time / parallel_for_busiest_thread(size, r.threads_used);
+
+    return item_time * parallel_for_busiest_thread(old_items, r.threads_used);
+}
+
 static gchar *clean_cpuname(gchar *cpuname)
 {
     gchar *ret = NULL, *tmp;
@@ -314,8 +627,8 @@ gchar *hi_get_field(gchar * field)
     return g_strdup(field);
 }
 
-static void br_mi_add(char **results_list, bench_result *b, gboolean select) {
-    gchar *ckey, *rkey;
+static void br_mi_add(char **results_list, bench_result *b, gboolean select, const gchar *extra_info) {
+    gchar *ckey, *rkey, *mi;
 
     ckey = hardinfo_clean_label(b->machine->cpu_name, 0);
     rkey = strdup(b->machine->mid);
@@ -324,115 +637,95 @@ static void br_mi_add(char **results_list, bench_result *b, gboolean select) {
         select ? "*" : "", rkey, ckey,
         b->bvalue.result, b->machine->cpu_config);
 
-    moreinfo_add_with_prefix("BENCH", rkey, bench_result_more_info(b) );
+    mi = bench_result_more_info(b);
+    if (extra_info && *extra_info)
+        mi = h_strconcat(mi, extra_info, NULL);
+    moreinfo_add_with_prefix("BENCH", rkey, mi);
 
     g_free(ckey);
     g_free(rkey);
 }
 
-gint bench_result_sort (gconstpointer a, gconstpointer b) {
-    bench_result
-        *A = (bench_result*)a,
-        *B = (bench_result*)b;
-    if ( A->bvalue.result < B->bvalue.result )
-        return -1;
-    if ( A->bvalue.result > B->bvalue.result )
-        return 1;
-    return 0;
-}
-
 static gchar *__benchmark_include_results(bench_value r,
 					  const gchar * benchmark,
 					  ShellOrderType order_type)
 {
     bench_result *b = NULL;
-    GKeyFile *conf;
-    gchar **machines;
-    gchar *path, *results = g_strdup("");
-    int i, len, loc, win_min, win_max, win_size = params.max_bench_results;
+    bench_db *db;
+    bench_history hist;
+    bench_placement placement;
+    gboolean similar = FALSE;
+    gchar *results = g_strdup(""), *hist_info = NULL, *group, *ret;
 
     GSList *result_list = NULL, *li = NULL;
 
     moreinfo_del_with_prefix("BENCH");
 
     /* this result */
-    if (r.result > 0.0) {
+    if (r.result > 0.0)
         b = bench_result_this_machine(benchmark, r);
-        result_list = g_slist_append(result_list, b);
-    }
-
-    /* load saved results */
-    conf = g_key_file_new();
-    path = g_build_filename(g_get_user_config_dir(), "hardinfo", "benchmark.conf", NULL);
-    if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
-        DEBUG("local benchmark.conf not found, trying system-wide");
-        g_free(path);
-        path = g_build_filename(params.path_data, "benchmark.conf", NULL);
-    }
 
-    g_key_file_load_from_file(conf, path, 0, NULL);
-    g_key_file_set_list_separator(conf, '|');
-
-    machines = g_key_file_get_keys(conf, benchmark, NULL, NULL);
-    for (i = 0; machines && machines[i]; i++) {
-        gchar **values;
-        bench_result *sbr;
+    /* saved results near this result, from the local result store */
+    db = bench_db_open();
+    if (db) {
+        similar = params.bench_similar && b;
+        if (similar)
+            result_list = bench_db_similar(db, benchmark, b, BENCH_SIMILAR_COUNT,
+                                           order_type == SHELL_ORDER_DESCENDING, &placement);
+        else
+            result_list = bench_db_window(db, benchmark, b, params.max_bench_results);
+
+        if (b && bench_db_history(db, benchmark, b->machine->mid, r,
+                                  order_type == SHELL_ORDER_DESCENDING, &hist)) {
+            hist_info = bench_history_more_info(&hist);
+            /* shown in the details of this result; this runs on every
+             * render of the page, so nothing is printed */
+            if (hist.regression > 0)
+                DEBUG("%s: result %.2f is outside this machine's expected range (%.2f - %.2f)",
+                      benchmark, r.result, hist.low, hist.high);
+        }
 
-        values = g_key_file_get_string_list(conf, benchmark, machines[i], NULL, NULL);
-        sbr = bench_result_benchmarkconf(benchmark, machines[i], values);
-        result_list = g_slist_append(result_list, sbr);
+        if (similar) {
+            gchar *pl_info = bench_placement_more_info(&placement);
+            if (hist_info) {
+                pl_info = h_strconcat(pl_info, hist_info, NULL);
+                g_free(hist_info);
+            }
+            hist_info = pl_info;
+        }
 
-        g_strfreev(values);
+        bench_db_close(db);
+    } else if (b) {
+        result_list = g_slist_append(result_list, b);
     }
 
-    g_strfreev(machines);
-    g_free(path);
-    g_key_file_free(conf);
-
-    /* sort */
-    result_list = g_slist_sort(result_list, bench_result_sort);
     if (order_type == SHELL_ORDER_DESCENDING)
         result_list = g_slist_reverse(result_list);
 
-    /* limit results to those near the current result */
-    len = g_slist_length(result_list);
-    if (win_size == 0) win_size = 1;
-    if (win_size < 0) win_size = len;
-    loc = g_slist_index(result_list, b); /* -1 if not found */
-    if (loc >= 0) {
-        win_min = loc - win_size/2;
-        win_max = win_min + win_size;
-        if (win_min < 0) {
-            win_min = 0;
-            win_max = MIN(win_size, len);
-        } else if (win_max > len) {
-            win_max = len;
-            win_min = MAX(len - win_size, 0);
-        }
-    } else {
-        win_min = 0;
-        win_max = len;
-    }
-
-    DEBUG("...len: %d, loc: %d, win_size: %d, win: [%d..%d]\n",
-        len, loc, win_size, win_min, win_max-1 );
-
     /* prepare for shell */
-    i = 0;
-    li = result_list;
-    while (li) {
+    for (li = result_list; li; li = g_slist_next(li)) {
         bench_result *tr = (bench_result*)li->data;
-        if (i >= win_min && i < win_max)
-            br_mi_add(&results, tr, (tr == b) ? 1 : 0 );
-        bench_result_free(tr); /* no longer needed */
-        i++;
-        li = g_slist_next(li);
+        if (tr == b) {
+            br_mi_add(&results, tr, 1, hist_info);
+        } else if (similar) {
+            gchar *dist = g_strdup_printf("[%s]\n%s=%.2f\n", _("Similarity"),
+                _("Distance"), bench_db_result_distance(b, tr));
+            br_mi_add(&results, tr, 0, dist);
+            g_free(dist);
+        } else {
+            br_mi_add(&results, tr, 0, NULL);
+        }
     }
 
-    g_slist_free(result_list);
+    /* b is used for the distances above, so free everything afterwards */
+    g_slist_free_full(result_list, (GDestroyNotify)bench_result_free);
+    g_free(hist_info);
+
+    group = similar ? g_strdup_printf(_("%s (Most Similar Machines)"), benchmark)
+                    : g_strdup(benchmark);
 
     /* send to shell */
-    return g_strdup_printf("[$ShellParam$]\n"
+    ret = g_strdup_printf("[$ShellParam$]\n"
                    "Zebra=1\n"
                    "OrderType=%d\n"
                    "ViewType=4\n"
@@ -443,8 +736,11 @@ static gchar *__benchmark_include_results(bench_value r,
                    "[%s]\n%s",
                    order_type,
                    _("CPU Config"), _("Results"), _("CPU"),
-                   benchmark, results);
+                   group, results);
 
+    g_free(group);
+    g_free(results);
+    return ret;
 }
 
 static gchar *benchmark_include_results_reverse(bench_value result, const gchar * benchmark)
@@ -460,6 +756,7 @@ static gchar *benchmark_include_results(bench_value result, const gchar * benchm
 typedef struct _BenchmarkDialog BenchmarkDialog;
 struct _BenchmarkDialog {
     GtkWidget *dialog;
+    LoadGraph *load_graph;  /* the shell's, for sustained runs */
     bench_value r;
 };
 
@@ -481,6 +778,14 @@ static gboolean do_benchmark_handler(GIOChannel *source,
         return FALSE;
     }
 
+    /* a sample for the load graph; the result is still to come */
+    if (g_str_has_prefix(result, "@load ")) {
+        if (bench_dialog->load_graph)
+            load_graph_update(bench_dialog->load_graph, atof(result + 6));
+        g_free(result);
+        return TRUE;
+    }
+
     r = bench_value_from_str(result);
     bench_dialog->r = r;
 
@@ -497,8 +802,11 @@ static void do_benchmark(void (*benchmark_function)(void), int entry)
     if (params.skip_benchmarks) return;
 
     if (params.gui_running && !sending_benchmark_results) {
+       gchar *sustained = g_strdup_printf("%d", params.bench_sustained);
        gchar *argv[] = { params.argv0, "-b", entries[entry].name,
-                         "-m", "benchmark.so", "-a", NULL };
+                         "-m", "benchmark.so", "-a",
+                         "--bench-duration", (gchar *)benchmark_profile_name(benchmark_profile()),
+                         "-u", sustained, "--bench-progress", NULL };
        GPid bench_pid;
        gint bench_stdout;
        GtkWidget *bench_dialog;
@@ -541,6 +849,18 @@ G_GNUC_END_IGNORE_DEPRECATIONS
        benchmark_dialog->dialog = bench_dialog;
        benchmark_dialog->r = r;
 
+       /* plot the score every second under the dialog while it runs;
+        * reloading the result view hides the graph again */
+       if (params.bench_sustained > 0) {
+          Shell *shell = shell_get_main_shell();
+
+          benchmark_dialog->load_graph = shell->loadgraph;
+          load_graph_set_data_suffix(shell->loadgraph, "");
+          load_graph_clear(shell->loadgraph);
+          gtk_notebook_set_current_page(GTK_NOTEBOOK(shell->notebook), 0);
+          gtk_widget_show(shell->notebook);
+       }
+
        if (!g_path_is_absolute(params.argv0)) {
           spawn_flags |= G_SPAWN_SEARCH_PATH;
        }
@@ -576,6 +896,7 @@ G_GNUC_END_IGNORE_DEPRECATIONS
           bench_results[entry] = benchmark_dialog->r;
 
           g_io_channel_unref(channel);
+          g_free(sustained);
           shell_view_set_enabled(TRUE);
           shell_status_set_enabled(TRUE);
           g_free(benchmark_dialog);
@@ -587,13 +908,26 @@ G_GNUC_END_IGNORE_DEPRECATIONS
 
        gtk_widget_destroy(bench_dialog);
        g_free(benchmark_dialog);
+       g_free(sustained);
        shell_status_set_enabled(TRUE);
        shell_status_update(_("Done."));
     }
 
+    running_benchmark = entries[entry].name;
     setpriority(PRIO_PROCESS, 0, -20);
-    benchmark_function();
+    if (!bench_noise_run(benchmark_function, entry)) {
+        setpriority(PRIO_PROCESS, 0, old_priority);
+        running_benchmark = NULL;
+        return;
+    }
     setpriority(PRIO_PROCESS, 0, old_priority);
+    running_benchmark = NULL;
+
+    if (bench_results[entry].result >= 0.0)
+        bench_value_add_extra(&bench_results[entry], "Profile", "%s",
+                              benchmark_profile_name(benchmark_profile()));
+
+    bench_db_append(entries[entry].name, bench_results[entry]);
 }
 
 gchar *hi_module_get_name(void)
@@ -689,7 +1023,14 @@ static gchar *run_benchmark(gchar *name)
           if (params.run_benchmark) {
             if (CHK_RESULT_FORMAT("conf") ) {
                bench_result *b = bench_result_this_machine(name, bench_results[i]);
-               char *temp = bench_result_benchmarkconf_line(b);
+               char *line = bench_result_benchmarkconf_line(b);
+               char *temp = g_strdup_printf("[%s]\n%s", name, line);
+               free(line);
+               bench_result_free(b);
+               return temp;
+            } else if (CHK_RESULT_FORMAT("json") ) {
+               bench_result *b = bench_result_this_machine(name, bench_results[i]);
+               char *temp = bench_result_json(b, g_get_real_time() / G_USEC_PER_SEC);
                bench_result_free(b);
                return temp;
             } else if (CHK_RESULT_FORMAT("shell") ) {
@@ -709,10 +1050,16 @@ static gchar *run_benchmark(gchar *name)
     return NULL;
 }
 
+static gchar *import_results(void)
+{
+    return bench_import(params.import_results);
+}
+
 ShellModuleMethod *hi_exported_methods(void)
 {
     static ShellModuleMethod m[] = {
         {"runBenchmark", run_benchmark},
+        {"importResults", import_results},
         {NULL}
     };
 
@@ -0,0 +1,1093 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* Local benchmark result store.
+ *
+ * benchmark.db is an append-only log of results: every benchmark run on
+ * this machine adds a timestamped record, and the rows of benchmark.conf
+ * are imported as reference records (timestamp 0) whenever that file
+ * changes. Each import starts with a marker record, and only the
+ * reference records after the last marker count, so rows removed from
+ * benchmark.conf go away with the next import. benchmark.idx is rebuilt
+ * from the log when it is stale and holds, per benchmark, the latest
+ * record of every machine sorted by score and the timestamped history
+ * sorted by machine id. Both files are mmapped, so showing a result
+ * window is two binary searches plus parsing only the rows that are
+ * actually shown.
+ *
+ * Next to each score the index keeps a few numbers describing the
+ * machine (cores, threads, clock, memory, CPU family) so the machines
+ * most similar to this one can be found without parsing every row. */
+
+#include <sys/stat.h>
+#include <math.h>
+
+#define BENCH_DB_MAGIC  "HIBDB\001\0\0"
+#define BENCH_IDX_MAGIC "HIBIDX\003\0"
+
+/* rewrite the log when it holds more than this many dead records
+ * for each live one */
+#define BENCH_DB_COMPACT_RATIO 2
+#define BENCH_DB_COMPACT_MIN 1000
+
+/* name of the record that starts an import of benchmark.conf; benchmark
+ * names starting with '$' are never imported */
+#define BENCH_DB_IMPORT_MARK "$import$"
+
+/* minimum number of earlier local results before judging a new one */
+#define BENCH_HISTORY_MIN_SAMPLES 3
+
+/* how many saved machines to show when comparing with similar machines */
+#define BENCH_SIMILAR_COUNT 10
+
+typedef struct {
+    guint32 size;         /* whole record including strings, 8-byte aligned */
+    guint32 bench_hash;
+    guint32 key_hash;
+    guint32 name_len;     /* strings follow: name\0 key\0 values\0 */
+    guint32 key_len;
+    guint32 values_len;
+    gint64  timestamp;    /* 0 for reference results from benchmark.conf */
+    double  result;
+} bench_db_record;
+
+typedef struct {
+    gchar   magic[8];
+    guint64 log_size;
+    gint64  conf_mtime;
+    guint64 conf_size;
+    guint32 conf_hash;
+    guint32 n_benchmarks;
+    guint32 n_scores;
+    guint32 n_history;
+} bench_idx_header;
+
+typedef struct {
+    guint32 bench_hash;
+    guint32 first_score, n_scores;
+    guint32 first_history, n_history;
+    guint32 pad;
+} bench_idx_dir;
+
+typedef struct {
+    double  result;
+    guint64 offset;
+} bench_idx_score;
+
+/* parallel to bench_idx_score; 0 means unknown */
+typedef struct {
+    guint32 key_hash;
+    guint32 family_hash;
+    float   cores, threads;
+    float   clock;        /* average MHz per thread */
+    float   memory_kiB;
+} bench_idx_feature;
+
+typedef struct {
+    guint32 key_hash;
+    guint32 pad;
+    gint64  timestamp;
+    guint64 offset;
+} bench_idx_history;
+
+typedef struct {
+    GMappedFile *log_file, *idx_file;
+    const gchar *log;
+    gsize log_size;
+    const bench_idx_header *hdr;
+    const bench_idx_dir *dir;
+    const bench_idx_score *scores;
+    const bench_idx_feature *features;
+    const bench_idx_history *history;
+} bench_db;
+
+typedef struct {
+    int samples;
+    double mean, stddev;
+    double low, high;
+    gint64 first, last;
+    int regression; /* 1: worse than the band, -1: better, 0: inside */
+} bench_history;
+
+typedef struct {
+    guint n_all, beaten_all;         /* all saved results of the benchmark */
+    guint n_similar, beaten_similar; /* the similar machines shown */
+} bench_placement;
+
+/* FNV-1a; g_str_hash() is not guaranteed to be stable across versions */
+static guint32 bench_db_hash(const gchar *str) {
+    guint32 h = 2166136261u;
+    while (*str) {
+        h ^= (guchar)*str++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static gchar *bench_db_path(const gchar *file) {
+    return g_build_filename(g_get_user_config_dir(), "hardinfo", file, NULL);
+}
+
+/* local benchmark.conf if one exists, otherwise the system-wide one */
+static gchar *bench_db_conf_path(void) {
+    gchar *path = bench_db_path("benchmark.conf");
+    if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
+        DEBUG("local benchmark.conf not found, trying system-wide");
+        g_free(path);
+        path = g_build_filename(params.path_data, "benchmark.conf", NULL);
+    }
+    return path;
+}
+
+static const bench_db_record *bench_db_record_at(const gchar *log, gsize log_size, guint64 offset) {
+    const bench_db_record *rec;
+    if (offset + sizeof(bench_db_record) > log_size)
+        return NULL;
+    rec = (const bench_db_record *)(log + offset);
+    if (rec->size < sizeof(bench_db_record) || offset + rec->size > log_size)
+        return NULL;
+    return rec;
+}
+
+#define bench_db_record_name(rec) ((const gchar *)(rec) + sizeof(bench_db_record))
+#define bench_db_record_key(rec) (bench_db_record_name(rec) + (rec)->name_len + 1)
+#define bench_db_record_values(rec) (bench_db_record_key(rec) + (rec)->key_len + 1)
+
+/* Family of a cpu name: the first two words that are not trademark or
+ * filler words, so "Intel(R) Core(TM) i7-8650U CPU @ 1.90GHz" and
+ * "Intel Core i5-7200U" are both "intel core". */
+static guint32 bench_db_cpu_family_hash(const gchar *cpu_name) {
+    static const gchar *filler[] = { "cpu", "processor", "genuine", "authentic", NULL };
+    gchar *name, *p, **words, *family = NULL;
+    guint32 h = 0;
+    gint i, j, n = 0;
+
+    if (!cpu_name || !*cpu_name)
+        return 0;
+
+    name = g_ascii_strdown(cpu_name, -1);
+    while ((p = strstr(name, "(r)")) || (p = strstr(name, "(tm)")))
+        memset(p, ' ', (p[1] == 'r') ? 3 : 4);
+    if ((p = strchr(name, '@')))
+        *p = 0;
+
+    words = g_strsplit_set(name, " \t", -1);
+    for (i = 0; words[i] && n < 2; i++) {
+        gboolean skip = !*words[i];
+        for (j = 0; !skip && filler[j]; j++)
+            skip = g_str_equal(words[i], filler[j]);
+        if (skip)
+            continue;
+        family = family ? h_strconcat(family, " ", words[i], NULL) : g_strdup(words[i]);
+        n++;
+    }
+
+    if (family) {
+        h = bench_db_hash(family);
+        g_free(family);
+    }
+    g_strfreev(words);
+    g_free(name);
+    return h;
+}
+
+static void bench_db_machine_features(bench_machine *m, bench_idx_feature *f) {
+    memset(f, 0, sizeof(*f));
+    if (!m)
+        return;
+    f->key_hash = m->mid ? bench_db_hash(m->mid) : 0;
+    f->family_hash = bench_db_cpu_family_hash(m->cpu_name);
+    f->cores = m->cores;
+    f->threads = m->threads;
+    if (m->threads > 0)
+        f->clock = cpu_config_val(m->cpu_config) / m->threads;
+    f->memory_kiB = m->memory_kiB;
+}
+
+/* one term of the distance: how many doublings apart two values are */
+static double bench_db_feature_term(float a, float b, double weight) {
+    if (a <= 0 || b <= 0)
+        return weight * 0.5;
+    return weight * fabs(log(a / b)) / G_LN2;
+}
+
+static double bench_db_feature_distance(const bench_idx_feature *a, const bench_idx_feature *b) {
+    double d;
+
+    d = bench_db_feature_term(a->cores, b->cores, 1.0)
+        + bench_db_feature_term(a->threads, b->threads, 0.5)
+        + bench_db_feature_term(a->clock, b->clock, 1.0)
+        + bench_db_feature_term(a->memory_kiB, b->memory_kiB, 0.25);
+
+    if (!a->family_hash || !b->family_hash)
+        d += 0.5;
+    else if (a->family_hash != b->family_hash)
+        d += 1.0;
+
+    return d;
+}
+
+static gboolean bench_db_write_record(FILE *f, const gchar *name, const gchar *key,
+                                      const gchar *values, gint64 timestamp, double result) {
+    static const gchar zeros[8] = { 0 };
+    bench_db_record rec = { 0 };
+    gsize len;
+
+    rec.name_len = strlen(name);
+    rec.key_len = strlen(key);
+    rec.values_len = strlen(values);
+    rec.bench_hash = bench_db_hash(name);
+    rec.key_hash = bench_db_hash(key);
+    rec.timestamp = timestamp;
+    rec.result = result;
+
+    len = sizeof(rec) + rec.name_len + rec.key_len + rec.values_len + 3;
+    rec.size = (len + 7) & ~7;
+
+    if (fwrite(&rec, sizeof(rec), 1, f) != 1
+        || fwrite(name, 1, rec.name_len + 1, f) != rec.name_len + 1
+        || fwrite(key, 1, rec.key_len + 1, f) != rec.key_len + 1
+        || fwrite(values, 1, rec.values_len + 1, f) != rec.values_len + 1
+        || fwrite(zeros, 1, rec.size - len, f) != rec.size - len)
+        return FALSE;
+
+    return TRUE;
+}
+
+static FILE *bench_db_log_open_append(const gchar *path) {
+    FILE *f = fopen(path, "ab");
+    if (f && ftell(f) == 0)
+        fwrite(BENCH_DB_MAGIC, 1, 8, f);
+    return f;
+}
+
+/* record a result of this machine */
+static void bench_db_append(const gchar *benchmark, bench_value r) {
+    bench_result *b;
+    gchar *path, *values;
+    FILE *f;
+
+    if (r.result <= 0.0)
+        return;
+
+    path = bench_db_path("benchmark.db");
+    f = bench_db_log_open_append(path);
+    if (f) {
+        b = bench_result_this_machine(benchmark, r);
+        values = bench_result_benchmarkconf_values(b);
+
+        if (!bench_db_write_record(f, benchmark, b->machine->mid, values,
+                                   g_get_real_time() / G_USEC_PER_SEC, r.result))
+            DEBUG("error writing to %s", path);
+
+        free(values);
+        bench_result_free(b);
+        fclose(f);
+    }
+    g_free(path);
+}
+
+/* append all rows of benchmark.conf as reference records, after a
+ * marker that retires every earlier import when the index is built */
+static void bench_db_import_conf(const gchar *log_path, const gchar *conf_path) {
+    GKeyFile *conf;
+    gchar **groups, **keys, **values, *joined;
+    FILE *f;
+    gint i, j;
+
+    conf = g_key_file_new();
+    if (!g_key_file_load_from_file(conf, conf_path, 0, NULL)) {
+        g_key_file_free(conf);
+        return;
+    }
+    g_key_file_set_list_separator(conf, '|');
+
+    f = bench_db_log_open_append(log_path);
+    if (!f) {
+        g_key_file_free(conf);
+        return;
+    }
+
+    DEBUG("importing %s", conf_path);
+    bench_db_write_record(f, BENCH_DB_IMPORT_MARK, conf_path, "", 0, 0);
+
+    groups = g_key_file_get_groups(conf, NULL);
+    for (i = 0; groups[i]; i++) {
+        if (*groups[i] == '$' || g_str_equal(groups[i], "param"))
+            continue;
+        keys = g_key_file_get_keys(conf, groups[i], NULL, NULL);
+        for (j = 0; keys && keys[j]; j++) {
+            bench_result *sbr;
+
+            values = g_key_file_get_string_list(conf, groups[i], keys[j], NULL, NULL);
+            if (!values)
+                continue;
+
+            /* only to learn the score the row will be sorted by */
+            sbr = bench_result_benchmarkconf(groups[i], keys[j], values);
+            joined = g_strjoinv("|", values);
+            bench_db_write_record(f, groups[i], keys[j], joined, 0, sbr->bvalue.result);
+
+            g_free(joined);
+            bench_result_free(sbr);
+            g_strfreev(values);
+        }
+        g_strfreev(keys);
+    }
+
+    g_strfreev(groups);
+    fclose(f);
+    g_key_file_free(conf);
+}
+
+static gint bench_db_cmp_offset(gconstpointer a, gconstpointer b) {
+    guint64 oa = *(const guint64 *)a, ob = *(const guint64 *)b;
+    return (oa > ob) - (oa < ob);
+}
+
+static gint bench_db_cmp_score(gconstpointer a, gconstpointer b, gpointer data) {
+    const gchar *log = data;
+    const bench_idx_score *sa = a, *sb = b;
+    guint32 ha = ((const bench_db_record *)(log + sa->offset))->bench_hash;
+    guint32 hb = ((const bench_db_record *)(log + sb->offset))->bench_hash;
+    if (ha != hb)
+        return (ha > hb) - (ha < hb);
+    return (sa->result > sb->result) - (sa->result < sb->result);
+}
+
+static gint bench_db_cmp_history(gconstpointer a, gconstpointer b, gpointer data) {
+    const gchar *log = data;
+    const bench_idx_history *ha = a, *hb = b;
+    guint32 ba = ((const bench_db_record *)(log + ha->offset))->bench_hash;
+    guint32 bb = ((const bench_db_record *)(log + hb->offset))->bench_hash;
+    if (ba != bb)
+        return (ba > bb) - (ba < bb);
+    if (ha->key_hash != hb->key_hash)
+        return (ha->key_hash > hb->key_hash) - (ha->key_hash < hb->key_hash);
+    return (ha->timestamp > hb->timestamp) - (ha->timestamp < hb->timestamp);
+}
+
+/* write live records of the log into a new log; returns TRUE if the log
+ * was replaced */
+static gboolean bench_db_compact(const gchar *log_path, const gchar *log, GArray *live) {
+    gchar *tmp_path = g_strdup_printf("%s.tmp", log_path);
+    gboolean ok = TRUE;
+    FILE *f;
+    guint i;
+
+    g_array_sort(live, bench_db_cmp_offset);
+
+    f = fopen(tmp_path, "wb");
+    if (!f) {
+        g_free(tmp_path);
+        return FALSE;
+    }
+    fwrite(BENCH_DB_MAGIC, 1, 8, f);
+    for (i = 0; i < live->len && ok; i++) {
+        const bench_db_record *rec =
+            (const bench_db_record *)(log + g_array_index(live, guint64, i));
+        ok = (fwrite(rec, 1, rec->size, f) == rec->size);
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (ok)
+        ok = (rename(tmp_path, log_path) == 0);
+    if (!ok)
+        unlink(tmp_path);
+
+    DEBUG("compacted %s to %u records: %s", log_path, live->len, ok ? "ok" : "failed");
+
+    g_free(tmp_path);
+    return ok;
+}
+
+static gboolean bench_db_build_index(const gchar *log_path, const gchar *idx_path,
+                                     struct stat *conf_st, guint32 conf_hash,
+                                     gboolean allow_compact) {
+    GMappedFile *mf;
+    GHashTable *latest;
+    GHashTableIter iter;
+    GArray *scores, *features, *history, *dir, *live;
+    GString *out;
+    bench_idx_header hdr;
+    const gchar *log;
+    gsize log_size;
+    guint64 off, import_start = 0;
+    guint n_records = 0, i, j;
+    gpointer k, v;
+    gboolean ok;
+
+    mf = g_mapped_file_new(log_path, FALSE, NULL);
+    if (!mf)
+        return FALSE;
+    log = g_mapped_file_get_contents(mf);
+    log_size = g_mapped_file_get_length(mf);
+    if (log_size < 8 || memcmp(log, BENCH_DB_MAGIC, 8) != 0) {
+        g_mapped_file_unref(mf);
+        return FALSE;
+    }
+
+    /* reference results count only from the last import on */
+    for (off = 8; off < log_size; ) {
+        const bench_db_record *rec = bench_db_record_at(log, log_size, off);
+        if (!rec)
+            break;
+        if (g_str_equal(bench_db_record_name(rec), BENCH_DB_IMPORT_MARK))
+            import_start = off;
+        off += rec->size;
+    }
+
+    /* reference results: only the latest record of each benchmark/key */
+    latest = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    scores = g_array_new(FALSE, FALSE, sizeof(bench_idx_score));
+    history = g_array_new(FALSE, FALSE, sizeof(bench_idx_history));
+    live = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+    for (off = 8; off < log_size; ) {
+        const bench_db_record *rec = bench_db_record_at(log, log_size, off);
+        if (!rec) {
+            DEBUG("truncated record at %lu in %s", (unsigned long)off, log_path);
+            break;
+        }
+        n_records++;
+
+        if (off == import_start) {
+            g_array_append_val(live, off);
+            off += rec->size;
+            continue;
+        }
+        if (rec->timestamp == 0 && off < import_start) {
+            off += rec->size;
+            continue;
+        }
+
+        /* by timestamp, not log order: imported results may be older
+         * than ones already saved */
+        k = g_strdup_printf("%s\037%s", bench_db_record_name(rec), bench_db_record_key(rec));
+        if (g_hash_table_lookup_extended(latest, k, NULL, &v)
+            && ((const bench_db_record *)(log + (gsize)v))->timestamp > rec->timestamp)
+            g_free(k);
+        else
+            g_hash_table_replace(latest, k, (gpointer)(gsize)off);
+
+        if (rec->timestamp > 0) {
+            bench_idx_history h = { rec->key_hash, 0, rec->timestamp, off };
+            g_array_append_val(history, h);
+            g_array_append_val(live, off);
+        }
+
+        off += rec->size;
+    }
+
+    g_hash_table_iter_init(&iter, latest);
+    while (g_hash_table_iter_next(&iter, &k, &v)) {
+        const bench_db_record *rec = (const bench_db_record *)(log + (gsize)v);
+        bench_idx_score s = { rec->result, (gsize)v };
+        g_array_append_val(scores, s);
+        if (rec->timestamp == 0) {
+            guint64 o = (gsize)v;
+            g_array_append_val(live, o);
+        }
+    }
+    g_hash_table_destroy(latest);
+
+    if (allow_compact && n_records > BENCH_DB_COMPACT_MIN
+        && n_records > BENCH_DB_COMPACT_RATIO * live->len
+        && bench_db_compact(log_path, log, live)) {
+        g_array_free(scores, TRUE);
+        g_array_free(history, TRUE);
+        g_array_free(live, TRUE);
+        g_mapped_file_unref(mf);
+
+        return bench_db_build_index(log_path, idx_path, conf_st, conf_hash, FALSE);
+    }
+    /* if compaction failed, the old log is still there: index it as is */
+    g_array_free(live, TRUE);
+
+    g_qsort_with_data(scores->data, scores->len, sizeof(bench_idx_score),
+                      bench_db_cmp_score, (gpointer)log);
+    g_qsort_with_data(history->data, history->len, sizeof(bench_idx_history),
+                      bench_db_cmp_history, (gpointer)log);
+
+    /* machine features, in the same order as the scores */
+    features = g_array_sized_new(FALSE, TRUE, sizeof(bench_idx_feature), scores->len);
+    for (i = 0; i < scores->len; i++) {
+        const bench_db_record *rec = (const bench_db_record *)
+            (log + g_array_index(scores, bench_idx_score, i).offset);
+        gchar **values = g_strsplit(bench_db_record_values(rec), "|", -1);
+        bench_result *sbr = bench_result_benchmarkconf(bench_db_record_name(rec),
+                                                       bench_db_record_key(rec), values);
+        bench_idx_feature f;
+
+        bench_db_machine_features(sbr->machine, &f);
+        g_array_append_val(features, f);
+
+        bench_result_free(sbr);
+        g_strfreev(values);
+    }
+
+    /* directory of benchmarks: both arrays are grouped by bench_hash */
+    dir = g_array_new(FALSE, TRUE, sizeof(bench_idx_dir));
+    for (i = 0; i < scores->len; i++) {
+        const bench_idx_score *s = &g_array_index(scores, bench_idx_score, i);
+        guint32 h = ((const bench_db_record *)(log + s->offset))->bench_hash;
+        if (!dir->len || g_array_index(dir, bench_idx_dir, dir->len - 1).bench_hash != h) {
+            bench_idx_dir d = { h, i, 0, 0, 0, 0 };
+            g_array_append_val(dir, d);
+        }
+        g_array_index(dir, bench_idx_dir, dir->len - 1).n_scores++;
+    }
+    for (i = 0, j = 0; i < history->len; i++) {
+        const bench_idx_history *hi = &g_array_index(history, bench_idx_history, i);
+        guint32 h = ((const bench_db_record *)(log + hi->offset))->bench_hash;
+        bench_idx_dir *d;
+
+        while (j < dir->len && g_array_index(dir, bench_idx_dir, j).bench_hash < h)
+            j++;
+        if (j == dir->len)
+            break;
+        d = &g_array_index(dir, bench_idx_dir, j);
+        if (d->bench_hash == h) {
+            if (!d->n_history)
+                d->first_history = i;
+            d->n_history++;
+        }
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, BENCH_IDX_MAGIC, 8);
+    hdr.log_size = log_size;
+    hdr.conf_mtime = conf_st ? conf_st->st_mtime : 0;
+    hdr.conf_size = conf_st ? conf_st->st_size : 0;
+    hdr.conf_hash = conf_hash;
+    hdr.n_benchmarks = dir->len;
+    hdr.n_scores = scores->len;
+    hdr.n_history = history->len;
+
+    out = g_string_sized_new(sizeof(hdr) + dir->len * sizeof(bench_idx_dir)
+        + scores->len * (sizeof(bench_idx_score) + sizeof(bench_idx_feature))
+        + history->len * sizeof(bench_idx_history));
+    g_string_append_len(out, (const gchar *)&hdr, sizeof(hdr));
+    g_string_append_len(out, dir->data, dir->len * sizeof(bench_idx_dir));
+    g_string_append_len(out, scores->data, scores->len * sizeof(bench_idx_score));
+    g_string_append_len(out, features->data, features->len * sizeof(bench_idx_feature));
+    g_string_append_len(out, history->data, history->len * sizeof(bench_idx_history));
+
+    ok = g_file_set_contents(idx_path, out->str, out->len, NULL);
+
+    DEBUG("indexed %u records of %s: %u benchmarks, %u scores, %u history",
+        n_records, log_path, dir->len, scores->len, history->len);
+
+    g_string_free(out, TRUE);
+    g_array_free(dir, TRUE);
+    g_array_free(scores, TRUE);
+    g_array_free(features, TRUE);
+    g_array_free(history, TRUE);
+    g_mapped_file_unref(mf);
+
+    return ok;
+}
+
+static gboolean bench_db_idx_is_current(const gchar *idx_path, gsize log_size,
+                                        struct stat *conf_st, guint32 conf_hash) {
+    bench_idx_header hdr;
+    gboolean current = FALSE;
+    FILE *f;
+
+    f = fopen(idx_path, "rb");
+    if (!f)
+        return FALSE;
+    if (fread(&hdr, sizeof(hdr), 1, f) == 1) {
+        current = memcmp(hdr.magic, BENCH_IDX_MAGIC, 8) == 0
+            && hdr.log_size == log_size
+            && hdr.conf_hash == conf_hash
+            && hdr.conf_mtime == (conf_st ? conf_st->st_mtime : 0)
+            && hdr.conf_size == (guint64)(conf_st ? conf_st->st_size : 0);
+    }
+    fclose(f);
+    return current;
+}
+
+static void bench_db_close(bench_db *db) {
+    if (db) {
+        if (db->log_file)
+            g_mapped_file_unref(db->log_file);
+        if (db->idx_file)
+            g_mapped_file_unref(db->idx_file);
+        g_free(db);
+    }
+}
+
+static bench_db *bench_db_open(void) {
+    gchar *log_path, *idx_path, *conf_path;
+    struct stat log_st, conf_st, *conf_stp = NULL;
+    guint32 conf_hash;
+    bench_db *db = NULL;
+    gboolean conf_imported = FALSE;
+    const gchar *idx;
+    gsize idx_size;
+
+    log_path = bench_db_path("benchmark.db");
+    idx_path = bench_db_path("benchmark.idx");
+    conf_path = bench_db_conf_path();
+
+    conf_hash = bench_db_hash(conf_path);
+    if (stat(conf_path, &conf_st) == 0)
+        conf_stp = &conf_st;
+
+    if (stat(log_path, &log_st) != 0)
+        log_st.st_size = 0;
+
+    if (!bench_db_idx_is_current(idx_path, log_st.st_size, conf_stp, conf_hash)) {
+        FILE *f = fopen(idx_path, "rb");
+        bench_idx_header hdr;
+        gboolean conf_changed = TRUE;
+
+        /* the log itself may just have grown; only re-import
+         * benchmark.conf if that is what changed */
+        if (f) {
+            if (fread(&hdr, sizeof(hdr), 1, f) == 1
+                && memcmp(hdr.magic, BENCH_IDX_MAGIC, 8) == 0
+                && log_st.st_size > 0)
+                conf_changed = hdr.conf_hash != conf_hash
+                    || hdr.conf_mtime != (conf_stp ? conf_st.st_mtime : 0)
+                    || hdr.conf_size != (guint64)(conf_stp ? conf_st.st_size : 0);
+            fclose(f);
+        }
+
+        if (conf_changed && conf_stp) {
+            bench_db_import_conf(log_path, conf_path);
+            conf_imported = TRUE;
+        }
+
+        if (!bench_db_build_index(log_path, idx_path, conf_stp, conf_hash, conf_imported))
+            goto out;
+    }
+
+    db = g_new0(bench_db, 1);
+    db->log_file = g_mapped_file_new(log_path, FALSE, NULL);
+    db->idx_file = g_mapped_file_new(idx_path, FALSE, NULL);
+    if (!db->log_file || !db->idx_file) {
+        bench_db_close(db);
+        db = NULL;
+        goto out;
+    }
+
+    db->log = g_mapped_file_get_contents(db->log_file);
+    db->log_size = g_mapped_file_get_length(db->log_file);
+    idx = g_mapped_file_get_contents(db->idx_file);
+    idx_size = g_mapped_file_get_length(db->idx_file);
+
+    db->hdr = (const bench_idx_header *)idx;
+    if (idx_size < sizeof(bench_idx_header)
+        || idx_size != sizeof(bench_idx_header)
+            + db->hdr->n_benchmarks * sizeof(bench_idx_dir)
+            + db->hdr->n_scores * (sizeof(bench_idx_score) + sizeof(bench_idx_feature))
+            + db->hdr->n_history * sizeof(bench_idx_history)) {
+        DEBUG("%s is corrupt", idx_path);
+        unlink(idx_path);
+        bench_db_close(db);
+        db = NULL;
+        goto out;
+    }
+    db->dir = (const bench_idx_dir *)(idx + sizeof(bench_idx_header));
+    db->scores = (const bench_idx_score *)(db->dir + db->hdr->n_benchmarks);
+    db->features = (const bench_idx_feature *)(db->scores + db->hdr->n_scores);
+    db->history = (const bench_idx_history *)(db->features + db->hdr->n_scores);
+
+out:
+    g_free(log_path);
+    g_free(idx_path);
+    g_free(conf_path);
+    return db;
+}
+
+static const bench_idx_dir *bench_db_find(bench_db *db, const gchar *benchmark) {
+    guint32 h = bench_db_hash(benchmark);
+    guint lo = 0, hi = db->hdr->n_benchmarks;
+
+    while (lo < hi) {
+        guint mid = (lo + hi) / 2;
+        if (db->dir[mid].bench_hash < h)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < db->hdr->n_benchmarks && db->dir[lo].bench_hash == h)
+        return &db->dir[lo];
+    return NULL;
+}
+
+static bench_result *bench_db_result(bench_db *db, guint64 offset, const gchar *benchmark) {
+    const bench_db_record *rec = bench_db_record_at(db->log, db->log_size, offset);
+    bench_result *b;
+    gchar **values;
+
+    if (!rec || !g_str_equal(bench_db_record_name(rec), benchmark))
+        return NULL;
+
+    values = g_strsplit(bench_db_record_values(rec), "|", -1);
+    b = bench_result_benchmarkconf(benchmark, bench_db_record_key(rec), values);
+    g_strfreev(values);
+
+    return b;
+}
+
+/* Results near this machine's result (or all of them if there is none),
+ * sorted ascending. this_machine (if any) is included in the window and
+ * saved results with the same machine id are left out. */
+static GSList *bench_db_window(bench_db *db, const gchar *benchmark,
+                               bench_result *this_machine, int win_size) {
+    const bench_idx_dir *d;
+    const bench_idx_score *s;
+    GSList *list = NULL;
+    guint32 mid_hash = 0;
+    guint lo, hi, pos, first, last, n;
+
+    d = bench_db_find(db, benchmark);
+    if (!d)
+        return this_machine ? g_slist_append(NULL, this_machine) : NULL;
+
+    s = db->scores + d->first_score;
+    n = d->n_scores;
+
+    if (this_machine)
+        mid_hash = bench_db_hash(this_machine->machine->mid);
+
+    if (!this_machine || win_size < 0) {
+        first = 0;
+        last = n;
+    } else {
+        if (win_size == 0)
+            win_size = 1;
+
+        lo = 0;
+        hi = n;
+        while (lo < hi) {
+            guint mid = (lo + hi) / 2;
+            if (s[mid].result < this_machine->bvalue.result)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        pos = lo;
+
+        /* this machine takes one slot of the window */
+        first = (pos > (guint)win_size / 2) ? pos - win_size / 2 : 0;
+        last = MIN(first + win_size - 1, n);
+        if (last - first < (guint)win_size - 1)
+            first = (last > (guint)win_size - 1) ? last - (win_size - 1) : 0;
+        /* one spare on each side, in case this machine's saved result
+         * falls inside the window and is skipped */
+        if (first > 0)
+            first--;
+        if (last < n)
+            last++;
+    }
+
+    DEBUG("...n: %u, win_size: %d, win: [%u..%u]", n, win_size, first, last);
+
+    for (; first < last; first++) {
+        const bench_db_record *rec =
+            bench_db_record_at(db->log, db->log_size, s[first].offset);
+        bench_result *sbr;
+
+        if (!rec)
+            continue;
+        if (this_machine && rec->key_hash == mid_hash
+            && g_str_equal(bench_db_record_key(rec), this_machine->machine->mid))
+            continue;
+
+        sbr = bench_db_result(db, s[first].offset, benchmark);
+        if (sbr)
+            list = g_slist_prepend(list, sbr);
+    }
+    list = g_slist_reverse(list);
+
+    if (this_machine) {
+        list = g_slist_insert_sorted(list, this_machine, bench_result_sort);
+
+        /* trim the spares so the window is win_size long, centered on
+         * this machine where possible */
+        while (win_size > 0 && g_slist_length(list) > (guint)win_size) {
+            gint loc = g_slist_index(list, this_machine);
+            gint len = g_slist_length(list);
+            GSList *victim;
+
+            if (loc >= len - 1 - loc)
+                victim = list;
+            else
+                victim = g_slist_last(list);
+
+            bench_result_free(victim->data);
+            list = g_slist_delete_link(list, victim);
+        }
+    }
+
+    return list;
+}
+
+static double bench_db_result_distance(bench_result *a, bench_result *b) {
+    bench_idx_feature fa, fb;
+    bench_db_machine_features(a->machine, &fa);
+    bench_db_machine_features(b->machine, &fb);
+    return bench_db_feature_distance(&fa, &fb);
+}
+
+/* number of scores in s[0..n) below (or above, with !below) r */
+static guint bench_db_count_beaten(const bench_idx_score *s, guint n, double r, gboolean below) {
+    guint lo = 0, hi = n;
+
+    while (lo < hi) {
+        guint mid = (lo + hi) / 2;
+        if (below ? (s[mid].result < r) : (s[mid].result <= r))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return below ? lo : n - lo;
+}
+
+/* The count saved machines closest to this_machine by bench_db_feature_distance(),
+ * plus this_machine itself, sorted ascending by result. Saved results with the
+ * same machine id are left out. */
+static GSList *bench_db_similar(bench_db *db, const gchar *benchmark,
+                                bench_result *this_machine, int count,
+                                gboolean higher_is_better, bench_placement *pl) {
+    const bench_idx_dir *d;
+    const bench_idx_score *s;
+    const bench_idx_feature *f;
+    bench_idx_feature me;
+    GSList *list = NULL, *li;
+    double *best_d;
+    guint *best_i;
+    guint i, j, n, found = 0;
+
+    memset(pl, 0, sizeof(*pl));
+
+    d = bench_db_find(db, benchmark);
+    if (!d || count <= 0)
+        return g_slist_append(NULL, this_machine);
+
+    s = db->scores + d->first_score;
+    f = db->features + d->first_score;
+    n = d->n_scores;
+
+    bench_db_machine_features(this_machine->machine, &me);
+
+    pl->n_all = n;
+    pl->beaten_all = bench_db_count_beaten(s, n, this_machine->bvalue.result, higher_is_better);
+
+    /* not against this machine's own saved result */
+    for (i = 0; me.key_hash && i < n; i++) {
+        if (f[i].key_hash != me.key_hash)
+            continue;
+        pl->n_all--;
+        if (higher_is_better ? (s[i].result < this_machine->bvalue.result)
+                             : (s[i].result > this_machine->bvalue.result))
+            pl->beaten_all--;
+    }
+
+    /* keep the count nearest, sorted by distance */
+    best_d = g_new(double, count);
+    best_i = g_new(guint, count);
+    for (i = 0; i < n; i++) {
+        double dist;
+
+        if (f[i].key_hash == me.key_hash)
+            continue;
+
+        dist = bench_db_feature_distance(&me, &f[i]);
+        if (found == (guint)count && dist >= best_d[found - 1])
+            continue;
+
+        j = (found < (guint)count) ? found++ : found - 1;
+        for (; j > 0 && best_d[j - 1] > dist; j--) {
+            best_d[j] = best_d[j - 1];
+            best_i[j] = best_i[j - 1];
+        }
+        best_d[j] = dist;
+        best_i[j] = i;
+    }
+
+    for (i = 0; i < found; i++) {
+        bench_result *sbr = bench_db_result(db, s[best_i[i]].offset, benchmark);
+        if (sbr)
+            list = g_slist_insert_sorted(list, sbr, bench_result_sort);
+    }
+    g_free(best_d);
+    g_free(best_i);
+
+    for (li = list; li; li = g_slist_next(li)) {
+        bench_result *sbr = li->data;
+        pl->n_similar++;
+        if (higher_is_better ? (sbr->bvalue.result < this_machine->bvalue.result)
+                             : (sbr->bvalue.result > this_machine->bvalue.result))
+            pl->beaten_similar++;
+    }
+
+    return g_slist_insert_sorted(list, this_machine, bench_result_sort);
+}
+
+static gchar *bench_placement_more_info(bench_placement *pl) {
+    gchar *ret;
+
+    if (!pl->n_all)
+        return g_strdup("");
+
+    ret = g_strdup_printf("[%s]\n", _("Placement"));
+
+    /* percentage of the other results this one is better than */
+    if (pl->n_similar)
+        ret = h_strdup_cprintf(_("%s=better than %.0f%% (%u of %u)\n"), ret,
+                               _("Similar Machines"),
+                               100.0 * pl->beaten_similar / pl->n_similar,
+                               pl->beaten_similar, pl->n_similar);
+    if (pl->n_all)
+        ret = h_strdup_cprintf(_("%s=better than %.0f%% (%u of %u)\n"), ret,
+                               _("All Saved Results"),
+                               100.0 * pl->beaten_all / pl->n_all,
+                               pl->beaten_all, pl->n_all);
+
+    return ret;
+}
+
+/* this machine's earlier local results, and where r falls relative to them */
+static gboolean bench_db_history(bench_db *db, const gchar *benchmark, const gchar *mid,
+                                 bench_value r, gboolean higher_is_better,
+                                 bench_history *out) {
+    const bench_idx_dir *d;
+    const bench_idx_history *h;
+    guint32 mid_hash = bench_db_hash(mid);
+    guint lo, hi, i;
+    double sum = 0.0, sum2 = 0.0, spread;
+    GArray *values;
+
+    memset(out, 0, sizeof(*out));
+
+    d = bench_db_find(db, benchmark);
+    if (!d || !d->n_history)
+        return FALSE;
+
+    h = db->history + d->first_history;
+    lo = 0;
+    hi = d->n_history;
+    while (lo < hi) {
+        guint m = (lo + hi) / 2;
+        if (h[m].key_hash < mid_hash)
+            lo = m + 1;
+        else
+            hi = m;
+    }
+
+    values = g_array_new(FALSE, FALSE, sizeof(double));
+    for (i = lo; i < d->n_history && h[i].key_hash == mid_hash; i++) {
+        const bench_db_record *rec =
+            bench_db_record_at(db->log, db->log_size, h[i].offset);
+        if (!rec || !g_str_equal(bench_db_record_key(rec), mid)
+            || !g_str_equal(bench_db_record_name(rec), benchmark))
+            continue;
+        g_array_append_val(values, rec->result);
+        if (!out->first)
+            out->first = rec->timestamp;
+        out->last = rec->timestamp;
+    }
+
+    /* the newest record is usually r itself, saved when it was run */
+    if (values->len && fabs(g_array_index(values, double, values->len - 1) - r.result)
+                           <= 1e-9 * fabs(r.result))
+        g_array_set_size(values, values->len - 1);
+
+    out->samples = values->len;
+    if (out->samples < BENCH_HISTORY_MIN_SAMPLES) {
+        g_array_free(values, TRUE);
+        return out->samples > 0;
+    }
+
+    for (i = 0; i < values->len; i++) {
+        double v = g_array_index(values, double, i);
+        sum += v;
+        sum2 += v * v;
+    }
+    g_array_free(values, TRUE);
+
+    out->mean = sum / out->samples;
+    out->stddev = sqrt(MAX(sum2 / out->samples - out->mean * out->mean, 0.0));
+
+    /* two standard deviations, but never narrower than 2% of the mean */
+    spread = MAX(2.0 * out->stddev, 0.02 * fabs(out->mean));
+    out->low = out->mean - spread;
+    out->high = out->mean + spread;
+
+    if (r.result < out->low)
+        out->regression = higher_is_better ? 1 : -1;
+    else if (r.result > out->high)
+        out->regression = higher_is_better ? -1 : 1;
+
+    return TRUE;
+}
+
+static gchar *bench_history_time_str(gint64 t) {
+    GDateTime *dt = g_date_time_new_from_unix_local(t);
+    gchar *ret = g_date_time_format(dt, "%x %X");
+    g_date_time_unref(dt);
+    return ret;
+}
+
+static gchar *bench_history_more_info(bench_history *h) {
+    gchar *first, *last, *ret;
+
+    if (!h->samples)
+        return g_strdup("");
+
+    first = bench_history_time_str(h->first);
+    last = bench_history_time_str(h->last);
+
+    if (h->samples < BENCH_HISTORY_MIN_SAMPLES) {
+        ret = g_strdup_printf("[%s]\n"
+                              "%s=%d\n"
+                              "%s=%s\n"
+                              "%s=%s\n",
+                              _("Local History"),
+                              _("Earlier Results"), h->samples,
+                              _("First Result"), first,
+                              _("Status"), _("Not enough results to compare"));
+    } else {
+        ret = g_strdup_printf("[%s]\n"
+                              "%s=%d\n"
+                              "%s=%s\n"
+                              "%s=%s\n"
+                              "%s=%.2f\n"
+                              "%s=%.2f - %.2f\n"
+                              "%s=%s\n",
+                              _("Local History"),
+                              _("Earlier Results"), h->samples,
+                              _("First Result"), first,
+                              _("Last Result"), last,
+                              _("Average"), h->mean,
+                              _("Expected Range"), h->low, h->high,
+                              _("Status"),
+                              (h->regression > 0) ? _("Regression: worse than the expected range")
+                              : (h->regression < 0) ? _("Better than the expected range")
+                              : _("Within the expected range"));
+    }
+
+    g_free(first);
+    g_free(last);
+    return ret;
+}
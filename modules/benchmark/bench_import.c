@@ -0,0 +1,571 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* Offline import of benchmark results.
+ *
+ * "hardinfo -i PATH..." reads result files, or directories of them, as
+ * written by "hardinfo -b <benchmark> -g conf|shell|json" (or whole
+ * benchmark.conf files) and merges them into the local result store, so
+ * a fleet of machines can build its own reference results without the
+ * sync server. Files are parsed in parallel; a result already in the
+ * store, or seen twice, is only kept once per benchmark, machine id and
+ * timestamp. Files that carry no timestamp use their modification time. */
+
+typedef struct {
+    gchar *name, *key, *values;
+    gint64 timestamp;
+    double result;
+} bench_import_row;
+
+typedef struct {
+    GPtrArray *files;
+    GPtrArray **rows;   /* one array per thread */
+    gint *n_bad;        /* unreadable files, per thread */
+} bench_import_job;
+
+static void bench_import_row_free(gpointer data) {
+    bench_import_row *row = data;
+    g_free(row->name);
+    g_free(row->key);
+    g_free(row->values);
+    g_free(row);
+}
+
+static gint bench_import_row_cmp(gconstpointer a, gconstpointer b) {
+    const bench_import_row *ra = *(bench_import_row * const *)a;
+    const bench_import_row *rb = *(bench_import_row * const *)b;
+    gint c;
+
+    if ((c = strcmp(ra->name, rb->name)))
+        return c;
+    if ((c = strcmp(ra->key, rb->key)))
+        return c;
+    return (ra->timestamp > rb->timestamp) - (ra->timestamp < rb->timestamp);
+}
+
+/* values are stored '|'-separated, one per line */
+static char *bench_import_clean(const gchar *str) {
+    if (!str)
+        return NULL;
+    return g_strdelimit(strdup(str), "|\n\r", ' ');
+}
+
+/* takes ownership of b */
+static void bench_import_add_result(GPtrArray *rows, bench_result *b, gint64 timestamp) {
+    bench_import_row *row;
+    char *values;
+
+    if (!b->name || !*b->name || b->bvalue.result <= 0.0) {
+        bench_result_free(b);
+        return;
+    }
+
+    if (!b->machine->cpu_name)
+        b->machine->cpu_name = strdup("");
+    if (!b->machine->mid || !*b->machine->mid)
+        gen_machine_id(b->machine);
+
+    values = bench_result_benchmarkconf_values(b);
+
+    row = g_new0(bench_import_row, 1);
+    row->name = g_strdup(b->name);
+    row->key = g_strdup(b->machine->mid);
+    row->values = g_strdup(values);
+    row->timestamp = timestamp;
+    row->result = b->bvalue.result;
+    g_ptr_array_add(rows, row);
+
+    free(values);
+    bench_result_free(b);
+}
+
+static bench_result *bench_import_result_new(void) {
+    bench_result *b = malloc(sizeof(bench_result));
+    memset(b, 0, sizeof(bench_result));
+    b->machine = bench_machine_new();
+    b->bvalue.result = -1.0;
+    return b;
+}
+
+/* benchmark.conf rows, or the output of -g conf */
+static gboolean bench_import_conf(GKeyFile *kf, GPtrArray *rows, gint64 timestamp) {
+    gchar **groups, **keys, **values, *joined;
+    gint i, j;
+
+    g_key_file_set_list_separator(kf, '|');
+
+    groups = g_key_file_get_groups(kf, NULL);
+    for (i = 0; groups[i]; i++) {
+        if (*groups[i] == '$' || g_str_equal(groups[i], "param"))
+            continue;
+        keys = g_key_file_get_keys(kf, groups[i], NULL, NULL);
+        for (j = 0; keys && keys[j]; j++) {
+            bench_import_row *row;
+            bench_result *sbr;
+
+            values = g_key_file_get_string_list(kf, groups[i], keys[j], NULL, NULL);
+            if (!values)
+                continue;
+
+            sbr = bench_result_benchmarkconf(groups[i], keys[j], values);
+            if (sbr->bvalue.result > 0.0) {
+                joined = g_strjoinv("|", values);
+                row = g_new0(bench_import_row, 1);
+                row->name = g_strdup(groups[i]);
+                row->key = g_strdup(keys[j]);
+                row->values = joined;
+                row->timestamp = timestamp;
+                row->result = sbr->bvalue.result;
+                g_ptr_array_add(rows, row);
+            }
+
+            bench_result_free(sbr);
+            g_strfreev(values);
+        }
+        g_strfreev(keys);
+    }
+    g_strfreev(groups);
+
+    return TRUE;
+}
+
+static char *bench_import_shell_str(GKeyFile *kf, const gchar *group, const gchar *key) {
+    gchar *str = g_key_file_get_value(kf, group, key, NULL);
+    char *ret = NULL;
+
+    if (str && *str && !g_str_equal(str, _(unk)))
+        ret = bench_import_clean(str);
+    g_free(str);
+    return ret;
+}
+
+/* output of -g shell; keys are translated, so this only reads files
+ * written in the same language */
+static gboolean bench_import_shell(GKeyFile *kf, GPtrArray *rows, gint64 timestamp) {
+    const gchar *grp_result = _("Benchmark Result"), *grp_machine = _("Machine");
+    bench_result *b;
+    gchar *str;
+
+#define SHELL_STR(G, K) bench_import_shell_str(kf, G, K)
+    b = bench_import_result_new();
+    b->name = SHELL_STR(grp_result, _("Benchmark"));
+    str = g_key_file_get_value(kf, grp_result, _("Result"), NULL);
+    /* numbers are in the locale too */
+    if (str)
+        b->bvalue.result = g_strtod(str, NULL);
+    g_free(str);
+    str = g_key_file_get_value(kf, grp_result, _("Elapsed Time"), NULL);
+    if (str)
+        b->bvalue.elapsed_time = g_strtod(str, NULL);
+    g_free(str);
+    b->bvalue.threads_used = g_key_file_get_integer(kf, grp_result, _("Threads"), NULL);
+
+    b->machine->board = SHELL_STR(grp_machine, _("Board"));
+    b->machine->cpu_name = SHELL_STR(grp_machine, _("CPU Name"));
+    b->machine->cpu_desc = SHELL_STR(grp_machine, _("CPU Description"));
+    b->machine->cpu_config = SHELL_STR(grp_machine, _("CPU Config"));
+    b->machine->threads = g_key_file_get_integer(kf, grp_machine, _("Threads Available"), NULL);
+    b->machine->gpu_desc = SHELL_STR(grp_machine, _("GPU"));
+    b->machine->ogl_renderer = SHELL_STR(grp_machine, _("OpenGL Renderer"));
+    str = g_key_file_get_value(kf, grp_machine, _("Memory"), NULL);
+    if (str)
+        b->machine->memory_kiB = atoi(str);
+    g_free(str);
+    b->machine->mid = SHELL_STR(_("Handles"), _("mid"));
+#undef SHELL_STR
+
+    if (b->bvalue.result <= 0.0) {
+        bench_result_free(b);
+        return FALSE;
+    }
+
+    bench_import_add_result(rows, b, timestamp);
+    return TRUE;
+}
+
+/* A minimal reader for what -g json writes: flat objects of strings
+ * and numbers, alone, concatenated, or in an array. */
+static const gchar *bench_json_ws(const gchar *p) {
+    while (*p && g_ascii_isspace(*p))
+        p++;
+    return p;
+}
+
+static gchar *bench_json_string(const gchar **pp) {
+    const gchar *p = *pp;
+    GString *s;
+
+    if (*p != '"')
+        return NULL;
+
+    s = g_string_new(NULL);
+    for (p++; *p && *p != '"'; p++) {
+        if (*p != '\\') {
+            g_string_append_c(s, *p);
+            continue;
+        }
+        switch (*++p) {
+        case 'n': g_string_append_c(s, '\n'); break;
+        case 'r': g_string_append_c(s, '\r'); break;
+        case 't': g_string_append_c(s, '\t'); break;
+        case 'b': g_string_append_c(s, '\b'); break;
+        case 'f': g_string_append_c(s, '\f'); break;
+        case 'u': {
+            gchar hex[5] = { 0 };
+            if (!g_ascii_isxdigit(p[1]) || !g_ascii_isxdigit(p[2])
+                || !g_ascii_isxdigit(p[3]) || !g_ascii_isxdigit(p[4]))
+                goto error;
+            memcpy(hex, p + 1, 4);
+            g_string_append_unichar(s, (gunichar)strtoul(hex, NULL, 16));
+            p += 4;
+            break;
+        }
+        case 0:
+            goto error;
+        default: /* \" \\ \/ */
+            g_string_append_c(s, *p);
+        }
+    }
+    if (*p != '"')
+        goto error;
+
+    *pp = p + 1;
+    return g_string_free(s, FALSE);
+
+error:
+    g_string_free(s, TRUE);
+    return NULL;
+}
+
+/* number, true, false or null, as text */
+static gchar *bench_json_scalar(const gchar **pp) {
+    const gchar *p = *pp;
+    gchar *ret;
+
+    while (*p && (g_ascii_isalnum(*p) || *p == '-' || *p == '+' || *p == '.'))
+        p++;
+    if (p == *pp)
+        return NULL;
+
+    ret = g_strndup(*pp, p - *pp);
+    *pp = p;
+    return ret;
+}
+
+static GHashTable *bench_json_object(const gchar **pp) {
+    const gchar *p = bench_json_ws(*pp);
+    GHashTable *obj;
+
+    if (*p != '{')
+        return NULL;
+
+    obj = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    p = bench_json_ws(p + 1);
+    if (*p == '}') {
+        *pp = p + 1;
+        return obj;
+    }
+
+    for (;;) {
+        gchar *key, *value;
+
+        if (!(key = bench_json_string(&p)))
+            goto error;
+        p = bench_json_ws(p);
+        if (*p != ':') {
+            g_free(key);
+            goto error;
+        }
+        p = bench_json_ws(p + 1);
+        value = (*p == '"') ? bench_json_string(&p) : bench_json_scalar(&p);
+        if (!value) {
+            g_free(key);
+            goto error;
+        }
+        g_hash_table_replace(obj, key, value);
+
+        p = bench_json_ws(p);
+        if (*p == ',') {
+            p = bench_json_ws(p + 1);
+            continue;
+        }
+        if (*p == '}')
+            break;
+        goto error;
+    }
+
+    *pp = p + 1;
+    return obj;
+
+error:
+    g_hash_table_destroy(obj);
+    return NULL;
+}
+
+static void bench_import_json_object(GHashTable *obj, GPtrArray *rows, gint64 timestamp) {
+    bench_result *b = bench_import_result_new();
+    const gchar *str;
+
+#define JSON_STR(K) bench_import_clean(g_hash_table_lookup(obj, K))
+#define JSON_INT(K) ((str = g_hash_table_lookup(obj, K)) ? atoi(str) : 0)
+    b->name = JSON_STR("benchmark");
+    if ((str = g_hash_table_lookup(obj, "result")))
+        b->bvalue.result = g_ascii_strtod(str, NULL);
+    if ((str = g_hash_table_lookup(obj, "elapsed_time")))
+        b->bvalue.elapsed_time = g_ascii_strtod(str, NULL);
+    b->bvalue.threads_used = JSON_INT("threads_used");
+    if ((str = g_hash_table_lookup(obj, "extra")))
+        g_strlcpy(b->bvalue.extra, str, sizeof(b->bvalue.extra));
+    g_strdelimit(b->bvalue.extra, "|\n\r", ' ');
+    b->machine->mid = JSON_STR("mid");
+    b->machine->board = JSON_STR("board");
+    b->machine->cpu_name = JSON_STR("cpu_name");
+    b->machine->cpu_desc = JSON_STR("cpu_desc");
+    b->machine->cpu_config = JSON_STR("cpu_config");
+    b->machine->memory_kiB = JSON_INT("memory_kiB");
+    b->machine->processors = JSON_INT("processors");
+    b->machine->cores = JSON_INT("cores");
+    b->machine->threads = JSON_INT("threads");
+    b->machine->ogl_renderer = JSON_STR("opengl_renderer");
+    b->machine->gpu_desc = JSON_STR("gpu_desc");
+    if ((str = g_hash_table_lookup(obj, "timestamp")) && g_ascii_strtoll(str, NULL, 10) > 0)
+        timestamp = g_ascii_strtoll(str, NULL, 10);
+#undef JSON_STR
+#undef JSON_INT
+
+    bench_import_add_result(rows, b, timestamp);
+}
+
+static gboolean bench_import_json(const gchar *data, GPtrArray *rows, gint64 timestamp) {
+    const gchar *p = bench_json_ws(data);
+    gboolean in_array = FALSE;
+    GHashTable *obj;
+
+    if (*p == '[') {
+        in_array = TRUE;
+        p = bench_json_ws(p + 1);
+        if (*p == ']')
+            return TRUE;
+    }
+
+    while ((obj = bench_json_object(&p))) {
+        bench_import_json_object(obj, rows, timestamp);
+        g_hash_table_destroy(obj);
+
+        p = bench_json_ws(p);
+        if (in_array) {
+            if (*p == ']')
+                return TRUE;
+            if (*p != ',')
+                return FALSE;
+            p = bench_json_ws(p + 1);
+        } else if (!*p) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static gboolean bench_import_file(const gchar *path, GPtrArray *rows) {
+    gchar *data;
+    gsize len;
+    struct stat st;
+    gint64 timestamp;
+    const gchar *p;
+    gboolean ok = FALSE;
+
+    if (!g_file_get_contents(path, &data, &len, NULL))
+        return FALSE;
+
+    timestamp = (stat(path, &st) == 0) ? st.st_mtime : g_get_real_time() / G_USEC_PER_SEC;
+
+    p = bench_json_ws(data);
+    if (*p == '{' || (*p == '[' && (*bench_json_ws(p + 1) == '{' || *bench_json_ws(p + 1) == ']'))) {
+        ok = bench_import_json(p, rows, timestamp);
+    } else {
+        GKeyFile *kf = g_key_file_new();
+
+        if (g_key_file_load_from_data(kf, data, len, 0, NULL)) {
+            if (g_key_file_has_group(kf, _("Benchmark Result")))
+                ok = bench_import_shell(kf, rows, timestamp);
+            else
+                ok = bench_import_conf(kf, rows, timestamp);
+        }
+        g_key_file_free(kf);
+    }
+
+    if (!ok)
+        DEBUG("could not import %s", path);
+
+    g_free(data);
+    return ok;
+}
+
+static void bench_import_collect(const gchar *path, GPtrArray *files) {
+    GDir *dir;
+    const gchar *name;
+
+    if (!g_file_test(path, G_FILE_TEST_IS_DIR)) {
+        g_ptr_array_add(files, g_strdup(path));
+        return;
+    }
+
+    dir = g_dir_open(path, 0, NULL);
+    if (!dir)
+        return;
+    while ((name = g_dir_read_name(dir))) {
+        gchar *child;
+
+        if (*name == '.')
+            continue;
+        child = g_build_filename(path, name, NULL);
+        bench_import_collect(child, files);
+        g_free(child);
+    }
+    g_dir_close(dir);
+}
+
+static gpointer bench_import_thread(unsigned int start, unsigned int end,
+                                    void *data, gint thread_number) {
+    bench_import_job *job = data;
+    unsigned int i;
+
+    for (i = start; i <= end; i++) {
+        if (!bench_import_file(g_ptr_array_index(job->files, i), job->rows[thread_number]))
+            job->n_bad[thread_number]++;
+    }
+
+    return NULL;
+}
+
+/* "name\037key\037timestamp" of every timestamped record in the store */
+static GHashTable *bench_import_existing(const gchar *log_path) {
+    GHashTable *seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    GMappedFile *mf = g_mapped_file_new(log_path, FALSE, NULL);
+    const gchar *log;
+    gsize log_size;
+    guint64 off;
+
+    if (!mf)
+        return seen;
+
+    log = g_mapped_file_get_contents(mf);
+    log_size = g_mapped_file_get_length(mf);
+    if (log_size >= 8 && memcmp(log, BENCH_DB_MAGIC, 8) == 0) {
+        for (off = 8; off < log_size; ) {
+            const bench_db_record *rec = bench_db_record_at(log, log_size, off);
+            if (!rec)
+                break;
+            if (rec->timestamp > 0)
+                g_hash_table_add(seen, g_strdup_printf("%s\037%s\037%" G_GINT64_FORMAT,
+                    bench_db_record_name(rec), bench_db_record_key(rec), rec->timestamp));
+            off += rec->size;
+        }
+    }
+
+    g_mapped_file_unref(mf);
+    return seen;
+}
+
+static gchar *bench_import(gchar **paths) {
+    bench_import_job job;
+    GPtrArray *all;
+    GHashTable *seen;
+    gchar *log_path, *ret;
+    FILE *f = NULL;
+    guint i, n_threads, n_new = 0, n_dup = 0;
+    gint n_bad = 0;
+
+    job.files = g_ptr_array_new_with_free_func(g_free);
+    for (i = 0; paths && paths[i]; i++)
+        bench_import_collect(paths[i], job.files);
+
+    if (!job.files->len) {
+        g_ptr_array_free(job.files, TRUE);
+        return g_strdup(_("No files to import."));
+    }
+
+    n_threads = MAX(1, MIN((guint)g_get_num_processors(), job.files->len));
+    job.rows = g_new0(GPtrArray *, n_threads);
+    job.n_bad = g_new0(gint, n_threads);
+    for (i = 0; i < n_threads; i++)
+        job.rows[i] = g_ptr_array_new_with_free_func(bench_import_row_free);
+
+    benchmark_parallel_for(n_threads, 0, job.files->len, bench_import_thread, &job);
+
+    /* merge, sort and drop duplicates */
+    all = g_ptr_array_new_with_free_func(bench_import_row_free);
+    for (i = 0; i < n_threads; i++) {
+        guint j;
+        for (j = 0; j < job.rows[i]->len; j++)
+            g_ptr_array_add(all, g_ptr_array_index(job.rows[i], j));
+        g_ptr_array_set_free_func(job.rows[i], NULL);
+        g_ptr_array_free(job.rows[i], TRUE);
+        n_bad += job.n_bad[i];
+    }
+    g_ptr_array_sort(all, bench_import_row_cmp);
+
+    log_path = bench_db_path("benchmark.db");
+    seen = bench_import_existing(log_path);
+
+    for (i = 0; i < all->len; i++) {
+        bench_import_row *row = g_ptr_array_index(all, i);
+        gchar *id = g_strdup_printf("%s\037%s\037%" G_GINT64_FORMAT,
+                                    row->name, row->key, row->timestamp);
+
+        if (g_hash_table_contains(seen, id)) {
+            n_dup++;
+            g_free(id);
+            continue;
+        }
+        g_hash_table_add(seen, id);
+
+        if (!f) {
+            gchar *dir = g_path_get_dirname(log_path);
+            g_mkdir_with_parents(dir, 0755);
+            g_free(dir);
+
+            f = bench_db_log_open_append(log_path);
+            if (!f)
+                break;
+        }
+        if (!bench_db_write_record(f, row->name, row->key, row->values,
+                                   row->timestamp, row->result))
+            break;
+        n_new++;
+    }
+
+    if (f) {
+        fclose(f);
+        /* rebuild the index now rather than on the next comparison */
+        bench_db_close(bench_db_open());
+    }
+
+    ret = g_strdup_printf(_("Imported %u results from %u files into %s (%u duplicates, %d unreadable files)."),
+                          n_new, job.files->len, log_path, n_dup, n_bad);
+
+    g_hash_table_destroy(seen);
+    g_ptr_array_free(all, TRUE);
+    g_ptr_array_free(job.files, TRUE);
+    g_free(job.rows);
+    g_free(job.n_bad);
+    g_free(log_path);
+
+    return ret;
+}
@@ -0,0 +1,246 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+/* Background noise: how much of the CPUs a benchmark uses other
+ * processes take around a run. The busy time of all CPUs comes from
+ * /proc/stat and our own from getrusage(), so the difference is everyone
+ * else, in CPUs. That work first fills the CPUs the benchmark's threads
+ * leave idle; what is left shares a CPU with one of its threads, and
+ * that thread holds up the whole run. So noise is the percentage of one
+ * CPU left over that way: 4 busy CPUs are no noise for a single thread
+ * on 64 CPUs, but all of it for 64 threads. When the thread count of a
+ * benchmark is known in advance, the system gets a few seconds to settle
+ * before the run, and the run is skipped if others would take most of
+ * its CPUs; otherwise the noise before is only recorded. A run that was
+ * noisy, or that falls outside this machine's expected range in the
+ * local history, is run again. */
+
+#include <sys/resource.h>
+
+#define BENCH_NOISE_LIMIT    10.0   /* percent of a CPU taken from the benchmark */
+#define BENCH_NOISE_REFUSE   50.0   /* percent of its CPUs; don't run above this */
+#define BENCH_NOISE_WAIT     10     /* seconds to wait for it to settle */
+#define BENCH_NOISE_RERUNS   2
+
+typedef struct {
+    guint64 busy, total;    /* jiffies, all CPUs */
+    double self;            /* seconds of CPU used by this process */
+    gint64 time;            /* monotonic, microseconds */
+} bench_cpu_sample;
+
+static gboolean bench_cpu_sample_read(bench_cpu_sample *s) {
+    guint64 user, nice, system, idle, iowait = 0, irq = 0, softirq = 0, steal = 0;
+    struct rusage ru;
+    gchar buf[256];
+    FILE *stat;
+    int n;
+
+    memset(s, 0, sizeof(*s));
+
+    stat = fopen("/proc/stat", "r");
+    if (!stat)
+        return FALSE;
+    n = fgets(buf, sizeof(buf), stat) ? sscanf(buf,
+        "cpu %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+        " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+        " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
+        &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) : 0;
+    fclose(stat);
+    if (n < 4)
+        return FALSE;
+
+    s->busy = user + nice + system + irq + softirq + steal;
+    s->total = s->busy + idle + iowait;
+    s->time = g_get_monotonic_time();
+
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        s->self = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+                + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+
+    return TRUE;
+}
+
+/* CPUs used by other processes between a and b */
+static double bench_noise_between(const bench_cpu_sample *a, const bench_cpu_sample *b) {
+    double busy, self, wall;
+    long cpus = MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+
+    if (b->total <= a->total || b->time <= a->time)
+        return 0.0;
+
+    busy = (double)(b->busy - a->busy) / (b->total - a->total) * cpus;
+    wall = (b->time - a->time) / 1e6;
+    self = (b->self - a->self) / wall;
+
+    return CLAMP(busy - self, 0.0, cpus);
+}
+
+/* noise for a benchmark of threads threads (0 if unknown: all CPUs),
+ * from the CPUs others use */
+static double bench_noise_percent(double others, gint threads) {
+    long cpus = MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+    double idle = threads > 0 ? MAX(cpus - threads, 0) : 0;
+
+    return CLAMP(others - idle, 0.0, 1.0) * 100.0;
+}
+
+/* percentage of the CPUs of a benchmark of threads threads that others
+ * take, for the refuse decision */
+static double bench_noise_share(double others, gint threads) {
+    long cpus = MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+    double idle = MAX(cpus - threads, 0);
+
+    return CLAMP(others - idle, 0.0, threads) / threads * 100.0;
+}
+
+/* CPUs used by other processes over a quarter of a second */
+static double bench_noise_sample(void) {
+    bench_cpu_sample a, b;
+
+    if (!bench_cpu_sample_read(&a))
+        return 0.0;
+    g_usleep(G_USEC_PER_SEC / 4);
+    if (!bench_cpu_sample_read(&b))
+        return 0.0;
+    return bench_noise_between(&a, &b);
+}
+
+static double bench_load_average(void) {
+    gchar *contents = NULL;
+    double load1 = 0.0;
+
+    if (g_file_get_contents("/proc/loadavg", &contents, NULL, NULL))
+        load1 = g_ascii_strtod(contents, NULL);
+    g_free(contents);
+
+    return load1;
+}
+
+/* threads the benchmark in entry will use: declared for the single
+ * thread ones, as many as last time for the others, 0 if unknown */
+static gint bench_noise_threads(int entry) {
+    switch (entry) {
+    case BENCHMARK_BLOWFISH_SINGLE:
+    case BENCHMARK_INTERP_SINGLE:
+        return 1;
+    default:
+        return bench_results[entry].threads_used;
+    }
+}
+
+/* CPUs used by other processes right before a run of threads threads,
+ * after waiting up to BENCH_NOISE_WAIT seconds for the noise to drop
+ * under BENCH_NOISE_LIMIT; no waiting if threads is unknown */
+static double bench_noise_preflight(gint threads) {
+    double others = bench_noise_sample();
+    gint waited;
+
+    if (threads <= 0)
+        return others;
+
+    for (waited = 0; bench_noise_percent(others, threads) > BENCH_NOISE_LIMIT
+                     && waited < BENCH_NOISE_WAIT * 4; waited++) {
+        DEBUG("other processes take %.1f%% of a CPU; waiting",
+              bench_noise_percent(others, threads));
+        shell_status_update(_("Waiting for other processes to settle..."));
+        others = bench_noise_sample();
+    }
+
+    return others;
+}
+
+/* r is outside the expected range of this machine's earlier results */
+static gboolean bench_noise_is_outlier(const gchar *benchmark, bench_value r) {
+    bench_result *b;
+    bench_history hist;
+    bench_db *db;
+    gboolean outlier = FALSE;
+
+    if (r.result <= 0.0)
+        return FALSE;
+
+    db = bench_db_open();
+    if (!db)
+        return FALSE;
+
+    b = bench_result_this_machine(benchmark, r);
+    if (bench_db_history(db, benchmark, b->machine->mid, r, TRUE, &hist))
+        outlier = hist.samples >= BENCH_HISTORY_MIN_SAMPLES && hist.regression != 0;
+    bench_result_free(b);
+    bench_db_close(db);
+
+    return outlier;
+}
+
+/* runs benchmark_function() until a run is quiet and within the
+ * expected range, at most BENCH_NOISE_RERUNS more times, and keeps the
+ * quietest run in bench_results[entry]; FALSE if the system was too
+ * busy to run at all */
+static gboolean bench_noise_run(void (*benchmark_function)(void), int entry) {
+    const gchar *name = entries[entry].name;
+    bench_cpu_sample before, after;
+    bench_value best = EMPTY_BENCH_VALUE;
+    double others_before, noise, best_noise = G_MAXDOUBLE, load;
+    gint run, runs, reruns, threads;
+
+    threads = bench_noise_threads(entry);
+
+    others_before = bench_noise_preflight(threads);
+    load = bench_load_average();
+
+    if (threads > 0 && bench_noise_share(others_before, threads) > BENCH_NOISE_REFUSE) {
+        fprintf(stderr, _("%s: not run, other processes would take %.0f%% of its CPUs\n"),
+                name, bench_noise_share(others_before, threads));
+        bench_results[entry] = best;
+        return FALSE;
+    }
+
+    /* sustained runs are long enough as they are */
+    reruns = params.bench_sustained > 0 ? 0 : BENCH_NOISE_RERUNS;
+
+    for (run = 0; run <= reruns; run++) {
+        gboolean has_sample = bench_cpu_sample_read(&before);
+
+        benchmark_function();
+        noise = has_sample && bench_cpu_sample_read(&after)
+                    ? bench_noise_percent(bench_noise_between(&before, &after),
+                                          bench_results[entry].threads_used) : 0.0;
+
+        if (noise <= best_noise) {
+            best = bench_results[entry];
+            best_noise = noise;
+        }
+
+        if (noise <= BENCH_NOISE_LIMIT && !bench_noise_is_outlier(name, bench_results[entry]))
+            break;
+        DEBUG("%s: run %d had %.1f%% noise or is an outlier", name, run + 1, noise);
+    }
+
+    if (best.result >= 0.0) {
+        bench_value_add_extra(&best, "Noise", "%.1f%%", best_noise);
+        bench_value_add_extra(&best, "Noise Before", "%.1f%%",
+                              bench_noise_percent(others_before, best.threads_used));
+        bench_value_add_extra(&best, "Load Average", "%.2f", load);
+        runs = MIN(run, reruns) + 1;
+        if (runs > 1)
+            bench_value_add_extra(&best, "Runs", "%d", runs);
+    }
+    bench_results[entry] = best;
+
+    return TRUE;
+}
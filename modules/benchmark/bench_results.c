@@ -173,6 +173,7 @@ void bench_machine_free(bench_machine *s) {
         free(s->cpu_desc);
         free(s->cpu_config);
         free(s->mid);
+        free(s);
     }
 }
 
@@ -180,6 +181,7 @@ void bench_result_free(bench_result *s) {
     if (s) {
         free(s->name);
         bench_machine_free(s->machine);
+        free(s);
     }
 }
 
@@ -197,6 +199,17 @@ bench_result *bench_result_this_machine(const char *bench_name, bench_value r) {
     return b;
 }
 
+gint bench_result_sort (gconstpointer a, gconstpointer b) {
+    bench_result
+        *A = (bench_result*)a,
+        *B = (bench_result*)b;
+    if ( A->bvalue.result < B->bvalue.result )
+        return -1;
+    if ( A->bvalue.result > B->bvalue.result )
+        return 1;
+    return 0;
+}
+
 /* -1 for none */
 static int nx_prefix(const char *str) {
     char *s, *x;
@@ -350,11 +363,12 @@ bench_result *bench_result_benchmarkconf(const char *section, const char *key, c
     return b;
 }
 
-char *bench_result_benchmarkconf_line(bench_result *b) {
+/* the value part of a benchmark.conf line, without the machine id key */
+char *bench_result_benchmarkconf_values(bench_result *b) {
     char *cpu_config = cpu_config_retranslate(b->machine->cpu_config, 1, 0);
     char *bv = bench_value_to_str(b->bvalue);
-    char *ret = g_strdup_printf("%s=%s|%d|%s|%s|%s|%s|%d|%d|%d|%d|%s|%s\n",
-            b->machine->mid, bv, b->bvalue.threads_used,
+    char *ret = g_strdup_printf("%s|%d|%s|%s|%s|%s|%d|%d|%d|%d|%s|%s",
+            bv, b->bvalue.threads_used,
             (b->machine->board != NULL) ? b->machine->board : "",
             b->machine->cpu_name,
             (b->machine->cpu_desc != NULL) ? b->machine->cpu_desc : "",
@@ -369,7 +383,114 @@ char *bench_result_benchmarkconf_line(bench_result *b) {
     return ret;
 }
 
+char *bench_result_benchmarkconf_line(bench_result *b) {
+    char *values = bench_result_benchmarkconf_values(b);
+    char *ret = g_strdup_printf("%s=%s\n", b->machine->mid, values);
+    free(values);
+    return ret;
+}
+
+/* s as a quoted JSON string */
+static char *bench_json_str(const char *s) {
+    GString *ret = g_string_new("\"");
+    const guchar *c;
+
+    for (c = (const guchar *)(s ? s : ""); *c; c++) {
+        switch (*c) {
+        case '"':  g_string_append(ret, "\\\""); break;
+        case '\\': g_string_append(ret, "\\\\"); break;
+        case '\n': g_string_append(ret, "\\n"); break;
+        case '\r': g_string_append(ret, "\\r"); break;
+        case '\t': g_string_append(ret, "\\t"); break;
+        default:
+            if (*c < 0x20)
+                g_string_append_printf(ret, "\\u%04x", *c);
+            else
+                g_string_append_c(ret, *c);
+        }
+    }
+    g_string_append_c(ret, '"');
+    return g_string_free(ret, FALSE);
+}
+
+/* one result as a flat JSON object, see bench_import_json() for reading it */
+char *bench_result_json(bench_result *b, gint64 timestamp) {
+    char *name = bench_json_str(b->name);
+    char *mid = bench_json_str(b->machine->mid);
+    char *board = bench_json_str(b->machine->board);
+    char *cpu_name = bench_json_str(b->machine->cpu_name);
+    char *cpu_desc = bench_json_str(b->machine->cpu_desc);
+    char *cpu_config = cpu_config_retranslate(b->machine->cpu_config, 1, 0);
+    char *cpu_config_q = bench_json_str(cpu_config);
+    char *ogl = bench_json_str(b->machine->ogl_renderer);
+    char *gpu = bench_json_str(b->machine->gpu_desc);
+    char *extra = bench_json_str(b->bvalue.extra);
+    /* not %f, which writes a decimal comma in some locales */
+    char result[G_ASCII_DTOSTR_BUF_SIZE], elapsed[G_ASCII_DTOSTR_BUF_SIZE];
+    char *ret;
+
+    g_ascii_dtostr(result, sizeof(result), b->bvalue.result);
+    g_ascii_dtostr(elapsed, sizeof(elapsed), b->bvalue.elapsed_time);
+    ret = g_strdup_printf("{\n"
+        "  \"benchmark\": %s,\n"
+        "  \"mid\": %s,\n"
+        "  \"timestamp\": %" G_GINT64_FORMAT ",\n"
+        "  \"result\": %s,\n"
+        "  \"elapsed_time\": %s,\n"
+        "  \"threads_used\": %d,\n"
+        "  \"extra\": %s,\n"
+        "  \"board\": %s,\n"
+        "  \"cpu_name\": %s,\n"
+        "  \"cpu_desc\": %s,\n"
+        "  \"cpu_config\": %s,\n"
+        "  \"memory_kiB\": %d,\n"
+        "  \"processors\": %d,\n"
+        "  \"cores\": %d,\n"
+        "  \"threads\": %d,\n"
+        "  \"opengl_renderer\": %s,\n"
+        "  \"gpu_desc\": %s\n"
+        "}\n",
+        name, mid, timestamp,
+        result, elapsed, b->bvalue.threads_used, extra,
+        board, cpu_name, cpu_desc, cpu_config_q,
+        b->machine->memory_kiB,
+        b->machine->processors, b->machine->cores, b->machine->threads,
+        ogl, gpu);
+
+    g_free(name);
+    g_free(mid);
+    g_free(board);
+    g_free(cpu_name);
+    g_free(cpu_desc);
+    free(cpu_config);
+    g_free(cpu_config_q);
+    g_free(ogl);
+    g_free(gpu);
+    g_free(extra);
+    return ret;
+}
+
+/* bvalue.extra as a [Details] group */
+static char *bench_result_more_info_extra(bench_result *b) {
+    char *ret;
+    gchar **items;
+    int i;
+
+    if (!*b->bvalue.extra)
+        return g_strdup("");
+
+    ret = g_strdup_printf("[%s]\n", _("Details"));
+    items = g_strsplit(b->bvalue.extra, ";", -1);
+    for (i = 0; items[i]; i++) {
+        if (strchr(items[i], '='))
+            ret = h_strdup_cprintf("%s\n", ret, items[i]);
+    }
+    g_strfreev(items);
+    return ret;
+}
+
 static char *bench_result_more_info_less(bench_result *b) {
+    char *extra;
     char *memory =
         (b->machine->memory_kiB > 0)
         ? g_strdup_printf("%d %s", b->machine->memory_kiB, _("kiB") )
@@ -404,6 +525,9 @@ static char *bench_result_more_info_less(bench_result *b) {
                         _("Memory"), memory
                         );
     free(memory);
+    extra = bench_result_more_info_extra(b);
+    ret = h_strconcat(ret, extra, NULL);
+    g_free(extra);
     return ret;
 }
 
@@ -26,16 +26,24 @@ gchar *CN() { \
         return benchmark_include_results(bench_results[BID], BN); \
 }
 
-BENCH_CALLBACK(callback_gui, "GPU Drawing", BENCHMARK_GUI, 1);
 BENCH_CALLBACK(callback_fft, "FPU FFT", BENCHMARK_FFT, 0);
 BENCH_CALLBACK(callback_nqueens, "CPU N-Queens", BENCHMARK_NQUEENS, 0);
 BENCH_CALLBACK(callback_raytr, "FPU Raytracing", BENCHMARK_RAYTRACE, 0);
+BENCH_CALLBACK(callback_raytr2, "FPU Raytracing (BVH)", BENCHMARK_RAYTRACE2, 1);
 BENCH_CALLBACK(callback_bfsh_single, "CPU Blowfish (Single-thread)", BENCHMARK_BLOWFISH_SINGLE, 1);
 BENCH_CALLBACK(callback_bfsh_threads, "CPU Blowfish (Multi-thread)", BENCHMARK_BLOWFISH_THREADS, 1);
 BENCH_CALLBACK(callback_bfsh_cores, "CPU Blowfish (Multi-core)", BENCHMARK_BLOWFISH_CORES, 1);
+BENCH_CALLBACK(callback_contention, "CPU Lock Contention", BENCHMARK_CONTENTION, 1);
 BENCH_CALLBACK(callback_cryptohash, "CPU CryptoHash", BENCHMARK_CRYPTOHASH, 1);
-BENCH_CALLBACK(callback_fib, "CPU Fibonacci", BENCHMARK_FIB, 0);
+BENCH_CALLBACK(callback_drawing, "CPU Drawing (Cairo)", BENCHMARK_DRAWING, 1);
+BENCH_CALLBACK(callback_intsort, "CPU Integer Hash and Sort", BENCHMARK_INTSORT, 1);
+BENCH_CALLBACK(callback_interp_single, "CPU Interpreter (Single-thread)", BENCHMARK_INTERP_SINGLE, 1);
+BENCH_CALLBACK(callback_interp_threads, "CPU Interpreter (Multi-thread)", BENCHMARK_INTERP_THREADS, 1);
+BENCH_CALLBACK(callback_textproc, "CPU Text Processing", BENCHMARK_TEXTPROC, 1);
 BENCH_CALLBACK(callback_zlib, "CPU Zlib", BENCHMARK_ZLIB, 0);
+BENCH_CALLBACK(callback_pagefault, "Memory Page Faults", BENCHMARK_PAGEFAULT, 1);
+BENCH_CALLBACK(callback_numa, "Memory NUMA Bandwidth", BENCHMARK_NUMA, 1);
+BENCH_CALLBACK(callback_syscalls, "OS System Calls", BENCHMARK_SYSCALLS, 0);
 
 #define BENCH_SCAN_SIMPLE(SN, BF, BID) \
 void SN(gboolean reload) { \
@@ -47,48 +55,41 @@ void SN(gboolean reload) { \
 BENCH_SCAN_SIMPLE(scan_fft, benchmark_fft, BENCHMARK_FFT);
 BENCH_SCAN_SIMPLE(scan_nqueens, benchmark_nqueens, BENCHMARK_NQUEENS);
 BENCH_SCAN_SIMPLE(scan_raytr, benchmark_raytrace, BENCHMARK_RAYTRACE);
+BENCH_SCAN_SIMPLE(scan_raytr2, benchmark_raytrace2, BENCHMARK_RAYTRACE2);
 BENCH_SCAN_SIMPLE(scan_bfsh_single, benchmark_bfish_single, BENCHMARK_BLOWFISH_SINGLE);
 BENCH_SCAN_SIMPLE(scan_bfsh_threads, benchmark_bfish_threads, BENCHMARK_BLOWFISH_THREADS);
 BENCH_SCAN_SIMPLE(scan_bfsh_cores, benchmark_bfish_cores, BENCHMARK_BLOWFISH_CORES);
+BENCH_SCAN_SIMPLE(scan_contention, benchmark_contention, BENCHMARK_CONTENTION);
 BENCH_SCAN_SIMPLE(scan_cryptohash, benchmark_cryptohash, BENCHMARK_CRYPTOHASH);
-BENCH_SCAN_SIMPLE(scan_fib, benchmark_fib, BENCHMARK_FIB);
+BENCH_SCAN_SIMPLE(scan_drawing, benchmark_drawing, BENCHMARK_DRAWING);
+BENCH_SCAN_SIMPLE(scan_intsort, benchmark_intsort, BENCHMARK_INTSORT);
+BENCH_SCAN_SIMPLE(scan_interp_single, benchmark_interp_single, BENCHMARK_INTERP_SINGLE);
+BENCH_SCAN_SIMPLE(scan_interp_threads, benchmark_interp_threads, BENCHMARK_INTERP_THREADS);
+BENCH_SCAN_SIMPLE(scan_textproc, benchmark_textproc, BENCHMARK_TEXTPROC);
 BENCH_SCAN_SIMPLE(scan_zlib, benchmark_zlib, BENCHMARK_ZLIB);
-
-#if !GTK_CHECK_VERSION(3,0,0)
-void scan_gui(gboolean reload)
-{
-    SCAN_START();
-
-    bench_value er = EMPTY_BENCH_VALUE;
-
-    if (params.run_benchmark) {
-        int argc = 0;
-
-        ui_init(&argc, NULL);
-    }
-
-    if (params.gui_running || params.run_benchmark) {
-        do_benchmark(benchmark_gui, BENCHMARK_GUI);
-    } else {
-        bench_results[BENCHMARK_GUI] = er;
-    }
-    SCAN_END();
-}
-#endif
+BENCH_SCAN_SIMPLE(scan_pagefault, benchmark_pagefault, BENCHMARK_PAGEFAULT);
+BENCH_SCAN_SIMPLE(scan_numa, benchmark_numa, BENCHMARK_NUMA);
+BENCH_SCAN_SIMPLE(scan_syscalls, benchmark_syscalls, BENCHMARK_SYSCALLS);
 
 static ModuleEntry entries[] = {
-    {N_("CPU Blowfish (Single-thread)"), "blowfish.png", callback_bfsh_single, scan_bfsh_single, MODULE_FLAG_NONE},
-    {N_("CPU Blowfish (Multi-thread)"), "blowfish.png", callback_bfsh_threads, scan_bfsh_threads, MODULE_FLAG_NONE},
-    {N_("CPU Blowfish (Multi-core)"), "blowfish.png", callback_bfsh_cores, scan_bfsh_cores, MODULE_FLAG_NONE},
-    {N_("CPU CryptoHash"), "cryptohash.png", callback_cryptohash, scan_cryptohash, MODULE_FLAG_NONE},
-    {N_("CPU Fibonacci"), "nautilus.png", callback_fib, scan_fib, MODULE_FLAG_NONE},
-    {N_("CPU N-Queens"), "nqueens.png", callback_nqueens, scan_nqueens, MODULE_FLAG_NONE},
-    {N_("CPU Zlib"), "file-roller.png", callback_zlib, scan_zlib, MODULE_FLAG_NONE},
-    {N_("FPU FFT"), "fft.png", callback_fft, scan_fft, MODULE_FLAG_NONE},
-    {N_("FPU Raytracing"), "raytrace.png", callback_raytr, scan_raytr, MODULE_FLAG_NONE},
-#if !GTK_CHECK_VERSION(3,0,0)
-    {N_("GPU Drawing"), "module.png", callback_gui, scan_gui, MODULE_FLAG_NO_REMOTE},
-#endif
+    {N_("CPU Blowfish (Single-thread)"), "blowfish.png", callback_bfsh_single, scan_bfsh_single, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Blowfish (Multi-thread)"), "blowfish.png", callback_bfsh_threads, scan_bfsh_threads, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Blowfish (Multi-core)"), "blowfish.png", callback_bfsh_cores, scan_bfsh_cores, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Lock Contention"), "module.png", callback_contention, scan_contention, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU CryptoHash"), "cryptohash.png", callback_cryptohash, scan_cryptohash, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Drawing (Cairo)"), "module.png", callback_drawing, scan_drawing, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Integer Hash and Sort"), "module.png", callback_intsort, scan_intsort, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Interpreter (Single-thread)"), "nautilus.png", callback_interp_single, scan_interp_single, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Interpreter (Multi-thread)"), "nautilus.png", callback_interp_threads, scan_interp_threads, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU N-Queens"), "nqueens.png", callback_nqueens, scan_nqueens, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Text Processing"), "language.png", callback_textproc, scan_textproc, MODULE_FLAG_NO_PARALLEL},
+    {N_("CPU Zlib"), "file-roller.png", callback_zlib, scan_zlib, MODULE_FLAG_NO_PARALLEL},
+    {N_("FPU FFT"), "fft.png", callback_fft, scan_fft, MODULE_FLAG_NO_PARALLEL},
+    {N_("FPU Raytracing"), "raytrace.png", callback_raytr, scan_raytr, MODULE_FLAG_NO_PARALLEL},
+    {N_("FPU Raytracing (BVH)"), "raytrace.png", callback_raytr2, scan_raytr2, MODULE_FLAG_NO_PARALLEL},
+    {N_("Memory Page Faults"), "memory.png", callback_pagefault, scan_pagefault, MODULE_FLAG_NO_PARALLEL},
+    {N_("Memory NUMA Bandwidth"), "memory.png", callback_numa, scan_numa, MODULE_FLAG_NO_PARALLEL},
+    {N_("OS System Calls"), "os.png", callback_syscalls, scan_syscalls, MODULE_FLAG_NO_PARALLEL},
     {NULL}
 };
 
@@ -98,16 +99,38 @@ const gchar *hi_note_func(gint entry)
     case BENCHMARK_CRYPTOHASH:
         return _("Results in MiB/second. Higher is better.");
 
+    case BENCHMARK_TEXTPROC:
+        return _("Results in MB/second. Higher is better.");
+
+    case BENCHMARK_NUMA:
+        return _("Results in MiB/second of local memory bandwidth per node. Higher is better.");
+
+    case BENCHMARK_CONTENTION:
+    case BENCHMARK_INTSORT:
+    case BENCHMARK_INTERP_SINGLE:
+    case BENCHMARK_INTERP_THREADS:
+        return _("Results in millions of operations/second. Higher is better.");
+
+    case BENCHMARK_PAGEFAULT:
+        return _("Results in thousands of page faults/second. Higher is better.");
+
+    case BENCHMARK_SYSCALLS:
+        return _("Results in nanoseconds per system call. Lower is better.");
+
+    case BENCHMARK_RAYTRACE2:
+        return _("Results in millions of rays/second. Higher is better.");
+
     case BENCHMARK_BLOWFISH_SINGLE:
     case BENCHMARK_BLOWFISH_THREADS:
     case BENCHMARK_BLOWFISH_CORES:
     case BENCHMARK_ZLIB:
-    case BENCHMARK_GUI:
         return _("Results in HIMarks. Higher is better.");
 
+    case BENCHMARK_DRAWING:
+        return _("Results in thousands of operations/second. Higher is better.");
+
     case BENCHMARK_FFT:
     case BENCHMARK_RAYTRACE:
-    case BENCHMARK_FIB:
     case BENCHMARK_NQUEENS:
         return _("Results in seconds. Lower is better.");
     }
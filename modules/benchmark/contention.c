@@ -0,0 +1,386 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+
+#include "hardinfo.h"
+#include "cpu_util.h"
+#include "benchmark.h"
+
+/* Contention on one shared cache line: an atomic counter, a counter
+ * behind a GMutex, one behind a spinlock, and a bounded MPMC queue where
+ * every thread enqueues and then dequeues. Each runs for CT_TIME seconds
+ * with 1, 2, 4... threads up to all of them, threads pinned one per core
+ * before SMT siblings are used. Every thread counts its own operations;
+ * fairness is Jain's index of those counts, 1.00 when all threads got
+ * the same share and 1/n when one thread got everything. All the
+ * curves are saved as a table next to the result store; extra keeps
+ * them for up to CT_ROW_COUNTS thread counts, and only the ends above.
+ * The result is the geometric mean of the four throughputs with all
+ * threads, in millions of operations per second; 0 if a counter or the
+ * queue contents do not add up. */
+#define CT_TIME   0.25
+#define CT_BATCH  256           /* operations per call, between stop checks */
+#define CT_QUEUE  1024          /* slots, a power of two */
+#define CT_LINE   64
+#define CT_ROW_COUNTS 5         /* thread counts that fit in extra */
+
+enum {
+    CT_ATOMIC,
+    CT_MUTEX,
+    CT_SPINLOCK,
+    CT_QUEUE_MPMC,
+    CT_N_TESTS
+};
+
+static const gchar *ct_names[CT_N_TESTS] = {
+    "Atomic Add", "Mutex", "Spinlock", "MPMC Queue"
+};
+
+/* one cache line per thread */
+typedef struct {
+    guint64 ops;
+    guint64 sum_in, sum_out;    /* queue values */
+    gint pinned;
+    gint pad_[CT_LINE / sizeof(gint) - 7];
+} ct_thread;
+
+typedef struct {
+    volatile gint seq;
+    gint value;
+} ct_cell;
+
+typedef struct {
+    gint test;
+    ct_thread *threads;
+    gint *cpus;                 /* pinning order */
+    gint n_cpus;
+
+    /* each shared item on its own line */
+    volatile gint counter;
+    gchar pad0_[CT_LINE];
+    volatile gint lock;
+    guint64 locked_counter;
+    gchar pad1_[CT_LINE];
+    GMutex mutex;
+    gchar pad2_[CT_LINE];
+    volatile gint enqueue_pos;
+    gchar pad3_[CT_LINE];
+    volatile gint dequeue_pos;
+    gchar pad4_[CT_LINE];
+    ct_cell cells[CT_QUEUE];
+} ct_shared;
+
+static inline void ct_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/* Vyukov's bounded MPMC queue */
+static gboolean ct_enqueue(ct_shared *s, gint value) {
+    gint pos = g_atomic_int_get(&s->enqueue_pos);
+    ct_cell *cell;
+
+    for (;;) {
+        gint diff;
+        cell = &s->cells[pos & (CT_QUEUE - 1)];
+        diff = g_atomic_int_get(&cell->seq) - pos;
+        if (diff == 0) {
+            if (g_atomic_int_compare_and_exchange(&s->enqueue_pos, pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            return FALSE;       /* full */
+        }
+        pos = g_atomic_int_get(&s->enqueue_pos);
+    }
+    cell->value = value;
+    g_atomic_int_set(&cell->seq, pos + 1);
+    return TRUE;
+}
+
+static gboolean ct_dequeue(ct_shared *s, gint *value) {
+    gint pos = g_atomic_int_get(&s->dequeue_pos);
+    ct_cell *cell;
+
+    for (;;) {
+        gint diff;
+        cell = &s->cells[pos & (CT_QUEUE - 1)];
+        diff = g_atomic_int_get(&cell->seq) - (pos + 1);
+        if (diff == 0) {
+            if (g_atomic_int_compare_and_exchange(&s->dequeue_pos, pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            return FALSE;       /* empty */
+        }
+        pos = g_atomic_int_get(&s->dequeue_pos);
+    }
+    *value = cell->value;
+    g_atomic_int_set(&cell->seq, pos + CT_QUEUE);
+    return TRUE;
+}
+
+static void ct_pin(ct_shared *s, gint thread_number) {
+    cpu_set_t set;
+
+    if (!s->n_cpus)
+        return;
+    CPU_ZERO(&set);
+    CPU_SET(s->cpus[thread_number % s->n_cpus], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+static gpointer ct_batch(void *data, gint thread_number) {
+    ct_shared *s = data;
+    ct_thread *t = &s->threads[thread_number];
+    gint i, v;
+
+    if (!t->pinned) {
+        ct_pin(s, thread_number);
+        t->pinned = 1;
+    }
+
+    switch (s->test) {
+    case CT_ATOMIC:
+        for (i = 0; i < CT_BATCH; i++)
+            g_atomic_int_inc(&s->counter);
+        t->ops += CT_BATCH;
+        break;
+    case CT_MUTEX:
+        for (i = 0; i < CT_BATCH; i++) {
+            g_mutex_lock(&s->mutex);
+            s->locked_counter++;
+            g_mutex_unlock(&s->mutex);
+        }
+        t->ops += CT_BATCH;
+        break;
+    case CT_SPINLOCK:
+        for (i = 0; i < CT_BATCH; i++) {
+            while (!g_atomic_int_compare_and_exchange(&s->lock, 0, 1))
+                while (g_atomic_int_get(&s->lock))
+                    ct_relax();
+            s->locked_counter++;
+            g_atomic_int_set(&s->lock, 0);
+        }
+        t->ops += CT_BATCH;
+        break;
+    case CT_QUEUE_MPMC:
+        /* values are thread_number + 1 + i, so lost or repeated ones
+         * show up in the sums */
+        for (i = 0; i < CT_BATCH; i++) {
+            v = thread_number + 1 + i;
+            while (!ct_enqueue(s, v))
+                ct_relax();
+            t->sum_in += v;
+            while (!ct_dequeue(s, &v))
+                ct_relax();
+            t->sum_out += v;
+        }
+        t->ops += 2 * CT_BATCH;
+        break;
+    }
+
+    return NULL;
+}
+
+static gint ct_cmp_topology(gconstpointer a, gconstpointer b) {
+    const gint *x = a, *y = b;
+    gint i;
+
+    /* sibling rank, socket, core, cpu */
+    for (i = 0; i < 4; i++)
+        if (x[i] != y[i])
+            return (x[i] > y[i]) - (x[i] < y[i]);
+    return 0;
+}
+
+/* the CPUs this process may run on, first one per core, then the
+ * remaining SMT siblings */
+static gint *ct_cpu_order(gint *n_cpus) {
+    cpu_set_t set;
+    gint *keys, *cpus, n = 0, i, j, cpu;
+
+    *n_cpus = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return NULL;
+
+    keys = g_new0(gint, 4 * CPU_COUNT(&set));
+    for (cpu = 0; cpu < CPU_SETSIZE && n < CPU_COUNT(&set); cpu++) {
+        cpu_topology_data *topo;
+
+        if (!CPU_ISSET(cpu, &set))
+            continue;
+        topo = cputopo_new(cpu);
+        keys[4 * n + 1] = (topo && topo->socket_id >= 0) ? topo->socket_id : 0;
+        keys[4 * n + 2] = (topo && topo->core_id >= 0) ? topo->core_id : cpu;
+        keys[4 * n + 3] = cpu;
+        cputopo_free(topo);
+
+        for (j = 0; j < n; j++)
+            if (keys[4 * j + 1] == keys[4 * n + 1] && keys[4 * j + 2] == keys[4 * n + 2])
+                keys[4 * n]++;
+        n++;
+    }
+    qsort(keys, n, 4 * sizeof(gint), ct_cmp_topology);
+
+    cpus = g_new(gint, n);
+    for (i = 0; i < n; i++)
+        cpus[i] = keys[4 * i + 3];
+    g_free(keys);
+
+    *n_cpus = n;
+    return cpus;
+}
+
+/* ops/s with n threads; *fairness is Jain's index of the per-thread
+ * counts; FALSE if the shared state does not match them */
+static gboolean ct_run(ct_shared *s, gint test, gint n, double *ops_per_s, double *fairness) {
+    bench_value r;
+    guint64 total = 0, sum_in = 0, sum_out = 0;
+    double squares = 0;
+    gint i, v;
+
+    s->test = test;
+    s->counter = 0;
+    s->lock = 0;
+    s->locked_counter = 0;
+    s->enqueue_pos = s->dequeue_pos = 0;
+    for (i = 0; i < CT_QUEUE; i++)
+        s->cells[i].seq = i;
+    memset(s->threads, 0, n * sizeof(ct_thread));
+
+    r = benchmark_crunch_for(benchmark_time(CT_TIME), n, ct_batch, s);
+
+    for (i = 0; i < n; i++) {
+        total += s->threads[i].ops;
+        squares += (double)s->threads[i].ops * s->threads[i].ops;
+        sum_in += s->threads[i].sum_in;
+        sum_out += s->threads[i].sum_out;
+    }
+    while (ct_dequeue(s, &v))
+        sum_out += v;
+
+    *ops_per_s = total / r.elapsed_time;
+    *fairness = squares > 0 ? (double)total * total / (n * squares) : 0;
+
+    switch (test) {
+    case CT_ATOMIC:
+        return (guint32)s->counter == (guint32)total;
+    case CT_MUTEX:
+    case CT_SPINLOCK:
+        return s->locked_counter == total;
+    case CT_QUEUE_MPMC:
+        return sum_in == sum_out;
+    }
+    return TRUE;
+}
+
+void
+benchmark_contention(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    ct_shared *s;
+    gchar *rates[CT_N_TESTS], *fair[CT_N_TESTS];
+    double ops[CT_N_TESTS], rate, fairness, log_sum = 0, elapsed = 0;
+    gint cpu_procs, cpu_cores, cpu_threads, n, last, test, n_counts;
+    gboolean valid = TRUE;
+    GString *csv;
+    gpointer mem;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running lock contention benchmark...");
+
+    cpu_procs_cores_threads(&cpu_procs, &cpu_cores, &cpu_threads);
+    if (cpu_threads < 1)
+        cpu_threads = 1;
+
+    s = g_new0(ct_shared, 1);
+    g_mutex_init(&s->mutex);
+    mem = g_malloc0((cpu_threads + 1) * sizeof(ct_thread));
+    s->threads = (ct_thread *)(((guintptr)mem + CT_LINE - 1) & ~(guintptr)(CT_LINE - 1));
+    s->cpus = ct_cpu_order(&s->n_cpus);
+
+    for (test = 0; test < CT_N_TESTS; test++) {
+        rates[test] = g_strdup("");
+        fair[test] = g_strdup("");
+    }
+    csv = g_string_new("threads,test,mops_s,fairness\n");
+
+    for (n = 1, n_counts = 1; n < cpu_threads; n *= 2)
+        n_counts++;
+
+    /* 1, 2, 4... and all threads */
+    for (n = 1, last = 0; !last; n *= 2) {
+        if (n >= cpu_threads) {
+            n = cpu_threads;
+            last = 1;
+        }
+        for (test = 0; test < CT_N_TESTS; test++) {
+            if (!ct_run(s, test, n, &rate, &fairness)) {
+                DEBUG("contention: %s with %d threads lost updates", ct_names[test], n);
+                valid = FALSE;
+            }
+            elapsed += benchmark_time(CT_TIME);
+            ops[test] = rate;
+            g_string_append_printf(csv, "%d,%s,%f,%f\n", n, ct_names[test], rate / 1e6, fairness);
+            if (n_counts > CT_ROW_COUNTS && n != 1 && !last)
+                continue;
+            rates[test] = h_strdup_cprintf("%s%d: %.3g", rates[test],
+                                           *rates[test] ? ", " : "", n, rate / 1e6);
+            fair[test] = h_strdup_cprintf("%s%d: %.2f", fair[test],
+                                          *fair[test] ? ", " : "", n, fairness);
+        }
+    }
+
+    for (test = 0; test < CT_N_TESTS; test++) {
+        gchar *key = g_strdup_printf("%s (Mops/s)", ct_names[test]);
+        bench_value_add_extra(&r, key, "%s", rates[test]);
+        g_free(key);
+        key = g_strdup_printf("%s Fairness", ct_names[test]);
+        bench_value_add_extra(&r, key, "%s", fair[test]);
+        g_free(key);
+        g_free(rates[test]);
+        g_free(fair[test]);
+        log_sum += log(MAX(ops[test], 1.0));
+    }
+    if (n_counts > CT_ROW_COUNTS)
+        bench_value_add_extra(&r, "Thread Counts", "2 of %d shown, all in the table", n_counts);
+    bench_value_add_extra(&r, "Pinning", "%s", s->n_cpus ? "one per core, then SMT siblings" : "none");
+    bench_value_add_table(&r, "contention", csv->str);
+    g_string_free(csv, TRUE);
+    bench_value_add_extra(&r, "Validation", "%s", valid ? "passed" : "FAILED");
+
+    r.threads_used = cpu_threads;
+    r.elapsed_time = elapsed;
+    r.result = valid ? exp(log_sum / CT_N_TESTS) / 1e6 : 0;
+
+    g_mutex_clear(&s->mutex);
+    g_free(s->cpus);
+    g_free(mem);
+    g_free(s);
+
+    bench_results[BENCHMARK_CONTENTION] = r;
+}
@@ -34,6 +34,7 @@ static gpointer fft_for(unsigned int start, unsigned int end, void *data, gint t
 }
 
 #define FFT_MAXT 4
+#define FFT_TIME 5
 
 void
 benchmark_fft(void)
@@ -43,6 +44,7 @@ benchmark_fft(void)
     int n_cores, i;
     gchar *temp;
     FFTBench **benches;
+    guint size;
 
     shell_view_set_enabled(FALSE);
     shell_status_update("Running FFT benchmark...");
@@ -54,7 +56,7 @@ benchmark_fft(void)
     }
 
     /* Run the benchmark */
-    r = benchmark_parallel_for(FFT_MAXT, 0, FFT_MAXT, fft_for, benches);
+    r = benchmark_parallel_for_time(FFT_MAXT, benchmark_time(FFT_TIME), &size, fft_for, benches);
 
     /* Free up the memory */
     for (i = 0; i < FFT_MAXT; i++) {
@@ -62,6 +64,7 @@ benchmark_fft(void)
     }
     g_free(benches);
 
-    r.result = r.elapsed_time;
+    /* seconds for one run per thread, as results always were */
+    r.result = benchmark_fixed_work_time(r, size, FFT_MAXT);
     bench_results[BENCHMARK_FFT] = r;
 }
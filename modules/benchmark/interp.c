@@ -0,0 +1,312 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* A small register bytecode interpreter running a fixed mix of three
+ * programs: Collatz sequences (tight loops, unpredictable branches),
+ * hashing a table of words, and building then searching a binary tree
+ * (dependent loads). Every bytecode instruction is a trip through the
+ * dispatch switch, so the score follows how well the core predicts
+ * branches and keeps its integer pipes busy, like any interpreter does.
+ * The mix runs over and over for IP_TIME seconds on one thread, then on
+ * all threads, and its checksum must match IP_CHECKSUM every time.
+ * Results are in millions of bytecode instructions per second. */
+#define IP_TIME      5
+#define IP_MEM       16384      /* words of VM memory, a power of two */
+#define IP_CHECKSUM  0xde7c79b3U
+
+enum {
+    OP_HALT,
+    OP_LI,      /* a = imm */
+    OP_MOV,     /* a = b */
+    OP_ADD,     /* a = b + c */
+    OP_ADDI,    /* a = b + imm */
+    OP_MUL,     /* a = b * c */
+    OP_XOR,     /* a = b ^ c */
+    OP_ANDI,    /* a = b & imm */
+    OP_SHRI,    /* a = b >> imm */
+    OP_ROTLI,   /* a = b <<< imm */
+    OP_LD,      /* a = mem[b + imm] */
+    OP_ST,      /* mem[b + imm] = a */
+    OP_JMP,     /* goto imm */
+    OP_JZ,      /* if (!a) goto imm */
+    OP_JNZ,     /* if (a) goto imm */
+    OP_JEQ,     /* if (a == b) goto imm */
+    OP_JLT,     /* if (a < b) goto imm */
+};
+
+typedef struct {
+    guint8 op, a, b, c;
+    gint32 imm;
+} ip_insn;
+
+#define I(op, a, b, c, imm) { op, a, b, c, imm }
+
+/* r0 = total steps of the Collatz sequences for 1..2999 */
+static const ip_insn ip_collatz[] = {
+    /*  0 */ I(OP_LI,    0, 0, 0, 0),
+    /*  1 */ I(OP_LI,    1, 0, 0, 1),           /* n */
+    /*  2 */ I(OP_LI,    2, 0, 0, 3000),
+    /*  3 */ I(OP_LI,    7, 0, 0, 1),
+    /*  4 */ I(OP_MOV,   3, 1, 0, 0),           /* x = n */
+    /*  5 */ I(OP_JEQ,   3, 7, 0, 15),          /* while (x != 1) */
+    /*  6 */ I(OP_ANDI,  4, 3, 0, 1),
+    /*  7 */ I(OP_JZ,    4, 0, 0, 12),
+    /*  8 */ I(OP_ADD,   5, 3, 3, 0),           /* x = 3x + 1 */
+    /*  9 */ I(OP_ADD,   3, 5, 3, 0),
+    /* 10 */ I(OP_ADDI,  3, 3, 0, 1),
+    /* 11 */ I(OP_JMP,   0, 0, 0, 13),
+    /* 12 */ I(OP_SHRI,  3, 3, 0, 1),           /* x = x / 2 */
+    /* 13 */ I(OP_ADDI,  0, 0, 0, 1),
+    /* 14 */ I(OP_JMP,   0, 0, 0, 5),
+    /* 15 */ I(OP_ADDI,  1, 1, 0, 1),
+    /* 16 */ I(OP_JLT,   1, 2, 0, 4),
+    /* 17 */ I(OP_HALT,  0, 0, 0, 0),
+};
+
+/* fills memory from an LCG, then hashes it eight times over, with a
+ * branch on each word */
+static const ip_insn ip_hash[] = {
+    /*  0 */ I(OP_LI,    1, 0, 0, 0),           /* i */
+    /*  1 */ I(OP_LI,    2, 0, 0, IP_MEM),
+    /*  2 */ I(OP_LI,    3, 0, 0, 12345),       /* LCG state */
+    /*  3 */ I(OP_LI,    8, 0, 0, 1664525),
+    /*  4 */ I(OP_LI,    9, 0, 0, 1013904223),
+    /*  5 */ I(OP_MUL,   3, 3, 8, 0),
+    /*  6 */ I(OP_ADD,   3, 3, 9, 0),
+    /*  7 */ I(OP_ST,    3, 1, 0, 0),
+    /*  8 */ I(OP_ADDI,  1, 1, 0, 1),
+    /*  9 */ I(OP_JLT,   1, 2, 0, 5),
+    /* 10 */ I(OP_LI,    0, 0, 0, (gint32)2166136261U),
+    /* 11 */ I(OP_LI,   11, 0, 0, 16777619),
+    /* 12 */ I(OP_LI,   10, 0, 0, 8),           /* rounds */
+    /* 13 */ I(OP_LI,    1, 0, 0, 0),
+    /* 14 */ I(OP_LD,    4, 1, 0, 0),
+    /* 15 */ I(OP_ANDI,  5, 4, 0, 0x100),
+    /* 16 */ I(OP_JZ,    5, 0, 0, 19),
+    /* 17 */ I(OP_ADD,   0, 0, 4, 0),
+    /* 18 */ I(OP_JMP,   0, 0, 0, 21),
+    /* 19 */ I(OP_SHRI,  5, 4, 0, 3),
+    /* 20 */ I(OP_XOR,   0, 0, 5, 0),
+    /* 21 */ I(OP_MUL,   0, 0, 11, 0),
+    /* 22 */ I(OP_ROTLI, 0, 0, 0, 13),
+    /* 23 */ I(OP_ADDI,  1, 1, 0, 1),
+    /* 24 */ I(OP_JLT,   1, 2, 0, 14),
+    /* 25 */ I(OP_ADDI, 10, 10, 0, -1),
+    /* 26 */ I(OP_JNZ,  10, 0, 0, 13),
+    /* 27 */ I(OP_HALT,  0, 0, 0, 0),
+};
+
+/* inserts 4000 random keys into a binary search tree kept in memory as
+ * { key, left, right } triples (node 1 is the root, 0 is null), then
+ * looks up the same 4000 keys and 4000 more; r0 = sum of the lookup
+ * depths, plus 1000 per key found */
+static const ip_insn ip_tree[] = {
+    /*  0 */ I(OP_LI,    0, 0, 0, 0),
+    /*  1 */ I(OP_LI,    3, 0, 0, 54321),       /* LCG state */
+    /*  2 */ I(OP_LI,    8, 0, 0, 1664525),
+    /*  3 */ I(OP_LI,    9, 0, 0, 1013904223),
+    /*  4 */ I(OP_LI,    5, 0, 0, 1),           /* next free node */
+    /*  5 */ I(OP_LI,    2, 0, 0, 4000),        /* keys to insert */
+    /*  6 */ I(OP_LI,   14, 0, 0, 0),
+    /*  7 */ I(OP_LI,   15, 0, 0, 3),
+    /*  8 */ I(OP_MUL,   3, 3, 8, 0),           /* key for the root */
+    /*  9 */ I(OP_ADD,   3, 3, 9, 0),
+    /* 10 */ I(OP_SHRI,  4, 3, 0, 8),
+    /* 11 */ I(OP_MUL,  13, 5, 15, 0),          /* fill in a new node */
+    /* 12 */ I(OP_ST,    4, 13, 0, 0),
+    /* 13 */ I(OP_ST,   14, 13, 0, 1),
+    /* 14 */ I(OP_ST,   14, 13, 0, 2),
+    /* 15 */ I(OP_ADDI,  5, 5, 0, 1),
+    /* 16 */ I(OP_ADDI,  2, 2, 0, -1),
+    /* 17 */ I(OP_JZ,    2, 0, 0, 36),
+    /* 18 */ I(OP_MUL,   3, 3, 8, 0),           /* next key */
+    /* 19 */ I(OP_ADD,   3, 3, 9, 0),
+    /* 20 */ I(OP_SHRI,  4, 3, 0, 8),
+    /* 21 */ I(OP_LI,    6, 0, 0, 1),           /* walk down from the root */
+    /* 22 */ I(OP_MUL,   7, 6, 15, 0),
+    /* 23 */ I(OP_LD,   12, 7, 0, 0),
+    /* 24 */ I(OP_JLT,   4, 12, 0, 29),
+    /* 25 */ I(OP_LD,   12, 7, 0, 2),
+    /* 26 */ I(OP_JZ,   12, 0, 0, 32),
+    /* 27 */ I(OP_MOV,   6, 12, 0, 0),
+    /* 28 */ I(OP_JMP,   0, 0, 0, 22),
+    /* 29 */ I(OP_LD,   12, 7, 0, 1),
+    /* 30 */ I(OP_JZ,   12, 0, 0, 34),
+    /* 31 */ I(OP_JMP,   0, 0, 0, 27),
+    /* 32 */ I(OP_ST,    5, 7, 0, 2),           /* link as right child */
+    /* 33 */ I(OP_JMP,   0, 0, 0, 11),
+    /* 34 */ I(OP_ST,    5, 7, 0, 1),           /* link as left child */
+    /* 35 */ I(OP_JMP,   0, 0, 0, 11),
+    /* 36 */ I(OP_LI,    3, 0, 0, 54321),       /* same keys again */
+    /* 37 */ I(OP_LI,    2, 0, 0, 8000),
+    /* 38 */ I(OP_MUL,   3, 3, 8, 0),
+    /* 39 */ I(OP_ADD,   3, 3, 9, 0),
+    /* 40 */ I(OP_SHRI,  4, 3, 0, 8),
+    /* 41 */ I(OP_LI,    6, 0, 0, 1),
+    /* 42 */ I(OP_MUL,   7, 6, 15, 0),
+    /* 43 */ I(OP_ADDI,  0, 0, 0, 1),
+    /* 44 */ I(OP_LD,   12, 7, 0, 0),
+    /* 45 */ I(OP_JEQ,   4, 12, 0, 53),
+    /* 46 */ I(OP_JLT,   4, 12, 0, 50),
+    /* 47 */ I(OP_LD,    6, 7, 0, 2),
+    /* 48 */ I(OP_JNZ,   6, 0, 0, 42),
+    /* 49 */ I(OP_JMP,   0, 0, 0, 54),
+    /* 50 */ I(OP_LD,    6, 7, 0, 1),
+    /* 51 */ I(OP_JNZ,   6, 0, 0, 42),
+    /* 52 */ I(OP_JMP,   0, 0, 0, 54),
+    /* 53 */ I(OP_ADDI,  0, 0, 0, 1000),        /* found */
+    /* 54 */ I(OP_ADDI,  2, 2, 0, -1),
+    /* 55 */ I(OP_JNZ,   2, 0, 0, 38),
+    /* 56 */ I(OP_HALT,  0, 0, 0, 0),
+};
+
+static const ip_insn *ip_programs[] = { ip_collatz, ip_hash, ip_tree };
+
+/* runs prog to OP_HALT; returns r0, and the number of instructions
+ * executed in *count */
+static guint32 ip_run(const ip_insn *prog, guint32 *mem, guint64 *count)
+{
+    guint32 r[16];
+    const ip_insn *pc = prog;
+    guint64 n = 0;
+
+    memset(r, 0, sizeof(r));
+
+    for (;;) {
+        const ip_insn *i = pc++;
+
+        n++;
+        switch (i->op) {
+        case OP_HALT:
+            *count = n;
+            return r[0];
+        case OP_LI:
+            r[i->a] = (guint32)i->imm;
+            break;
+        case OP_MOV:
+            r[i->a] = r[i->b];
+            break;
+        case OP_ADD:
+            r[i->a] = r[i->b] + r[i->c];
+            break;
+        case OP_ADDI:
+            r[i->a] = r[i->b] + (guint32)i->imm;
+            break;
+        case OP_MUL:
+            r[i->a] = r[i->b] * r[i->c];
+            break;
+        case OP_XOR:
+            r[i->a] = r[i->b] ^ r[i->c];
+            break;
+        case OP_ANDI:
+            r[i->a] = r[i->b] & (guint32)i->imm;
+            break;
+        case OP_SHRI:
+            r[i->a] = r[i->b] >> (i->imm & 31);
+            break;
+        case OP_ROTLI:
+            r[i->a] = (r[i->b] << (i->imm & 31)) | (r[i->b] >> ((32 - i->imm) & 31));
+            break;
+        case OP_LD:
+            r[i->a] = mem[(r[i->b] + i->imm) & (IP_MEM - 1)];
+            break;
+        case OP_ST:
+            mem[(r[i->b] + i->imm) & (IP_MEM - 1)] = r[i->a];
+            break;
+        case OP_JMP:
+            pc = prog + i->imm;
+            break;
+        case OP_JZ:
+            if (!r[i->a])
+                pc = prog + i->imm;
+            break;
+        case OP_JNZ:
+            if (r[i->a])
+                pc = prog + i->imm;
+            break;
+        case OP_JEQ:
+            if (r[i->a] == r[i->b])
+                pc = prog + i->imm;
+            break;
+        case OP_JLT:
+            if (r[i->a] < r[i->b])
+                pc = prog + i->imm;
+            break;
+        }
+    }
+}
+
+/* the whole mix once; returns the checksum */
+static guint32 ip_mix(guint64 *count)
+{
+    guint32 *mem = g_new0(guint32, IP_MEM);
+    guint32 sum = 0;
+    guint64 n;
+    gint i;
+
+    *count = 0;
+    for (i = 0; i < G_N_ELEMENTS(ip_programs); i++) {
+        sum = (sum << 7 | sum >> 25) ^ ip_run(ip_programs[i], mem, &n);
+        *count += n;
+    }
+    g_free(mem);
+
+    return sum;
+}
+
+static gpointer ip_exec(void *data, gint thread_number)
+{
+    gint *failed = data;
+    guint64 count;
+
+    if (ip_mix(&count) != IP_CHECKSUM)
+        g_atomic_int_set(failed, 1);
+
+    return NULL;
+}
+
+static void benchmark_interp_do(int threads, int entry, const char *status)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    guint64 count;
+    gint failed = 0;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update(status);
+
+    /* the mix always runs the same instructions; count them once */
+    if (ip_mix(&count) != IP_CHECKSUM)
+        failed = 1;
+
+    r = benchmark_crunch_for_load(benchmark_time(IP_TIME), threads, count / 1000000.0,
+                                  ip_exec, &failed);
+    r.result = r.result * count / r.elapsed_time / 1000000.0;
+
+    bench_value_add_extra(&r, "Instructions per Mix", "%" G_GUINT64_FORMAT, count);
+    bench_value_add_extra(&r, "Validation", "%s", failed ? "FAILED" : "passed");
+    if (failed)
+        r.result = 0;
+
+    bench_results[entry] = r;
+}
+
+void benchmark_interp_single(void) { benchmark_interp_do(1, BENCHMARK_INTERP_SINGLE, "Running bytecode interpreter benchmark (single-thread)..."); }
+void benchmark_interp_threads(void) { benchmark_interp_do(0, BENCHMARK_INTERP_THREADS, "Running bytecode interpreter benchmark (multi-thread)..."); }
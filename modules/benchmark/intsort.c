@@ -0,0 +1,329 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Memory-bound integer work on all threads: build an open-addressing
+ * hash table with concurrent inserts and probe it with as many missing
+ * keys as present ones, then LSD radix sort 32-bit keys, 8 bits per
+ * pass. Each phase is split across threads by benchmark_parallel_for()
+ * and checked: every present key must be found and no missing one, and
+ * the sorted keys must be in order with the same sum and xor as before.
+ * The result is millions of operations (inserts, lookups and keys
+ * sorted) per second; 0 if a check fails. The sizes stay fixed, as
+ * they decide how far the data is from the CPU; both phases are
+ * repeated instead until they take the profile's time. */
+#define INTSORT_TIME 6      /* seconds, half hashing and half sorting */
+#define HT_KEYS     (16 << 20)
+#define SORT_KEYS   100000000
+#define SORT_MIN    (1 << 20)
+#define RADIX_BITS  8
+#define RADIX       (1 << RADIX_BITS)
+
+typedef struct {
+    guint32 *slots;     /* 0 is empty */
+    guint32 mask;
+} int_hash;
+
+typedef struct {
+    guint32 *keys, *tmp;
+    guint n, n_parts;
+    guint shift;
+    guint (*count)[RADIX];  /* per part */
+} int_sort;
+
+/* invertible, and 0 -> 0, so keys 1..n are distinct and never empty */
+static inline guint32 int_mix(guint32 x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static gpointer int_hash_insert(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    int_hash *h = data;
+    unsigned int i;
+
+    for (i = start; i <= end; i++) {
+        guint32 key = int_mix(i), pos = key & h->mask;
+
+        for (;;) {
+            guint32 cur = (guint32)g_atomic_int_get((volatile gint *)&h->slots[pos]);
+            if (cur == key)
+                break;
+            if (cur == 0) {
+                if (g_atomic_int_compare_and_exchange((volatile gint *)&h->slots[pos], 0, (gint)key))
+                    break;
+                continue; /* another thread took the slot; look at it again */
+            }
+            pos = (pos + 1) & h->mask;
+        }
+    }
+
+    return NULL;
+}
+
+/* Keys 1..HT_KEYS are present, HT_KEYS+1..2*HT_KEYS are not. A missing
+ * key that is found counts more than all present keys together, so the
+ * total is HT_KEYS only if every lookup was right. */
+static gpointer int_hash_probe(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    int_hash *h = data;
+    double *found = g_new0(double, 1);
+    unsigned int i;
+
+    for (i = start; i <= end; i++) {
+        guint32 key = int_mix(i), pos = key & h->mask;
+
+        while (h->slots[pos]) {
+            if (h->slots[pos] == key) {
+                *found += (i <= HT_KEYS) ? 1.0 : 2.0 * HT_KEYS;
+                break;
+            }
+            pos = (pos + 1) & h->mask;
+        }
+    }
+
+    return found;
+}
+
+static gpointer int_sort_fill(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    int_sort *s = data;
+    unsigned int i;
+
+    for (i = start; i <= end; i++)
+        s->keys[i] = int_mix(i ^ 0x5bd1e995U);
+
+    return NULL;
+}
+
+#define PART_START(s, p) ((guint)((guint64)(s)->n * (p) / (s)->n_parts))
+
+static gpointer int_sort_count(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    int_sort *s = data;
+    unsigned int p, i;
+
+    for (p = start; p <= end; p++) {
+        guint *count = s->count[p];
+        memset(count, 0, sizeof(s->count[p]));
+        for (i = PART_START(s, p); i < PART_START(s, p + 1); i++)
+            count[(s->keys[i] >> s->shift) & (RADIX - 1)]++;
+    }
+
+    return NULL;
+}
+
+static gpointer int_sort_scatter(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    int_sort *s = data;
+    unsigned int p, i;
+
+    for (p = start; p <= end; p++) {
+        guint *offset = s->count[p];
+        for (i = PART_START(s, p); i < PART_START(s, p + 1); i++) {
+            guint32 k = s->keys[i];
+            s->tmp[offset[(k >> s->shift) & (RADIX - 1)]++] = k;
+        }
+    }
+
+    return NULL;
+}
+
+static void int_sort_checksum(const guint32 *keys, guint n, guint64 *sum, guint32 *xor) {
+    guint i;
+
+    *sum = 0;
+    *xor = 0;
+    for (i = 0; i < n; i++) {
+        *sum += keys[i];
+        *xor ^= keys[i];
+    }
+}
+
+/* one stable LSD radix sort of s->keys, in the seconds it took */
+static double int_sort_run(int_sort *s) {
+    bench_value t;
+    double sort_time = 0;
+    guint d, part;
+
+    /* one part per thread; each pass counts digits per part, turns the
+     * counts into output offsets, then scatters each part in order so
+     * the sort is stable */
+    for (s->shift = 0; s->shift < 32; s->shift += RADIX_BITS) {
+        guint32 *swap;
+        guint total = 0;
+
+        t = benchmark_parallel_for(s->n_parts, 0, s->n_parts, int_sort_count, s);
+        sort_time += t.elapsed_time;
+
+        for (d = 0; d < RADIX; d++) {
+            for (part = 0; part < s->n_parts; part++) {
+                guint c = s->count[part][d];
+                s->count[part][d] = total;
+                total += c;
+            }
+        }
+
+        t = benchmark_parallel_for(s->n_parts, 0, s->n_parts, int_sort_scatter, s);
+        sort_time += t.elapsed_time;
+
+        swap = s->keys;
+        s->keys = s->tmp;
+        s->tmp = swap;
+    }
+
+    return sort_time;
+}
+
+/* fills the keys, sorts them and checks the order and checksums */
+static gboolean int_sort_round(int_sort *s, double *sort_time) {
+    guint64 sum_before, sum_after;
+    guint32 xor_before, xor_after;
+    guint i;
+
+    benchmark_parallel_for(0, 0, s->n, int_sort_fill, s);
+    int_sort_checksum(s->keys, s->n, &sum_before, &xor_before);
+
+    *sort_time += int_sort_run(s);
+
+    for (i = 1; i < s->n; i++) {
+        if (s->keys[i - 1] > s->keys[i]) {
+            DEBUG("sort: keys %u and %u out of order", i - 1, i);
+            return FALSE;
+        }
+    }
+    int_sort_checksum(s->keys, s->n, &sum_after, &xor_after);
+    if (sum_after != sum_before || xor_after != xor_before) {
+        DEBUG("sort: checksum mismatch");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* MemAvailable from /proc/meminfo, in bytes */
+static guint64 int_mem_available(void) {
+    gchar *meminfo, *p;
+    guint64 kiB = 0;
+
+    if (g_file_get_contents("/proc/meminfo", &meminfo, NULL, NULL)) {
+        if ((p = strstr(meminfo, "MemAvailable:")))
+            sscanf(p, "MemAvailable: %" G_GUINT64_FORMAT, &kiB);
+        g_free(meminfo);
+    }
+    return kiB * 1024;
+}
+
+void
+benchmark_intsort(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE, t;
+    int_hash h;
+    int_sort s;
+    guint64 avail;
+    guint capacity, rounds;
+    double target, elapsed = 0, found, ops = 0;
+    double insert_time = 0, probe_time = 0, sort_time = 0;
+    gboolean valid = TRUE;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running integer hash table and sort benchmark...");
+
+    target = benchmark_time(INTSORT_TIME) / 2;
+
+    /* an empty result, not the last one, if memory runs out */
+    bench_results[BENCHMARK_INTSORT] = r;
+
+    /* hash table: twice as many slots as keys */
+    for (capacity = 1; capacity < 2 * HT_KEYS; capacity <<= 1);
+    h.mask = capacity - 1;
+    h.slots = g_try_malloc0((gsize)capacity * sizeof(guint32));
+    if (!h.slots)
+        return;
+
+    for (rounds = 0; valid && (rounds == 0 || insert_time + probe_time < target); rounds++) {
+        if (rounds)
+            memset(h.slots, 0, (gsize)capacity * sizeof(guint32));
+
+        t = benchmark_parallel_for(0, 1, HT_KEYS + 1, int_hash_insert, &h);
+        r.threads_used = t.threads_used;
+        insert_time += t.elapsed_time;
+
+        t = benchmark_parallel_for(0, 1, 2 * HT_KEYS + 1, int_hash_probe, &h);
+        probe_time += t.elapsed_time;
+        found = t.result;
+        if (found != HT_KEYS) {
+            DEBUG("hash table: found %.0f keys, expected %d", found, HT_KEYS);
+            valid = FALSE;
+        }
+    }
+    g_free(h.slots);
+
+    elapsed += insert_time + probe_time;
+    ops += 3.0 * HT_KEYS * rounds;
+    if (insert_time > 0 && probe_time > 0) {
+        bench_value_add_extra(&r, "Hash Insert", "%.1f Mops/s", (double)HT_KEYS * rounds / insert_time / 1e6);
+        bench_value_add_extra(&r, "Hash Lookup", "%.1f Mops/s", 2.0 * HT_KEYS * rounds / probe_time / 1e6);
+    }
+    bench_value_add_extra(&r, "Hash Rounds", "%u", rounds);
+
+    /* sort: up to SORT_KEYS, but no more than a quarter of the
+     * available memory for keys and scratch space together */
+    avail = int_mem_available();
+    s.n = SORT_KEYS;
+    if (avail && s.n > avail / 4 / (2 * sizeof(guint32)))
+        s.n = MAX(avail / 4 / (2 * sizeof(guint32)), SORT_MIN);
+    s.keys = g_try_malloc((gsize)s.n * sizeof(guint32));
+    s.tmp = g_try_malloc((gsize)s.n * sizeof(guint32));
+    if (!s.keys || !s.tmp) {
+        g_free(s.keys);
+        g_free(s.tmp);
+        return;
+    }
+
+    s.n_parts = MAX(r.threads_used, 1);
+    s.count = g_malloc(s.n_parts * sizeof(*s.count));
+    for (rounds = 0; valid && (rounds == 0 || sort_time < target); rounds++)
+        valid = int_sort_round(&s, &sort_time);
+    elapsed += sort_time;
+    ops += (double)s.n * rounds;
+
+    /* keys read twice and written once per pass; no sort rounds if
+     * the hash table failed */
+    if (rounds && sort_time > 0)
+        bench_value_add_extra(&r, "Radix Sort", "%.1f Mkeys/s, %.2f GB/s",
+                              (double)s.n * rounds / sort_time / 1e6,
+                              3.0 * s.n * rounds * sizeof(guint32) * (32 / RADIX_BITS) / sort_time / 1e9);
+    bench_value_add_extra(&r, "Sort Keys", "%u", s.n);
+    bench_value_add_extra(&r, "Sort Rounds", "%u", rounds);
+
+    g_free(s.count);
+    g_free(s.keys);
+    g_free(s.tmp);
+
+    bench_value_add_extra(&r, "Validation", "%s", valid ? "passed" : "FAILED");
+
+    r.elapsed_time = elapsed;
+    r.result = valid ? ops / elapsed / 1e6 : 0;
+    bench_results[BENCHMARK_INTSORT] = r;
+}
@@ -10,6 +10,7 @@
 #include "benchmark.h"
 
 #define QUEENS 11
+#define NQ_TIME 5
 
 int row[QUEENS];
 
@@ -54,12 +55,14 @@ void
 benchmark_nqueens(void)
 {
     bench_value r = EMPTY_BENCH_VALUE;
+    guint size;
 
     shell_view_set_enabled(FALSE);
     shell_status_update("Running N-Queens benchmark...");
 
-    r = benchmark_parallel_for(0, 0, 10, nqueens_for, NULL);
-    r.result = r.elapsed_time;
+    /* seconds for 10 solutions, as results always were */
+    r = benchmark_parallel_for_time(0, benchmark_time(NQ_TIME), &size, nqueens_for, NULL);
+    r.result = benchmark_fixed_work_time(r, size, 10);
 
     bench_results[BENCHMARK_NQUEENS] = r;
 }
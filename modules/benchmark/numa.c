@@ -0,0 +1,530 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+#define NUMA_SYSFS     "/sys/devices/system/node"
+#define NUMA_MAX_NODES 64       /* one unsigned long of mbind() node mask */
+
+/* from <numaif.h>, so libnuma is not needed */
+#define NUMA_MPOL_BIND     2
+#define NUMA_MPOL_MF_MOVE  (1 << 1)
+
+typedef struct {
+    gint id;                    /* as in nodeN */
+    cpu_set_t cpus;             /* the ones this process may run on */
+    gint n_cpus;
+    gboolean memory;
+    gint distance[NUMA_MAX_NODES];
+} numa_node;
+
+static numa_node numa_nodes[NUMA_MAX_NODES];
+static gint numa_n_nodes;
+
+/* "0-3,8-11" -> set */
+static void numa_parse_cpulist(const gchar *list, cpu_set_t *set) {
+    gchar **ranges;
+    gint i, first, last;
+
+    CPU_ZERO(set);
+    if (!list)
+        return;
+    ranges = g_strsplit(list, ",", -1);
+    for (i = 0; ranges[i]; i++) {
+        gint n = sscanf(ranges[i], "%d-%d", &first, &last);
+        if (n < 1)
+            continue;
+        if (n == 1)
+            last = first;
+        for (; first <= last && first < CPU_SETSIZE; first++)
+            CPU_SET(first, set);
+    }
+    g_strfreev(ranges);
+}
+
+static gint numa_cmp_id(gconstpointer a, gconstpointer b) {
+    return ((const numa_node *)a)->id - ((const numa_node *)b)->id;
+}
+
+static void numa_load(void) {
+    cpu_set_t allowed, memory;
+    gchar *tmp, *has_memory, **distances;
+    const gchar *name;
+    GDir *dir;
+    gint i, j, id;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        CPU_ZERO(&allowed);
+
+    /* node ids, not CPUs, but the list has the same format */
+    has_memory = h_sysfs_read_string(NUMA_SYSFS, "has_memory");
+    numa_parse_cpulist(has_memory, &memory);
+
+    dir = g_dir_open(NUMA_SYSFS, 0, NULL);
+    while (dir && (name = g_dir_read_name(dir)) && numa_n_nodes < NUMA_MAX_NODES) {
+        numa_node *n;
+        gchar *path;
+
+        if (sscanf(name, "node%d", &id) != 1)
+            continue;
+
+        n = &numa_nodes[numa_n_nodes++];
+        n->id = id;
+        n->memory = has_memory ? CPU_ISSET(id, &memory) : TRUE;
+
+        path = g_build_filename(NUMA_SYSFS, name, NULL);
+        tmp = h_sysfs_read_string(path, "cpulist");
+        numa_parse_cpulist(tmp, &n->cpus);
+        CPU_AND(&n->cpus, &n->cpus, &allowed);
+        n->n_cpus = CPU_COUNT(&n->cpus);
+        g_free(tmp);
+
+        /* distances are in order of node id */
+        tmp = h_sysfs_read_string(path, "distance");
+        distances = g_strsplit(tmp ? tmp : "", " ", -1);
+        for (i = 0; distances[i] && i < NUMA_MAX_NODES; i++)
+            n->distance[i] = atoi(distances[i]);
+        g_strfreev(distances);
+        g_free(tmp);
+        g_free(path);
+    }
+    if (dir)
+        g_dir_close(dir);
+    g_free(has_memory);
+
+    if (!numa_n_nodes) {
+        /* no NUMA support in the kernel: one node with everything */
+        numa_n_nodes = 1;
+        numa_nodes[0].id = 0;
+        numa_nodes[0].cpus = allowed;
+        numa_nodes[0].n_cpus = CPU_COUNT(&allowed);
+        numa_nodes[0].memory = TRUE;
+        numa_nodes[0].distance[0] = 10;
+    }
+
+    qsort(numa_nodes, numa_n_nodes, sizeof(numa_node), numa_cmp_id);
+    for (i = 0; i < numa_n_nodes; i++)
+        for (j = 0; j < numa_n_nodes; j++)
+            if (!numa_nodes[i].distance[j])
+                numa_nodes[i].distance[j] = i == j ? 10 : 20;
+
+    DEBUG("%d NUMA nodes", numa_n_nodes);
+}
+
+static void numa_init(void) {
+    static gsize loaded = 0;
+
+    if (g_once_init_enter(&loaded)) {
+        numa_load();
+        g_once_init_leave(&loaded, 1);
+    }
+}
+
+gint benchmark_numa_nodes(void) {
+    numa_init();
+    return numa_n_nodes;
+}
+
+gint benchmark_numa_node_id(gint node) {
+    numa_init();
+    return numa_nodes[node].id;
+}
+
+gint benchmark_numa_node_cpus(gint node) {
+    numa_init();
+    return numa_nodes[node].n_cpus;
+}
+
+gboolean benchmark_numa_node_has_memory(gint node) {
+    numa_init();
+    return numa_nodes[node].memory;
+}
+
+gint benchmark_numa_distance(gint from, gint to) {
+    numa_init();
+    return numa_nodes[from].distance[to];
+}
+
+gboolean benchmark_numa_pin(gint node) {
+    numa_init();
+    if (!numa_nodes[node].n_cpus)
+        return FALSE;
+    return sched_setaffinity(0, sizeof(cpu_set_t), &numa_nodes[node].cpus) == 0;
+}
+
+static gboolean numa_bind(gpointer p, gsize size, gint node) {
+#ifdef SYS_mbind
+    unsigned long mask;
+
+    if (numa_nodes[node].id >= NUMA_MAX_NODES)
+        return FALSE;
+    mask = 1UL << numa_nodes[node].id;
+    return syscall(SYS_mbind, p, size, NUMA_MPOL_BIND, &mask,
+                   NUMA_MAX_NODES + 1, NUMA_MPOL_MF_MOVE) == 0;
+#else
+    return FALSE;
+#endif
+}
+
+gpointer benchmark_numa_alloc(gsize size, gint node) {
+    gpointer p;
+
+    numa_init();
+
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+
+    if (numa_n_nodes > 1 && !numa_bind(p, size, node)) {
+        /* no mbind(): pages go where they are first touched */
+        cpu_set_t saved;
+
+        DEBUG("mbind() to node %d failed; using first touch", numa_nodes[node].id);
+        if (sched_getaffinity(0, sizeof(saved), &saved) == 0 && benchmark_numa_pin(node)) {
+            memset(p, 0, size);
+            sched_setaffinity(0, sizeof(saved), &saved);
+        }
+    }
+    memset(p, 0, size);
+
+    return p;
+}
+
+void benchmark_numa_free(gpointer p, gsize size) {
+    if (p)
+        munmap(p, size);
+}
+
+/* Memory latency and bandwidth between every pair of NUMA nodes: a
+ * dependent pointer chase through at least NM_LAT_SET bytes in random
+ * order from one thread, and sequential reads of at least NM_BW_SET
+ * bytes per thread from up to NM_BW_THREADS threads. Both working sets
+ * are made four times the last-level cache if that is larger, and the
+ * profile's NM_TIME seconds are shared out between the measurements.
+ * Threads are pinned to the CPU node's CPUs and the memory is bound to
+ * the memory node, so the diagonal is local access and the rest is the
+ * cross-node penalty, shown next to the firmware's SLIT distances.
+ * The whole matrix is saved as a table next to the result store. The
+ * result is the mean local bandwidth of a node, in MiB/second; a
+ * machine without NUMA is one node. */
+#define NM_TIME        4        /* seconds for all the measurements */
+#define NM_MIN_TIME    0.05     /* seconds per measurement, at least */
+#define NM_LAT_SET     (64 << 20)
+#define NM_BW_SET      (32 << 20)
+#define NM_BW_THREADS  8
+#define NM_LINE        64
+#define NM_CHASE_BATCH 4096
+#define NM_ROW_NODES   4        /* above this, extra gets a local/remote summary, not a row */
+
+typedef struct {
+    gint cpu_node;
+    gpointer chain;             /* lat_set bytes, a cycle of lines */
+    guint64 **sets;             /* bw_set bytes per thread */
+    gsize lat_set, bw_set;
+    double seconds;
+} nm_test;
+
+static volatile guint64 nm_sink;
+
+/* one random cycle through all the lines (Sattolo), so the chase
+ * visits every line before repeating and prefetchers can't follow */
+static void nm_build_chain(gpointer chain, gsize size) {
+    gsize n = size / NM_LINE, i, j, *order;
+    GRand *rand = g_rand_new_with_seed(0x4e554d41);
+
+    order = g_new(gsize, n);
+    for (i = 0; i < n; i++)
+        order[i] = i;
+    for (i = n - 1; i > 0; i--) {
+        gsize t;
+        j = g_rand_int_range(rand, 0, i);
+        t = order[i]; order[i] = order[j]; order[j] = t;
+    }
+    for (i = 0; i < n; i++)
+        *(gpointer *)((gchar *)chain + order[i] * NM_LINE) =
+            (gchar *)chain + order[(i + 1) % n] * NM_LINE;
+
+    g_free(order);
+    g_rand_free(rand);
+}
+
+/* nanoseconds per load */
+static gpointer nm_latency(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    nm_test *t = data;
+    double *ns = g_new0(double, 1);
+    gpointer p = t->chain;
+    guint64 loads = 0;
+    GTimer *timer = g_timer_new();
+    gint i;
+
+    benchmark_numa_pin(t->cpu_node);
+
+    g_timer_start(timer);
+    do {
+        for (i = 0; i < NM_CHASE_BATCH; i++)
+            p = *(gpointer *)p;
+        loads += NM_CHASE_BATCH;
+    } while (g_timer_elapsed(timer, NULL) < t->seconds);
+    *ns = g_timer_elapsed(timer, NULL) * 1e9 / loads;
+    g_timer_destroy(timer);
+
+    nm_sink = (guintptr)p;
+    return ns;
+}
+
+/* MiB/s read by this thread */
+static gpointer nm_bandwidth(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    nm_test *t = data;
+    double *mibs = g_new0(double, 1);
+    const guint64 *set = t->sets[thread_number];
+    guint64 sum = 0, bytes = 0;
+    GTimer *timer = g_timer_new();
+    gsize i;
+
+    benchmark_numa_pin(t->cpu_node);
+
+    g_timer_start(timer);
+    do {
+        for (i = 0; i < t->bw_set / sizeof(guint64); i += 4)
+            sum += set[i] + set[i + 1] + set[i + 2] + set[i + 3];
+        bytes += t->bw_set;
+    } while (g_timer_elapsed(timer, NULL) < t->seconds);
+    *mibs = bytes / g_timer_elapsed(timer, NULL) / (1 << 20);
+    g_timer_destroy(timer);
+
+    nm_sink = sum;
+    return mibs;
+}
+
+/* bytes of the last-level cache, 0 if unknown */
+static gsize nm_llc_size(void) {
+    long size = 0;
+
+#ifdef _SC_LEVEL4_CACHE_SIZE
+    size = sysconf(_SC_LEVEL4_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    if (size <= 0)
+        size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    if (size <= 0)
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+
+    return size > 0 ? size : 0;
+}
+
+/* the nodes' values as "a/b/c" */
+static gchar *nm_row(const double *values, gint n, const gchar *fmt) {
+    GString *row = g_string_new(NULL);
+    gint i;
+
+    for (i = 0; i < n; i++) {
+        if (i)
+            g_string_append_c(row, '/');
+        if (values[i] < 0)
+            g_string_append_c(row, '-');
+        else
+            g_string_append_printf(row, fmt, values[i]);
+    }
+    return g_string_free(row, FALSE);
+}
+
+void
+benchmark_numa(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    gint nodes = benchmark_numa_nodes(), n_threads = 0, n_pairs, i, j, k;
+    gsize llc = nm_llc_size();
+    double *latency, *bandwidth, local_bw = 0;
+    double lat_ratio = 0, bw_ratio = 0, slit_ratio = 0;
+    gint n_local = 0, n_remote = 0;
+    nm_test t;
+    GString *csv;
+    GTimer *timer = g_timer_new();
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running NUMA memory benchmark...");
+
+    latency = g_new(double, nodes * nodes);
+    bandwidth = g_new(double, nodes * nodes);
+    for (i = 0; i < nodes * nodes; i++)
+        latency[i] = bandwidth[i] = -1.0;
+
+    for (i = 0; i < nodes; i++)
+        n_threads = MAX(n_threads, MIN(benchmark_numa_node_cpus(i), NM_BW_THREADS));
+
+    n_pairs = 0;
+    for (i = 0; i < nodes; i++)
+        for (j = 0; j < nodes; j++)
+            if (benchmark_numa_node_cpus(i) && benchmark_numa_node_has_memory(j))
+                n_pairs++;
+
+    memset(&t, 0, sizeof(t));
+    t.seconds = MAX(benchmark_time(NM_TIME) / MAX(2 * n_pairs, 1), NM_MIN_TIME);
+    t.sets = g_new0(guint64 *, MAX(n_threads, 1));
+    /* in whole multiples of the minimum, so the sets stay line-aligned */
+    t.lat_set = MAX(NM_LAT_SET, (llc * 4 + NM_LAT_SET - 1) / NM_LAT_SET * NM_LAT_SET);
+    t.bw_set = (llc * 4 / MAX(n_threads, 1) + NM_BW_SET - 1) / NM_BW_SET * NM_BW_SET;
+    t.bw_set = MAX(NM_BW_SET, t.bw_set);
+
+    g_timer_start(timer);
+
+    /* memory node j, as seen from CPU node i */
+    for (j = 0; j < nodes; j++) {
+        if (!benchmark_numa_node_has_memory(j))
+            continue;
+
+        t.chain = benchmark_numa_alloc(t.lat_set, j);
+        if (!t.chain)
+            goto next;
+        for (k = 0; k < n_threads; k++) {
+            t.sets[k] = benchmark_numa_alloc(t.bw_set, j);
+            if (!t.sets[k])
+                goto next;
+        }
+        nm_build_chain(t.chain, t.lat_set);
+
+        for (i = 0; i < nodes; i++) {
+            bench_value b;
+            gint threads = MIN(benchmark_numa_node_cpus(i), NM_BW_THREADS);
+
+            if (!threads)
+                continue;
+            t.cpu_node = i;
+
+            b = benchmark_parallel(1, nm_latency, &t);
+            latency[i * nodes + j] = b.result;
+            b = benchmark_parallel(threads, nm_bandwidth, &t);
+            bandwidth[i * nodes + j] = b.result;
+            r.threads_used = MAX(r.threads_used, b.threads_used);
+        }
+
+next:
+        benchmark_numa_free(t.chain, t.lat_set);
+        for (k = 0; k < n_threads; k++) {
+            benchmark_numa_free(t.sets[k], t.bw_set);
+            t.sets[k] = NULL;
+        }
+    }
+
+    /* remote against local, for the pairs measured both ways */
+    for (i = 0; i < nodes; i++) {
+        double local_lat = latency[i * nodes + i], local = bandwidth[i * nodes + i];
+
+        if (local <= 0)
+            continue;
+        local_bw += local;
+        n_local++;
+
+        for (j = 0; j < nodes; j++) {
+            if (j == i || bandwidth[i * nodes + j] <= 0)
+                continue;
+            lat_ratio += latency[i * nodes + j] / local_lat;
+            bw_ratio += bandwidth[i * nodes + j] / local;
+            slit_ratio += (double)benchmark_numa_distance(i, j) / benchmark_numa_distance(i, i);
+            n_remote++;
+        }
+    }
+
+    bench_value_add_extra(&r, "Nodes", "%d", nodes);
+    bench_value_add_extra(&r, "Working Sets", "%" G_GSIZE_FORMAT " MiB chase, %" G_GSIZE_FORMAT " MiB per thread",
+                          t.lat_set >> 20, t.bw_set >> 20);
+    for (i = 0; i < nodes; i++) {
+        gchar *slit, *lat, *bw, *key;
+        double distances[NUMA_MAX_NODES];
+
+        if (!benchmark_numa_node_cpus(i))
+            continue;
+        key = g_strdup_printf("Node %d", benchmark_numa_node_id(i));
+
+        if (nodes > NM_ROW_NODES) {
+            /* whole rows of a large matrix won't fit in extra; they
+             * are in the table */
+            double remote_lat = 0, remote_bw = 0;
+            gint remote = 0;
+
+            for (j = 0; j < nodes; j++) {
+                if (j == i || bandwidth[i * nodes + j] <= 0)
+                    continue;
+                remote_lat += latency[i * nodes + j];
+                remote_bw += bandwidth[i * nodes + j];
+                remote++;
+            }
+            bench_value_add_extra(&r, key, "local %.0f ns %.0f MiB/s, remote %.0f ns %.0f MiB/s",
+                                  latency[i * nodes + i], bandwidth[i * nodes + i],
+                                  remote ? remote_lat / remote : -1, remote ? remote_bw / remote : -1);
+            g_free(key);
+            continue;
+        }
+
+        for (j = 0; j < nodes; j++)
+            distances[j] = benchmark_numa_node_has_memory(j) ? benchmark_numa_distance(i, j) : -1;
+
+        slit = nm_row(distances, nodes, "%.0f");
+        lat = nm_row(latency + i * nodes, nodes, "%.0f");
+        bw = nm_row(bandwidth + i * nodes, nodes, "%.0f");
+        bench_value_add_extra(&r, key, "SLIT %s, %s ns, %s MiB/s", slit, lat, bw);
+        g_free(key);
+        g_free(slit);
+        g_free(lat);
+        g_free(bw);
+    }
+    if (n_remote)
+        bench_value_add_extra(&r, "Remote Penalty", "latency x%.2f, bandwidth x%.2f, SLIT x%.2f",
+                              lat_ratio / n_remote, bw_ratio / n_remote, slit_ratio / n_remote);
+
+    csv = g_string_new("cpu_node,memory_node,slit,latency_ns,bandwidth_mib_s\n");
+    for (i = 0; i < nodes; i++) {
+        for (j = 0; j < nodes; j++) {
+            if (!benchmark_numa_node_cpus(i) || bandwidth[i * nodes + j] <= 0)
+                continue;
+            g_string_append_printf(csv, "%d,%d,%d,%.1f,%.1f\n",
+                                   benchmark_numa_node_id(i), benchmark_numa_node_id(j),
+                                   benchmark_numa_distance(i, j),
+                                   latency[i * nodes + j], bandwidth[i * nodes + j]);
+        }
+    }
+    bench_value_add_table(&r, "numa", csv->str);
+    g_string_free(csv, TRUE);
+
+    g_timer_stop(timer);
+    r.elapsed_time = g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+
+    if (n_local)
+        r.result = local_bw / n_local;
+
+    g_free(t.sets);
+    g_free(latency);
+    g_free(bandwidth);
+
+    bench_results[BENCHMARK_NUMA] = r;
+}
@@ -0,0 +1,318 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "benchmark.h"
+
+/* Virtual memory: first-touch page faults on 4 KiB pages, transparent
+ * huge pages and hugetlbfs pages, mmap()/munmap() churn and
+ * madvise(MADV_DONTNEED), each for PF_TIME seconds with one thread and
+ * again with all threads. The result is thousands of 4 KiB first-touch
+ * faults per second with all threads; the other rates and the huge page
+ * configuration from sysfs are kept with the result as details. */
+#define PF_TIME 1
+
+#define PF_REGION       (8 << 20)   /* first touch, per thread and call */
+#define PF_THP_REGION   (16 << 20)
+#define PF_THP_ALIGN    (2 << 20)
+#define PF_CHURN_REGION (64 << 10)
+#define PF_MADV_REGION  (1 << 20)
+#define PF_HUGETLB_MAX  8           /* pages */
+
+typedef struct {
+    gsize size, stride, align;
+    gint  flags;                    /* extra mmap() flags */
+    gint  advice;                   /* madvise() after mapping, or 0 */
+    gchar **regions;                /* per-thread, for the madvise test */
+    volatile gint failed;
+} pf_test;
+
+static gsize pf_page_size;
+
+static void pf_touch(gchar *p, gsize size, gsize stride) {
+    gsize i;
+    for (i = 0; i < size; i += stride)
+        p[i] = 1;
+}
+
+/* a mapping of size aligned to align, so THP can back all of it */
+static gchar *pf_map(gsize size, gsize align, gint flags) {
+    gchar *p, *aligned;
+    gsize head;
+
+    p = mmap(NULL, size + align, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+    if (!align)
+        return p;
+
+    aligned = (gchar *)(((guintptr)p + align - 1) & ~(guintptr)(align - 1));
+    head = aligned - p;
+    if (head)
+        munmap(p, head);
+    munmap(aligned + size, align - head);
+    return aligned;
+}
+
+static gpointer pf_first_touch(void *data, gint thread_number) {
+    pf_test *t = data;
+    gchar *p;
+
+    p = pf_map(t->size, t->align, t->flags);
+    if (!p) {
+        t->failed = 1;
+        return NULL;
+    }
+    if (t->advice)
+        madvise(p, t->size, t->advice);
+    pf_touch(p, t->size, t->stride);
+    munmap(p, t->size);
+
+    return NULL;
+}
+
+static gpointer pf_churn(void *data, gint thread_number) {
+    pf_test *t = data;
+    gchar *p;
+
+    p = mmap(NULL, t->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        t->failed = 1;
+        return NULL;
+    }
+    p[0] = 1;
+    munmap(p, t->size);
+
+    return NULL;
+}
+
+static gpointer pf_madvise(void *data, gint thread_number) {
+    pf_test *t = data;
+    gchar *p = t->regions[thread_number];
+
+    madvise(p, t->size, MADV_DONTNEED);
+    pf_touch(p, t->size, t->stride);
+
+    return NULL;
+}
+
+static glong pf_minor_faults(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt;
+}
+
+/* calls per second, or -1 if the test could not run; *faults_per_s, if
+ * given, is measured by the kernel rather than assumed */
+static double pf_run(gpointer callback, pf_test *t, gint n_threads,
+                     gint *threads_used, double *faults_per_s) {
+    bench_value r;
+    glong faults;
+
+    t->failed = 0;
+    faults = pf_minor_faults();
+    r = benchmark_crunch_for(benchmark_time(PF_TIME), n_threads, callback, t);
+    faults = pf_minor_faults() - faults;
+
+    if (threads_used)
+        *threads_used = r.threads_used;
+    if (t->failed || r.result <= 0 || r.elapsed_time <= 0)
+        return -1.0;
+    if (faults_per_s)
+        *faults_per_s = faults / r.elapsed_time;
+    return r.result / r.elapsed_time;
+}
+
+/* key for a rate with n_threads: "key (1 thread)", or just "key" for all */
+static gchar *pf_key(const gchar *key, gint n_threads) {
+    return n_threads == 1 ? g_strdup_printf("%s (1 thread)", key) : g_strdup(key);
+}
+
+/* "always [madvise] never" -> "madvise" */
+static gchar *pf_sysfs_choice(const gchar *entry) {
+    gchar *str = h_sysfs_read_string("/sys/kernel/mm/transparent_hugepage", entry);
+    gchar *start, *end, *ret;
+
+    if (!str)
+        return g_strdup(_("(Unknown)"));
+    start = strchr(str, '[');
+    end = start ? strchr(start, ']') : NULL;
+    if (!start || !end) {
+        g_free(str);
+        return g_strdup(_("(Unknown)"));
+    }
+    ret = g_strndup(start + 1, end - start - 1);
+    g_free(str);
+    return ret;
+}
+
+/* HugePages_Free and Hugepagesize (kiB) from /proc/meminfo */
+static void pf_hugetlb_config(gint *free_pages, gint *page_kiB) {
+    gchar *meminfo, **lines;
+    gint i;
+
+    *free_pages = *page_kiB = 0;
+    if (!g_file_get_contents("/proc/meminfo", &meminfo, NULL, NULL))
+        return;
+
+    lines = g_strsplit(meminfo, "\n", -1);
+    for (i = 0; lines[i]; i++) {
+        sscanf(lines[i], "HugePages_Free: %d", free_pages);
+        sscanf(lines[i], "Hugepagesize: %d", page_kiB);
+    }
+    g_strfreev(lines);
+    g_free(meminfo);
+}
+
+void
+benchmark_pagefault(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    pf_test t;
+    gchar *thp_enabled, *thp_defrag;
+    gint hp_free, hp_kiB, threads = 0, mode, i;
+    double rate, faults;
+    gsize hp_faults;
+    GTimer *timer = g_timer_new();
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running page fault benchmark...");
+
+    pf_page_size = sysconf(_SC_PAGESIZE);
+    g_timer_start(timer);
+
+    thp_enabled = pf_sysfs_choice("enabled");
+    thp_defrag = pf_sysfs_choice("defrag");
+    pf_hugetlb_config(&hp_free, &hp_kiB);
+
+    bench_value_add_extra(&r, "THP", "%s", thp_enabled);
+    bench_value_add_extra(&r, "THP Defrag", "%s", thp_defrag);
+    bench_value_add_extra(&r, "Free Huge Pages", "%d x %d kiB", hp_free, hp_kiB);
+
+    /* 4 KiB first touch; THP is turned off for the mapping */
+    memset(&t, 0, sizeof(t));
+    t.size = PF_REGION;
+    t.stride = pf_page_size;
+#ifdef MADV_NOHUGEPAGE
+    t.advice = MADV_NOHUGEPAGE;
+#endif
+    rate = pf_run(pf_first_touch, &t, 1, NULL, NULL);
+    if (rate > 0)
+        bench_value_add_extra(&r, "4K Faults (1 thread)", "%.0f/s", rate * (PF_REGION / pf_page_size));
+
+    rate = pf_run(pf_first_touch, &t, 0, &threads, NULL);
+    if (rate > 0) {
+        r.result = rate * (PF_REGION / pf_page_size) / 1000.0;
+        bench_value_add_extra(&r, "4K Faults", "%.0f/s", r.result * 1000.0);
+    }
+    r.threads_used = threads;
+    threads = MAX(threads, 1);
+
+    /* the other variants, with one thread and then with as many as the
+     * 4 KiB test used, if that is more than one */
+    for (mode = 0; mode < (threads > 1 ? 2 : 1); mode++) {
+        gint n = mode ? threads : 1;
+        gchar *key;
+
+#ifdef MADV_HUGEPAGE
+        /* transparent huge pages; touch every small page so the same
+         * amount of memory is populated either way */
+        memset(&t, 0, sizeof(t));
+        t.size = PF_THP_REGION;
+        t.stride = pf_page_size;
+        t.align = PF_THP_ALIGN;
+        t.advice = MADV_HUGEPAGE;
+        rate = pf_run(pf_first_touch, &t, n, NULL, &faults);
+        if (rate > 0) {
+            key = pf_key("THP First Touch", n);
+            bench_value_add_extra(&r, key, "%.0f MiB/s, %.0f faults/s",
+                                  rate * (PF_THP_REGION >> 20), faults);
+            g_free(key);
+        }
+#endif
+
+#ifdef MAP_HUGETLB
+        /* explicit huge pages, only if some are reserved; the reserved
+         * pages are shared out, with at most one thread per page */
+        if (hp_free > 0 && hp_kiB > 0 && (!mode || MIN(n, hp_free) > 1)) {
+            gint hp_threads = MIN(n, hp_free);
+
+            memset(&t, 0, sizeof(t));
+            t.stride = (gsize)hp_kiB * 1024;
+            t.size = (gsize)MIN(hp_free / hp_threads, PF_HUGETLB_MAX) * t.stride;
+            t.flags = MAP_HUGETLB;
+            hp_faults = t.size / t.stride;
+            rate = pf_run(pf_first_touch, &t, hp_threads, NULL, NULL);
+            if (rate > 0) {
+                key = pf_key("HugeTLB Faults", hp_threads);
+                bench_value_add_extra(&r, key, "%.0f/s", rate * hp_faults);
+                g_free(key);
+            }
+        }
+#endif
+
+        /* mmap()/munmap() of a small region, touching one page */
+        memset(&t, 0, sizeof(t));
+        t.size = PF_CHURN_REGION;
+        rate = pf_run(pf_churn, &t, n, NULL, NULL);
+        if (rate > 0) {
+            key = pf_key("mmap+munmap", n);
+            bench_value_add_extra(&r, key, "%.0f/s", rate);
+            g_free(key);
+        }
+
+        /* madvise(MADV_DONTNEED) of a populated region and faulting it
+         * back, one region per thread */
+        t.size = PF_MADV_REGION;
+        t.stride = pf_page_size;
+        t.regions = g_new0(gchar *, n);
+        for (i = 0; i < n; i++) {
+            t.regions[i] = pf_map(t.size, 0, 0);
+            if (!t.regions[i])
+                break;
+            pf_touch(t.regions[i], t.size, t.stride);
+        }
+        if (i == n) {
+            rate = pf_run(pf_madvise, &t, n, NULL, NULL);
+            if (rate > 0) {
+                key = pf_key("madvise DONTNEED 1 MiB", n);
+                bench_value_add_extra(&r, key, "%.0f/s", rate);
+                g_free(key);
+            }
+        }
+        while (i-- > 0)
+            munmap(t.regions[i], t.size);
+        g_free(t.regions);
+    }
+
+    g_free(thp_enabled);
+    g_free(thp_defrag);
+
+    g_timer_stop(timer);
+    r.elapsed_time = g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+
+    bench_results[BENCHMARK_PAGEFAULT] = r;
+}
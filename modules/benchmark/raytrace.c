@@ -20,6 +20,8 @@
 
 void fbench();	/* fbench.c */
 
+#define RAYTRACE_TIME 5
+
 static gpointer
 parallel_raytrace(unsigned int start, unsigned int end, gpointer data, gint thread_number)
 {
@@ -36,12 +38,14 @@ void
 benchmark_raytrace(void)
 {
     bench_value r = EMPTY_BENCH_VALUE;
+    guint size;
 
     shell_view_set_enabled(FALSE);
     shell_status_update("Performing John Walker's FBENCH...");
 
-    r = benchmark_parallel_for(0, 0, 1000, parallel_raytrace, NULL);
-    r.result = r.elapsed_time;
+    /* seconds for 1000 runs, as results always were */
+    r = benchmark_parallel_for_time(0, benchmark_time(RAYTRACE_TIME), &size, parallel_raytrace, NULL);
+    r.result = benchmark_fixed_work_time(r, size, 1000);
 
     bench_results[BENCHMARK_RAYTRACE] = r;
 }
@@ -0,0 +1,637 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Ray tracing with no shared mutable state: a fixed procedural scene of
+ * spheres on a checkered floor, lit by one point light with shadows and
+ * one bounce of reflection, rendered in 16x16 tiles that threads take
+ * from a shared counter as they finish. The spheres are in a bounding
+ * volume hierarchy. Primary rays are traced four at a time (2x2 pixels)
+ * with GCC vector extensions where the CPU has 128-bit SIMD, otherwise
+ * one at a time; both paths do the same float operations in the same
+ * order (this file is built with -ffp-contract=off), so they render the
+ * same image. The result is millions of rays per second; 0 if the
+ * rendered frames do not match the reference checksum or the two paths
+ * disagree. The frames are rendered again, each time checked, until the
+ * run takes the profile's time. */
+#define RT_TIME      5           /* seconds */
+#define RT_WIDTH     1024
+#define RT_HEIGHT    768
+#define RT_FRAMES    8
+#define RT_TILE      16
+#define RT_GRID      32          /* RT_GRID^2 spheres */
+#define RT_LEAF      4
+#define RT_MAX_DEPTH 2
+#define RT_EPS       1e-3f
+#define RT_FAR       1e30f
+
+/* FNV-1a of all frames, when floats are evaluated in their own
+ * precision (FLT_EVAL_METHOD 0, as on x86-64 and ARM) */
+#define RT_CHECKSUM  0xa8bdb8faU
+
+typedef float rt_v4 __attribute__((vector_size(16)));
+typedef int rt_v4i __attribute__((vector_size(16)));
+
+typedef struct {
+    float c[3], r, r2;
+    float color[3], refl;
+} rt_sphere;
+
+typedef struct {
+    float bmin[3], bmax[3];
+    gint first, count;      /* count 0: inner node, children at +1 and first */
+} rt_node;
+
+typedef struct {
+    rt_sphere *spheres;
+    gint n_spheres;
+    gint *prims;
+    rt_node *nodes;
+    gint n_nodes;
+    float light[3];
+} rt_scene;
+
+typedef struct {
+    float t;
+    gint sphere;            /* -1: floor, -2: nothing */
+} rt_hit;
+
+typedef struct {
+    const rt_scene *scene;
+    guchar *image;          /* RT_FRAMES frames of width x height RGB */
+    gint width, height;
+    gint tiles_x, tiles_per_frame, n_tiles;
+    volatile gint next_tile;
+    gboolean packets;
+} rt_job;
+
+static const float rt_eyes[RT_FRAMES][3] = {
+    {  0.0f, 3.0f, -14.0f }, {  9.0f, 4.0f, -10.0f },
+    { 14.0f, 2.5f,   0.0f }, {  9.0f, 5.0f,  10.0f },
+    {  0.0f, 3.0f,  14.0f }, { -9.0f, 4.0f,  10.0f },
+    {-14.0f, 2.5f,   0.0f }, { -9.0f, 6.0f, -10.0f },
+};
+
+static guint32 rt_rand_state;
+
+static float rt_rand(void) {
+    rt_rand_state = rt_rand_state * 1664525U + 1013904223U;
+    return (rt_rand_state >> 8) * (1.0f / 16777216.0f);
+}
+
+#define DOT(a, b) ((a)[0] * (b)[0] + (a)[1] * (b)[1] + (a)[2] * (b)[2])
+
+static void rt_normalize(float *v) {
+    float l = sqrtf(DOT(v, v));
+    v[0] /= l;
+    v[1] /= l;
+    v[2] /= l;
+}
+
+static gint rt_centroid_axis;
+
+static gint rt_cmp_centroid(gconstpointer a, gconstpointer b, gpointer data) {
+    const rt_sphere *s = data;
+    float ca = s[*(const gint *)a].c[rt_centroid_axis];
+    float cb = s[*(const gint *)b].c[rt_centroid_axis];
+    if (ca != cb)
+        return (ca > cb) - (ca < cb);
+    return *(const gint *)a - *(const gint *)b;
+}
+
+static gint rt_build(rt_scene *sc, gint first, gint count) {
+    gint n = sc->n_nodes++, i, k;
+    rt_node *node = &sc->nodes[n];
+    float cmin[3] = { RT_FAR, RT_FAR, RT_FAR }, cmax[3] = { -RT_FAR, -RT_FAR, -RT_FAR };
+
+    for (k = 0; k < 3; k++) {
+        node->bmin[k] = RT_FAR;
+        node->bmax[k] = -RT_FAR;
+    }
+    for (i = first; i < first + count; i++) {
+        const rt_sphere *s = &sc->spheres[sc->prims[i]];
+        for (k = 0; k < 3; k++) {
+            node->bmin[k] = MIN(node->bmin[k], s->c[k] - s->r);
+            node->bmax[k] = MAX(node->bmax[k], s->c[k] + s->r);
+            cmin[k] = MIN(cmin[k], s->c[k]);
+            cmax[k] = MAX(cmax[k], s->c[k]);
+        }
+    }
+
+    if (count <= RT_LEAF) {
+        node->first = first;
+        node->count = count;
+        return n;
+    }
+
+    /* median split on the widest axis of the centroids */
+    rt_centroid_axis = 0;
+    for (k = 1; k < 3; k++)
+        if (cmax[k] - cmin[k] > cmax[rt_centroid_axis] - cmin[rt_centroid_axis])
+            rt_centroid_axis = k;
+    g_qsort_with_data(sc->prims + first, count, sizeof(gint), rt_cmp_centroid, sc->spheres);
+
+    node->count = 0;
+    rt_build(sc, first, count / 2);
+    node->first = rt_build(sc, first + count / 2, count - count / 2);
+    return n;
+}
+
+static void rt_scene_init(rt_scene *sc) {
+    gint i, j;
+
+    memset(sc, 0, sizeof(*sc));
+    rt_rand_state = 20170101U;
+
+    sc->n_spheres = RT_GRID * RT_GRID;
+    sc->spheres = g_new0(rt_sphere, sc->n_spheres);
+    sc->prims = g_new(gint, sc->n_spheres);
+    sc->nodes = g_new0(rt_node, 2 * sc->n_spheres);
+
+    for (i = 0; i < RT_GRID; i++) {
+        for (j = 0; j < RT_GRID; j++) {
+            rt_sphere *s = &sc->spheres[i * RT_GRID + j];
+            s->r = 0.12f + 0.25f * rt_rand();
+            s->r2 = s->r * s->r;
+            s->c[0] = (i - RT_GRID / 2 + 0.5f) * 0.8f + 0.2f * (rt_rand() - 0.5f);
+            s->c[1] = s->r + 0.6f * rt_rand() * rt_rand();
+            s->c[2] = (j - RT_GRID / 2 + 0.5f) * 0.8f + 0.2f * (rt_rand() - 0.5f);
+            s->color[0] = 0.2f + 0.8f * rt_rand();
+            s->color[1] = 0.2f + 0.8f * rt_rand();
+            s->color[2] = 0.2f + 0.8f * rt_rand();
+            s->refl = (rt_rand() < 0.25f) ? 0.6f : 0.0f;
+        }
+    }
+    for (i = 0; i < sc->n_spheres; i++)
+        sc->prims[i] = i;
+
+    sc->light[0] = 6.0f;
+    sc->light[1] = 12.0f;
+    sc->light[2] = -4.0f;
+
+    rt_build(sc, 0, sc->n_spheres);
+}
+
+static void rt_scene_free(rt_scene *sc) {
+    g_free(sc->spheres);
+    g_free(sc->prims);
+    g_free(sc->nodes);
+}
+
+static float rt_sphere_t(const rt_sphere *s, const float *o, const float *d) {
+    float oc[3], b, cc, disc, sq, t;
+
+    oc[0] = o[0] - s->c[0];
+    oc[1] = o[1] - s->c[1];
+    oc[2] = o[2] - s->c[2];
+    b = DOT(oc, d);
+    cc = DOT(oc, oc) - s->r2;
+    disc = b * b - cc;
+    if (disc < 0.0f)
+        return RT_FAR;
+    sq = sqrtf(disc);
+    t = -b - sq;
+    if (t < RT_EPS)
+        t = -b + sq;
+    return (t < RT_EPS) ? RT_FAR : t;
+}
+
+static float rt_floor_t(const float *o, const float *d) {
+    float t;
+    if (d[1] >= 0.0f)
+        return RT_FAR;
+    t = -o[1] / d[1];
+    return (t < RT_EPS) ? RT_FAR : t;
+}
+
+static gboolean rt_box_hit(const rt_node *n, const float *o, const float *inv, float closest) {
+    float tmin = 0.0f, tmax = closest, t0, t1;
+    gint k;
+
+    for (k = 0; k < 3; k++) {
+        t0 = (n->bmin[k] - o[k]) * inv[k];
+        t1 = (n->bmax[k] - o[k]) * inv[k];
+        if (t0 > t1) {
+            float tt = t0;
+            t0 = t1;
+            t1 = tt;
+        }
+        tmin = MAX(tmin, t0);
+        tmax = MIN(tmax, t1);
+    }
+    return tmin <= tmax;
+}
+
+static void rt_inverse(const float *d, float *inv) {
+    gint k;
+    for (k = 0; k < 3; k++)
+        inv[k] = (d[k] != 0.0f) ? 1.0f / d[k] : RT_FAR;
+}
+
+/* nearest hit; with any_before > 0, stops at any hit nearer than that */
+static rt_hit rt_intersect(const rt_scene *sc, const float *o, const float *d, float any_before) {
+    rt_hit hit = { RT_FAR, -2 };
+    gint stack[64], sp = 0, i;
+    float inv[3], t;
+
+    t = rt_floor_t(o, d);
+    if (t < hit.t) {
+        hit.t = t;
+        hit.sphere = -1;
+    }
+    if (any_before > 0.0f && hit.t < any_before)
+        return hit;
+
+    rt_inverse(d, inv);
+    stack[sp++] = 0;
+    while (sp) {
+        const rt_node *n = &sc->nodes[stack[--sp]];
+
+        if (!rt_box_hit(n, o, inv, hit.t))
+            continue;
+        if (n->count) {
+            for (i = n->first; i < n->first + n->count; i++) {
+                gint si = sc->prims[i];
+                t = rt_sphere_t(&sc->spheres[si], o, d);
+                if (t < hit.t || (t == hit.t && si < hit.sphere)) {
+                    hit.t = t;
+                    hit.sphere = si;
+                    if (any_before > 0.0f && t < any_before)
+                        return hit;
+                }
+            }
+        } else {
+            stack[sp++] = n->first;
+            stack[sp++] = (gint)(n - sc->nodes) + 1;
+        }
+    }
+    return hit;
+}
+
+/* lanes of a where mask is set, of b elsewhere */
+static inline rt_v4 rt_select(rt_v4i mask, rt_v4 a, rt_v4 b) {
+    return (rt_v4)(((rt_v4i)a & mask) | ((rt_v4i)b & ~mask));
+}
+
+/* the same as rt_sphere_t() and rt_box_hit(), for four rays at once */
+static void rt_intersect4(const rt_scene *sc, const float o[3],
+                          const rt_v4 d[3], rt_hit hit[4]) {
+    rt_v4 inv[3], best, bmin, bmax, t0, t1, tmin, tmax, tt;
+    rt_v4i best_id, any;
+    gint stack[64], sp = 0, i, k, l;
+
+    for (l = 0; l < 4; l++) {
+        float dl[3] = { d[0][l], d[1][l], d[2][l] }, invl[3];
+        rt_inverse(dl, invl);
+        for (k = 0; k < 3; k++)
+            inv[k][l] = invl[k];
+        best[l] = rt_floor_t(o, dl);
+        best_id[l] = (best[l] < RT_FAR) ? -1 : -2;
+    }
+
+    stack[sp++] = 0;
+    while (sp) {
+        const rt_node *n = &sc->nodes[stack[--sp]];
+
+        tmin = (rt_v4){ 0.0f, 0.0f, 0.0f, 0.0f };
+        tmax = best;
+        for (k = 0; k < 3; k++) {
+            bmin = (rt_v4){ n->bmin[k], n->bmin[k], n->bmin[k], n->bmin[k] };
+            bmax = (rt_v4){ n->bmax[k], n->bmax[k], n->bmax[k], n->bmax[k] };
+            t0 = (bmin - o[k]) * inv[k];
+            t1 = (bmax - o[k]) * inv[k];
+            tt = rt_select(t0 > t1, t1, t0);
+            t1 = rt_select(t0 > t1, t0, t1);
+            tmin = rt_select(tmin > tt, tmin, tt);
+            tmax = rt_select(tmax < t1, tmax, t1);
+        }
+        any = tmin <= tmax;
+        if (!(any[0] | any[1] | any[2] | any[3]))
+            continue;
+
+        if (n->count) {
+            for (i = n->first; i < n->first + n->count; i++) {
+                gint si = sc->prims[i];
+                const rt_sphere *s = &sc->spheres[si];
+                rt_v4 oc0 = { o[0] - s->c[0], o[0] - s->c[0], o[0] - s->c[0], o[0] - s->c[0] };
+                rt_v4 oc1 = { o[1] - s->c[1], o[1] - s->c[1], o[1] - s->c[1], o[1] - s->c[1] };
+                rt_v4 oc2 = { o[2] - s->c[2], o[2] - s->c[2], o[2] - s->c[2], o[2] - s->c[2] };
+                rt_v4 b = oc0 * d[0] + oc1 * d[1] + oc2 * d[2];
+                float cc = (o[0] - s->c[0]) * (o[0] - s->c[0])
+                         + (o[1] - s->c[1]) * (o[1] - s->c[1])
+                         + (o[2] - s->c[2]) * (o[2] - s->c[2]) - s->r2;
+                rt_v4 disc = b * b - cc;
+
+                for (l = 0; l < 4; l++) {
+                    float sq, t;
+                    if (disc[l] < 0.0f)
+                        continue;
+                    sq = sqrtf(disc[l]);
+                    t = -b[l] - sq;
+                    if (t < RT_EPS)
+                        t = -b[l] + sq;
+                    if (t < RT_EPS)
+                        continue;
+                    if (t < best[l] || (t == best[l] && si < best_id[l])) {
+                        best[l] = t;
+                        best_id[l] = si;
+                    }
+                }
+            }
+        } else {
+            stack[sp++] = n->first;
+            stack[sp++] = (gint)(n - sc->nodes) + 1;
+        }
+    }
+
+    for (l = 0; l < 4; l++) {
+        hit[l].t = best[l];
+        hit[l].sphere = best_id[l];
+    }
+}
+
+static void rt_shade(const rt_scene *sc, const float *o, const float *d,
+                     rt_hit hit, gint depth, float *col, double *rays);
+
+static void rt_trace(const rt_scene *sc, const float *o, const float *d,
+                     gint depth, float *col, double *rays) {
+    (*rays)++;
+    rt_shade(sc, o, d, rt_intersect(sc, o, d, 0.0f), depth, col, rays);
+}
+
+static void rt_shade(const rt_scene *sc, const float *o, const float *d,
+                     rt_hit hit, gint depth, float *col, double *rays) {
+    float p[3], n[3], l[3], base[3], refl = 0.0f, diff, dist, sp[3];
+    gint k;
+
+    if (hit.sphere == -2) {
+        float sky = 0.5f + 0.5f * d[1];
+        col[0] = 0.4f * sky;
+        col[1] = 0.6f * sky;
+        col[2] = 0.9f * sky;
+        return;
+    }
+
+    for (k = 0; k < 3; k++)
+        p[k] = o[k] + hit.t * d[k];
+
+    if (hit.sphere == -1) {
+        gint check = ((gint)floorf(p[0]) + (gint)floorf(p[2])) & 1;
+        n[0] = 0.0f;
+        n[1] = 1.0f;
+        n[2] = 0.0f;
+        base[0] = base[1] = base[2] = check ? 0.85f : 0.25f;
+        refl = 0.2f;
+    } else {
+        const rt_sphere *s = &sc->spheres[hit.sphere];
+        for (k = 0; k < 3; k++) {
+            n[k] = (p[k] - s->c[k]) / s->r;
+            base[k] = s->color[k];
+        }
+        refl = s->refl;
+    }
+
+    for (k = 0; k < 3; k++) {
+        l[k] = sc->light[k] - p[k];
+        sp[k] = p[k] + n[k] * RT_EPS;
+    }
+    dist = sqrtf(DOT(l, l));
+    for (k = 0; k < 3; k++)
+        l[k] /= dist;
+
+    diff = DOT(n, l);
+    if (diff > 0.0f) {
+        (*rays)++;
+        if (rt_intersect(sc, sp, l, dist).t < dist)
+            diff = 0.0f;
+    } else {
+        diff = 0.0f;
+    }
+
+    for (k = 0; k < 3; k++)
+        col[k] = base[k] * (0.1f + 0.9f * diff);
+
+    if (refl > 0.0f && depth < RT_MAX_DEPTH) {
+        float r[3], rc[3], dn = 2.0f * DOT(d, n);
+        for (k = 0; k < 3; k++)
+            r[k] = d[k] - dn * n[k];
+        rt_trace(sc, sp, r, depth + 1, rc, rays);
+        for (k = 0; k < 3; k++)
+            col[k] = col[k] * (1.0f - refl) + refl * rc[k];
+    }
+}
+
+static void rt_camera(gint frame, float *eye, float *fw, float *right, float *up) {
+    const float target[3] = { 0.0f, 0.5f, 0.0f };
+    gint k;
+
+    for (k = 0; k < 3; k++) {
+        eye[k] = rt_eyes[frame][k];
+        fw[k] = target[k] - eye[k];
+    }
+    rt_normalize(fw);
+    right[0] = fw[2];
+    right[1] = 0.0f;
+    right[2] = -fw[0];
+    rt_normalize(right);
+    up[0] = fw[1] * right[2] - fw[2] * right[1];
+    up[1] = fw[2] * right[0] - fw[0] * right[2];
+    up[2] = fw[0] * right[1] - fw[1] * right[0];
+}
+
+static void rt_primary(gint width, gint height, const float *fw, const float *right,
+                       const float *up, gint x, gint y, float *d) {
+    float u = (2.0f * x + 1.0f - width) / height;
+    float v = (height - 2.0f * y - 1.0f) / height;
+    gint k;
+
+    for (k = 0; k < 3; k++)
+        d[k] = fw[k] * 1.5f + right[k] * u + up[k] * v;
+    rt_normalize(d);
+}
+
+static void rt_store(guchar *px, const float *col) {
+    gint k;
+    for (k = 0; k < 3; k++) {
+        float v = col[k] * 255.0f + 0.5f;
+        px[k] = (v >= 255.0f) ? 255 : (v <= 0.0f) ? 0 : (guchar)v;
+    }
+}
+
+static double rt_render_tile(const rt_job *job, gint tile) {
+    const rt_scene *sc = job->scene;
+    gint frame = tile / job->tiles_per_frame, t = tile % job->tiles_per_frame;
+    gint x0 = (t % job->tiles_x) * RT_TILE, y0 = (t / job->tiles_x) * RT_TILE;
+    guchar *image = job->image + (gsize)frame * job->width * job->height * 3;
+    float eye[3], fw[3], right[3], up[3], col[3];
+    double rays = 0;
+    gint x, y, l, k;
+
+    rt_camera(frame, eye, fw, right, up);
+
+    for (y = y0; y < y0 + RT_TILE; y += 2) {
+        for (x = x0; x < x0 + RT_TILE; x += 2) {
+            float d[4][3];
+            rt_hit hit[4];
+
+            for (l = 0; l < 4; l++)
+                rt_primary(job->width, job->height, fw, right, up,
+                           x + (l & 1), y + (l >> 1), d[l]);
+
+            if (job->packets) {
+                rt_v4 dv[3];
+                for (k = 0; k < 3; k++)
+                    dv[k] = (rt_v4){ d[0][k], d[1][k], d[2][k], d[3][k] };
+                rt_intersect4(sc, eye, dv, hit);
+            } else {
+                for (l = 0; l < 4; l++)
+                    hit[l] = rt_intersect(sc, eye, d[l], 0.0f);
+            }
+
+            for (l = 0; l < 4; l++) {
+                rays++;
+                rt_shade(sc, eye, d[l], hit[l], 0, col, &rays);
+                rt_store(image + ((gsize)(y + (l >> 1)) * job->width + x + (l & 1)) * 3, col);
+            }
+        }
+    }
+
+    return rays;
+}
+
+/* one call per thread; tiles are taken until there are none left */
+static gpointer rt_worker(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    rt_job *job = data;
+    double *rays = g_new0(double, 1);
+    gint tile;
+
+    while ((tile = g_atomic_int_add(&job->next_tile, 1)) < job->n_tiles)
+        *rays += rt_render_tile(job, tile);
+
+    return rays;
+}
+
+static void rt_job_init(rt_job *job, const rt_scene *sc, gint width, gint height,
+                        gint frames, gboolean packets) {
+    job->scene = sc;
+    job->width = width;
+    job->height = height;
+    job->tiles_x = width / RT_TILE;
+    job->tiles_per_frame = job->tiles_x * (height / RT_TILE);
+    job->n_tiles = job->tiles_per_frame * frames;
+    job->next_tile = 0;
+    job->packets = packets;
+    job->image = g_malloc0((gsize)width * height * 3 * frames);
+}
+
+static guint32 rt_checksum(const guchar *p, gsize len) {
+    guint32 h = 2166136261U;
+    while (len--) {
+        h ^= *p++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static gboolean rt_packets_supported(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__ALTIVEC__)
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+void
+benchmark_raytrace2(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE, t;
+    rt_scene sc;
+    rt_job job, check_scalar, check_packets;
+    gboolean packets = rt_packets_supported(), valid = TRUE;
+    gsize image_size = (gsize)RT_WIDTH * RT_HEIGHT * 3 * RT_FRAMES;
+    guint32 sum = 0;
+    guint rounds;
+    double rays = 0, elapsed = 0;
+    gint i;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Rendering raytracing scene...");
+
+    rt_scene_init(&sc);
+
+    /* both paths on a small frame first; they must agree exactly */
+    rt_job_init(&check_scalar, &sc, 64, 48, 1, FALSE);
+    rt_job_init(&check_packets, &sc, 64, 48, 1, TRUE);
+    for (i = 0; i < check_scalar.n_tiles; i++) {
+        rt_render_tile(&check_scalar, i);
+        rt_render_tile(&check_packets, i);
+    }
+    if (memcmp(check_scalar.image, check_packets.image, 64 * 48 * 3) != 0) {
+        DEBUG("raytrace2: scalar and packet paths differ");
+        valid = FALSE;
+    }
+    g_free(check_scalar.image);
+    g_free(check_packets.image);
+
+    rt_job_init(&job, &sc, RT_WIDTH, RT_HEIGHT, RT_FRAMES, packets);
+    for (rounds = 0; valid && (rounds == 0 || elapsed < benchmark_time(RT_TIME)); rounds++) {
+        if (rounds) {
+            memset(job.image, 0, image_size);
+            job.next_tile = 0;
+        }
+
+        t = benchmark_parallel(0, rt_worker, &job);
+        r.threads_used = t.threads_used;
+        rays += t.result;
+        elapsed += t.elapsed_time;
+
+        sum = rt_checksum(job.image, image_size);
+#if FLT_EVAL_METHOD == 0
+        if (sum != RT_CHECKSUM) {
+            DEBUG("raytrace2: image checksum %08x, expected %08x", sum, RT_CHECKSUM);
+            valid = FALSE;
+        }
+#endif
+    }
+    r.result = rays;
+    r.elapsed_time = elapsed;
+
+    bench_value_add_extra(&r, "Rays", "%.0f", r.result);
+    bench_value_add_extra(&r, "Rounds", "%u", rounds);
+    bench_value_add_extra(&r, "Ray Path", "%s", packets ? "4-wide packets" : "scalar");
+    bench_value_add_extra(&r, "Image Checksum", "%08x", sum);
+    bench_value_add_extra(&r, "Validation", "%s", valid ? "passed" : "FAILED");
+
+    r.result = valid ? r.result / r.elapsed_time / 1e6 : 0;
+
+    g_free(job.image);
+    rt_scene_free(&sc);
+
+    bench_results[BENCHMARK_RAYTRACE2] = r;
+}
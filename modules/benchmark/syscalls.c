@@ -0,0 +1,352 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Kernel entry and exit, which is where CPU vulnerability mitigations
+ * (page table isolation, buffer clearing, return stack stuffing...)
+ * cost the most: a bare system call, clock_gettime() through the vDSO
+ * and as a real system call, round trips between two threads over a
+ * pipe, an eventfd and a futex, and creating and joining a thread.
+ * Both threads of a round trip run on the same CPU, so each round trip
+ * is two context switches. Every test runs for SC_TIME seconds.
+ * The result is nanoseconds per getpid() system call; the other costs
+ * and the mitigations the kernel reports in
+ * /sys/devices/system/cpu/vulnerabilities are kept with the result. */
+#define SC_TIME   0.25
+#define SC_BATCH  64
+
+#define SC_VULN_DIR "/sys/devices/system/cpu/vulnerabilities"
+
+typedef enum {
+    SC_PIPE,
+    SC_EVENTFD,
+    SC_FUTEX,
+} sc_channel;
+
+typedef struct {
+    sc_channel channel;
+    gint cpu;
+    gint fd_ping[2], fd_pong[2];    /* pipes: read, write end; eventfd: [0] */
+    volatile gint word;             /* futex */
+    volatile gint stop;
+} sc_pair;
+
+static void sc_pin(gint cpu) {
+    cpu_set_t set;
+
+    if (cpu < 0)
+        return;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+static void sc_futex_wait(volatile gint *word, gint value) {
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static void sc_futex_wake(volatile gint *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static gboolean sc_read(gint fd) {
+    guint64 v;
+    return read(fd, &v, sizeof(v)) > 0;
+}
+
+static gboolean sc_write(gint fd) {
+    guint64 v = 1;
+    return write(fd, &v, sizeof(v)) > 0;
+}
+
+/* the other end of a round trip: answers until told to stop */
+static gpointer sc_partner(gpointer data) {
+    sc_pair *p = data;
+    gchar c;
+
+    sc_pin(p->cpu);
+
+    for (;;) {
+        switch (p->channel) {
+        case SC_PIPE:
+            if (read(p->fd_ping[0], &c, 1) != 1)
+                return NULL;
+            break;
+        case SC_EVENTFD:
+            if (!sc_read(p->fd_ping[0]))
+                return NULL;
+            break;
+        case SC_FUTEX:
+            while (g_atomic_int_get(&p->word) == 0)
+                sc_futex_wait(&p->word, 0);
+            break;
+        }
+
+        if (g_atomic_int_get(&p->stop))
+            return NULL;
+
+        switch (p->channel) {
+        case SC_PIPE:
+            if (write(p->fd_pong[1], "", 1) != 1)
+                return NULL;
+            break;
+        case SC_EVENTFD:
+            sc_write(p->fd_pong[0]);
+            break;
+        case SC_FUTEX:
+            g_atomic_int_set(&p->word, 0);
+            sc_futex_wake(&p->word);
+            break;
+        }
+    }
+}
+
+static void sc_round_trip(sc_pair *p) {
+    gchar c;
+
+    switch (p->channel) {
+    case SC_PIPE:
+        if (write(p->fd_ping[1], "", 1) != 1 || read(p->fd_pong[0], &c, 1) != 1)
+            DEBUG("syscalls: pipe round trip failed");
+        break;
+    case SC_EVENTFD:
+        if (sc_write(p->fd_ping[0]))
+            sc_read(p->fd_pong[0]);
+        break;
+    case SC_FUTEX:
+        g_atomic_int_set(&p->word, 1);
+        sc_futex_wake(&p->word);
+        while (g_atomic_int_get(&p->word) == 1)
+            sc_futex_wait(&p->word, 1);
+        break;
+    }
+}
+
+static gpointer sc_thread_nop(gpointer data) {
+    return data;
+}
+
+enum {
+    SC_OP_GETPID,
+    SC_OP_CLOCK_VDSO,
+    SC_OP_CLOCK_SYSCALL,
+    SC_OP_ROUND_TRIP,
+    SC_OP_THREAD,
+};
+
+/* nanoseconds per operation, running batches for SC_TIME seconds */
+static double sc_measure(gint op, sc_pair *p) {
+    GTimer *timer = g_timer_new();
+    struct timespec ts;
+    guint64 n = 0;
+    gint i;
+    double elapsed, seconds = benchmark_time(SC_TIME);
+
+    g_timer_start(timer);
+    do {
+        for (i = 0; i < SC_BATCH; i++) {
+            switch (op) {
+            case SC_OP_GETPID:
+                syscall(SYS_getpid);
+                break;
+            case SC_OP_CLOCK_VDSO:
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                break;
+            case SC_OP_CLOCK_SYSCALL:
+                syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &ts);
+                break;
+            case SC_OP_ROUND_TRIP:
+                sc_round_trip(p);
+                break;
+            case SC_OP_THREAD:
+                g_thread_join(g_thread_new("nop", sc_thread_nop, NULL));
+                break;
+            }
+        }
+        n += SC_BATCH;
+    } while ((elapsed = g_timer_elapsed(timer, NULL)) < seconds);
+    g_timer_destroy(timer);
+
+    return elapsed * 1e9 / n;
+}
+
+/* round trips with a partner thread on the same CPU, or -1 */
+static double sc_measure_pair(sc_channel channel, gint cpu) {
+    sc_pair p;
+    GThread *partner;
+    double ns = -1;
+
+    memset(&p, 0, sizeof(p));
+    p.channel = channel;
+    p.cpu = cpu;
+    p.fd_ping[0] = p.fd_ping[1] = p.fd_pong[0] = p.fd_pong[1] = -1;
+
+    if (channel == SC_PIPE) {
+        if (pipe(p.fd_ping) != 0)
+            return -1;
+        if (pipe(p.fd_pong) != 0) {
+            close(p.fd_ping[0]);
+            close(p.fd_ping[1]);
+            return -1;
+        }
+    } else if (channel == SC_EVENTFD) {
+        p.fd_ping[0] = eventfd(0, 0);
+        p.fd_pong[0] = eventfd(0, 0);
+        if (p.fd_ping[0] < 0 || p.fd_pong[0] < 0)
+            goto out;
+    }
+
+    partner = g_thread_new("partner", sc_partner, &p);
+    ns = sc_measure(SC_OP_ROUND_TRIP, &p);
+
+    /* wake the partner once more so it sees stop */
+    g_atomic_int_set(&p.stop, 1);
+    switch (channel) {
+    case SC_PIPE:
+        close(p.fd_ping[1]);    /* its read() returns 0 */
+        p.fd_ping[1] = -1;
+        break;
+    case SC_EVENTFD:
+        sc_write(p.fd_ping[0]);
+        break;
+    case SC_FUTEX:
+        g_atomic_int_set(&p.word, 1);
+        sc_futex_wake(&p.word);
+        break;
+    }
+    g_thread_join(partner);
+
+out:
+    if (p.fd_ping[0] >= 0) close(p.fd_ping[0]);
+    if (p.fd_ping[1] >= 0) close(p.fd_ping[1]);
+    if (p.fd_pong[0] >= 0) close(p.fd_pong[0]);
+    if (p.fd_pong[1] >= 0) close(p.fd_pong[1]);
+    return ns;
+}
+
+/* "meltdown (PTI), spectre_v2 (Retpolines)..." for the mitigated
+ * vulnerabilities; names of the vulnerable ones in *vulnerable */
+static gchar *sc_mitigations(gchar **vulnerable) {
+    GDir *dir = g_dir_open(SC_VULN_DIR, 0, NULL);
+    GSList *names = NULL, *l;
+    gchar *ret = NULL;
+    const gchar *vuln;
+
+    *vulnerable = NULL;
+    if (!dir)
+        return NULL;
+
+    while ((vuln = g_dir_read_name(dir)))
+        names = g_slist_prepend(names, g_strdup(vuln));
+    g_dir_close(dir);
+    names = g_slist_sort(names, (GCompareFunc)g_strcmp0);
+
+    for (l = names; l; l = l->next) {
+        gchar *contents = h_sysfs_read_string(SC_VULN_DIR, l->data);
+
+        if (!contents)
+            continue;
+
+        if (g_str_has_prefix(contents, "Mitigation: ")) {
+            /* first part of the description only, and nothing that
+             * would break the key=value;... list */
+            gchar *how = g_strndup(contents + 12, strcspn(contents + 12, ";,=|\n"));
+            g_strstrip(how);
+            ret = h_strdup_cprintf("%s%s (%s)", ret, ret ? ", " : "", (gchar *)l->data, how);
+            g_free(how);
+        } else if (strstr(contents, "Vulnerable") || strstr(contents, "vulnerable")) {
+            *vulnerable = h_strdup_cprintf("%s%s", *vulnerable, *vulnerable ? ", " : "",
+                                           (gchar *)l->data);
+        }
+        g_free(contents);
+    }
+    g_slist_free_full(names, g_free);
+
+    return ret;
+}
+
+void
+benchmark_syscalls(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE;
+    cpu_set_t saved;
+    gboolean restore;
+    gchar *mitigations, *vulnerable;
+    gint cpu;
+    double ns;
+    GTimer *timer = g_timer_new();
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running system call benchmark...");
+
+    g_timer_start(timer);
+
+    /* everything on the CPU we are on now; put the mask back after */
+    restore = sched_getaffinity(0, sizeof(saved), &saved) == 0;
+    cpu = sched_getcpu();
+    sc_pin(cpu);
+
+    r.result = sc_measure(SC_OP_GETPID, NULL);
+    bench_value_add_extra(&r, "getpid()", "%.1f ns", r.result);
+
+    ns = sc_measure(SC_OP_CLOCK_VDSO, NULL);
+    bench_value_add_extra(&r, "clock_gettime() vDSO", "%.1f ns", ns);
+    ns = sc_measure(SC_OP_CLOCK_SYSCALL, NULL);
+    bench_value_add_extra(&r, "clock_gettime() syscall", "%.1f ns", ns);
+
+    if ((ns = sc_measure_pair(SC_PIPE, cpu)) > 0)
+        bench_value_add_extra(&r, "Pipe Round Trip", "%.0f ns", ns);
+    if ((ns = sc_measure_pair(SC_EVENTFD, cpu)) > 0)
+        bench_value_add_extra(&r, "eventfd Round Trip", "%.0f ns", ns);
+    if ((ns = sc_measure_pair(SC_FUTEX, cpu)) > 0)
+        bench_value_add_extra(&r, "Futex Wake", "%.0f ns", ns / 2);
+
+    ns = sc_measure(SC_OP_THREAD, NULL);
+    bench_value_add_extra(&r, "Thread Create+Join", "%.0f ns", ns);
+
+    if (restore)
+        sched_setaffinity(0, sizeof(saved), &saved);
+
+    mitigations = sc_mitigations(&vulnerable);
+    bench_value_add_extra(&r, "Mitigations", "%s", mitigations ? mitigations : _("(None)"));
+    if (vulnerable)
+        bench_value_add_extra(&r, "Vulnerable", "%s", vulnerable);
+    g_free(mitigations);
+    g_free(vulnerable);
+
+    g_timer_stop(timer);
+    r.elapsed_time = g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+
+    r.threads_used = 1;
+    bench_results[BENCHMARK_SYSCALLS] = r;
+}
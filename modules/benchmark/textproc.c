@@ -0,0 +1,408 @@
+/*
+ *    HardInfo - Displays System Information
+ *    Copyright (C) 2003-2017 Leandro A. F. Pereira <leandro@hardinfo.org>
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, version 2.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "hardinfo.h"
+#include "benchmark.h"
+
+/* Branchy byte-level text work on all threads. benchmark.data is random
+ * bytes, so it is used to pick words (mostly ASCII, some Latin, Greek,
+ * Cyrillic, CJK and emoji), numbers, punctuation and line breaks for a TP_CORPUS
+ * byte UTF-8 text, which is cut into chunks at line breaks and shared
+ * out with benchmark_parallel_for(). Four kernels, each in two versions
+ * that must agree:
+ *   regex matching with GRegex, interpreted and optimized (JIT);
+ *   UTF-8 validation, a byte at a time and skipping 16 byte ASCII runs;
+ *   line splitting, a byte at a time and 16 bytes at a time;
+ *   case folding, a character at a time and 16 byte ASCII runs at once.
+ * The 16 byte versions use GCC vector extensions, so they compile to
+ * SSE2, NEON or plain integer code, whatever the target has. Every
+ * kernel runs for at least TP_TIME seconds.
+ * The result is the geometric mean of the eight rates in MB/s; 0 if a
+ * pair of kernels disagree. */
+#define TP_CORPUS  (16 << 20)
+#define TP_CHUNKS  512
+#define TP_TIME    0.5
+#define TP_PATTERN "\\b[A-Z][a-z]+ing\\b|[0-9]+\\.[0-9]+"
+
+typedef guchar tp_v16 __attribute__((vector_size(16)));
+
+typedef struct {
+    const gchar *text;
+    gsize *start;           /* TP_CHUNKS + 1 offsets */
+    guint64 *out;           /* one result per chunk */
+    GRegex *regex;
+    gboolean (*kernel)(const gchar *p, gsize len, GRegex *regex, guint64 *out);
+} tp_job;
+
+static const gchar *tp_words[] = {
+    "the", "of", "and", "to", "in", "is", "that", "for", "it", "as",
+    "with", "was", "on", "be", "by", "this", "are", "from", "at", "or",
+    "Hardware", "Information", "Processor", "Memory", "Benchmark", "Kernel",
+    "Running", "Testing", "Reading", "Loading", "running", "testing",
+};
+
+/* one word in eight */
+static const gchar *tp_intl_words[] = {
+    "caf\303\251", "na\303\257ve", "Stra\303\237e", "\303\234berpr\303\274fung",
+    "\303\211t\303\251", "\303\205ngstr\303\266m", "\305\201\303\263d\305\272",
+    "\316\225\316\273\316\273\316\267\316\275\316\271\316\272\316\254",
+    "\320\232\320\270\321\200\320\270\320\273\320\273\320\270\321\206\320\260",
+    "\320\237\321\200\320\270\320\262\320\265\321\202",
+    "\346\227\245\346\234\254\350\252\236", "\344\270\255\346\226\207",
+    "\355\225\234\352\265\255\354\226\264", "\360\237\230\200", "\360\237\232\200",
+};
+
+static const gchar *tp_separators[] = {
+    " ", " ", " ", " ", " ", " ", ", ", ". ", "; ", " - ", " (", ") ", "\n",
+};
+
+static gchar *tp_get_data(gsize *size) {
+    gchar *path, *data = NULL;
+
+    path = g_build_filename(params.path_data, "benchmark.data", NULL);
+    if (!g_file_get_contents(path, &data, size, NULL) || !*size) {
+        g_free(data);
+        data = NULL;
+    }
+    g_free(path);
+    return data;
+}
+
+/* the same text every time, given the same benchmark.data */
+static gchar *tp_corpus(const guchar *data, gsize size) {
+    GString *s = g_string_sized_new(TP_CORPUS + 64);
+    gsize i = 0, line = 0;
+
+    while (s->len < TP_CORPUS) {
+        guint b = data[i % size] ^ (guint)(i / size * 0x9e);
+        guint c = data[(i + 1) % size];
+
+        i += 2;
+        if ((b & 15) == 0) {
+            g_string_append_printf(s, "%u.%02u", c * 7, b % 100);
+        } else if ((b & 15) == 1) {
+            g_string_append_printf(s, "%u", c * 131 + b);
+        } else if (c & 0xe0) {
+            g_string_append(s, tp_words[(b * 256 + c) % G_N_ELEMENTS(tp_words)]);
+        } else {
+            g_string_append(s, tp_intl_words[(b * 256 + c) % G_N_ELEMENTS(tp_intl_words)]);
+        }
+
+        /* lines of roughly 40 to 120 bytes */
+        if (s->len - line > 40 + (c & 63) + (b & 15)) {
+            g_string_append_c(s, '\n');
+            line = s->len;
+        } else {
+            g_string_append(s, tp_separators[c % (G_N_ELEMENTS(tp_separators) - 1)]);
+        }
+    }
+    g_string_append_c(s, '\n');
+
+    return g_string_free(s, FALSE);
+}
+
+static inline tp_v16 tp_load(const gchar *p) {
+    tp_v16 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline gboolean tp_any(tp_v16 v) {
+    guint64 w[2];
+    memcpy(w, &v, sizeof(w));
+    return (w[0] | w[1]) != 0;
+}
+
+static inline gboolean tp_ascii16(const gchar *p) {
+    const tp_v16 high = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 };
+    return !tp_any(tp_load(p) & high);
+}
+
+/* regex: number of matches */
+static gboolean tp_regex(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    GMatchInfo *match_info;
+
+    *out = 0;
+    g_regex_match_full(regex, p, len, 0, 0, &match_info, NULL);
+    while (g_match_info_matches(match_info)) {
+        (*out)++;
+        g_match_info_next(match_info, NULL);
+    }
+    g_match_info_free(match_info);
+    return TRUE;
+}
+
+/* length of the UTF-8 sequence at p, 0 if invalid */
+static inline gsize tp_utf8_char(const guchar *p, const guchar *end) {
+    guint c = p[0], n, min, i, cp;
+
+    if (c < 0x80)
+        return 1;
+    else if ((c & 0xe0) == 0xc0)
+        n = 2, min = 0x80, cp = c & 0x1f;
+    else if ((c & 0xf0) == 0xe0)
+        n = 3, min = 0x800, cp = c & 0x0f;
+    else if ((c & 0xf8) == 0xf0)
+        n = 4, min = 0x10000, cp = c & 0x07;
+    else
+        return 0;
+
+    if (p + n > end)
+        return 0;
+    for (i = 1; i < n; i++) {
+        if ((p[i] & 0xc0) != 0x80)
+            return 0;
+        cp = (cp << 6) | (p[i] & 0x3f);
+    }
+    if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+        return 0;
+    return n;
+}
+
+/* UTF-8 validation: characters seen, or FALSE */
+static gboolean tp_utf8_scalar(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    const guchar *s = (const guchar *)p, *end = s + len;
+    gsize n;
+
+    *out = 0;
+    while (s < end) {
+        if (!(n = tp_utf8_char(s, end)))
+            return FALSE;
+        s += n;
+        (*out)++;
+    }
+    return TRUE;
+}
+
+static gboolean tp_utf8_simd(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    const guchar *s = (const guchar *)p, *end = s + len;
+    gsize n;
+
+    *out = 0;
+    while (s < end) {
+        if (s + 16 <= end && tp_ascii16((const gchar *)s)) {
+            s += 16;
+            *out += 16;
+            continue;
+        }
+        if (!(n = tp_utf8_char(s, end)))
+            return FALSE;
+        s += n;
+        (*out)++;
+    }
+    return TRUE;
+}
+
+/* line splitting: sum of line start offsets and the line count */
+static gboolean tp_lines_scalar(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    gsize i;
+
+    *out = 0;
+    for (i = 0; i < len; i++)
+        if (p[i] == '\n')
+            *out += ((guint64)1 << 40) + i + 1;
+    return TRUE;
+}
+
+static gboolean tp_lines_simd(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    const tp_v16 nl = { '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n',
+                        '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n' };
+    gsize i = 0, j;
+
+    *out = 0;
+    for (; i + 16 <= len; i += 16) {
+        if (!tp_any((tp_v16)(tp_load(p + i) == nl)))
+            continue;
+        for (j = i; j < i + 16; j++)
+            if (p[j] == '\n')
+                *out += ((guint64)1 << 40) + j + 1;
+    }
+    for (; i < len; i++)
+        if (p[i] == '\n')
+            *out += ((guint64)1 << 40) + i + 1;
+    return TRUE;
+}
+
+static inline guint64 tp_sum(const gchar *p, gsize len) {
+    guint64 sum = (guint64)len << 32;
+    gsize i;
+    for (i = 0; i < len; i++)
+        sum += (guchar)p[i] * (i & 255);
+    return sum;
+}
+
+/* case folding to lower case: a checksum of the folded text */
+static gchar *tp_fold_char(const gchar *p, gchar **o) {
+    if (!(*p & 0x80)) {
+        *(*o)++ = g_ascii_tolower(*p);
+        return (gchar *)p + 1;
+    }
+    *o += g_unichar_to_utf8(g_unichar_tolower(g_utf8_get_char(p)), *o);
+    return g_utf8_next_char(p);
+}
+
+static gboolean tp_fold_scalar(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    gchar *buf = g_malloc(2 * len + 8), *o = buf;
+    const gchar *end = p + len;
+
+    while (p < end)
+        p = tp_fold_char(p, &o);
+    *out = tp_sum(buf, o - buf);
+    g_free(buf);
+    return TRUE;
+}
+
+static gboolean tp_fold_simd(const gchar *p, gsize len, GRegex *regex, guint64 *out) {
+    const tp_v16 a = { 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A', 'A' };
+    const tp_v16 z = { 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z' };
+    const tp_v16 bit = { 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32 };
+    gchar *buf = g_malloc(2 * len + 8), *o = buf;
+    const gchar *end = p + len;
+
+    while (p < end) {
+        if (p + 16 <= end && tp_ascii16(p)) {
+            tp_v16 v = tp_load(p);
+            v |= (tp_v16)((v >= a) & (v <= z)) & bit;
+            memcpy(o, &v, 16);
+            o += 16;
+            p += 16;
+            continue;
+        }
+        p = tp_fold_char(p, &o);
+    }
+    *out = tp_sum(buf, o - buf);
+    g_free(buf);
+    return TRUE;
+}
+
+static gpointer tp_run(unsigned int start, unsigned int end, void *data, gint thread_number) {
+    tp_job *job = data;
+    unsigned int i;
+
+    for (i = start; i <= end; i++) {
+        if (!job->kernel(job->text + job->start[i], job->start[i + 1] - job->start[i],
+                         job->regex, &job->out[i]))
+            job->out[i] = G_MAXUINT64;
+    }
+    return NULL;
+}
+
+static const struct {
+    const gchar *title;
+    gboolean (*kernel)(const gchar *p, gsize len, GRegex *regex, guint64 *out);
+    gboolean optimize;      /* regex only */
+} tp_kernels[] = {
+    { "Regex", tp_regex, FALSE },
+    { "Regex (JIT)", tp_regex, TRUE },
+    { "UTF-8 Validation", tp_utf8_scalar },
+    { "UTF-8 Validation (SIMD)", tp_utf8_simd },
+    { "Line Splitting", tp_lines_scalar },
+    { "Line Splitting (SIMD)", tp_lines_simd },
+    { "Case Folding", tp_fold_scalar },
+    { "Case Folding (SIMD)", tp_fold_simd },
+};
+
+void
+benchmark_textproc(void)
+{
+    bench_value r = EMPTY_BENCH_VALUE, t;
+    tp_job job;
+    gchar *data;
+    gsize data_size, len, i;
+    guint64 checks[G_N_ELEMENTS(tp_kernels)];
+    double log_sum = 0, elapsed = 0;
+    gboolean valid = TRUE;
+    gint k;
+
+    shell_view_set_enabled(FALSE);
+    shell_status_update("Running text processing benchmark...");
+
+    if (!(data = tp_get_data(&data_size)))
+        return;
+
+    memset(&job, 0, sizeof(job));
+    job.text = tp_corpus((const guchar *)data, data_size);
+    g_free(data);
+    len = strlen(job.text);
+
+    /* chunks end after a line break */
+    job.start = g_new(gsize, TP_CHUNKS + 1);
+    job.out = g_new0(guint64, TP_CHUNKS);
+    job.start[0] = 0;
+    for (i = 1; i < TP_CHUNKS; i++) {
+        const gchar *nl = strchr(job.text + MAX(len * i / TP_CHUNKS, job.start[i - 1]), '\n');
+        job.start[i] = nl ? (gsize)(nl - job.text) + 1 : len;
+    }
+    job.start[TP_CHUNKS] = len;
+
+    for (k = 0; k < G_N_ELEMENTS(tp_kernels); k++) {
+        double kernel_time = 0, bytes = 0, rate;
+
+        job.kernel = tp_kernels[k].kernel;
+        if (job.kernel == tp_regex)
+            job.regex = g_regex_new(TP_PATTERN,
+                                    tp_kernels[k].optimize ? G_REGEX_OPTIMIZE : 0, 0, NULL);
+
+        do {
+            t = benchmark_parallel_for(0, 0, TP_CHUNKS, tp_run, &job);
+            kernel_time += t.elapsed_time;
+            bytes += len;
+        } while (kernel_time < benchmark_time(TP_TIME));
+
+        r.threads_used = t.threads_used;
+        elapsed += kernel_time;
+
+        checks[k] = 0;
+        for (i = 0; i < TP_CHUNKS; i++) {
+            if (job.out[i] == G_MAXUINT64)
+                valid = FALSE;
+            checks[k] += job.out[i];
+        }
+        /* the second of each pair must agree with the first */
+        if ((k & 1) && checks[k] != checks[k - 1]) {
+            DEBUG("textproc: %s and %s disagree", tp_kernels[k - 1].title, tp_kernels[k].title);
+            valid = FALSE;
+        }
+
+        if (job.regex) {
+            g_regex_unref(job.regex);
+            job.regex = NULL;
+        }
+
+        rate = bytes / kernel_time / 1e6;
+        bench_value_add_extra(&r, tp_kernels[k].title, "%.1f MB/s", rate);
+        log_sum += log(MAX(rate, 1e-3));
+    }
+
+    bench_value_add_extra(&r, "Validation", "%s", valid ? "passed" : "FAILED");
+
+    g_free(job.start);
+    g_free(job.out);
+    g_free((gchar *)job.text);
+
+    r.elapsed_time = elapsed;
+    r.result = valid ? exp(log_sum / G_N_ELEMENTS(tp_kernels)) : 0;
+
+    bench_results[BENCHMARK_TEXTPROC] = r;
+}
@@ -41,18 +41,18 @@
 #define THISORUNK(t) ( (t) ? t : _("(Unknown)") )
 
 /* Callbacks */
-gchar *callback_summary(void);
-gchar *callback_os(void);
-gchar *callback_security(void);
-gchar *callback_modules(void);
-gchar *callback_boots(void);
-gchar *callback_locales(void);
+struct Info *callback_summary(void);
+struct Info *callback_os(void);
+struct Info *callback_security(void);
+struct Info *callback_modules(void);
+struct Info *callback_boots(void);
+struct Info *callback_locales(void);
 gchar *callback_memory_usage();
-gchar *callback_fs(void);
-gchar *callback_display(void);
+struct Info *callback_fs(void);
+struct Info *callback_display(void);
 gchar *callback_network(void);
-gchar *callback_users(void);
-gchar *callback_groups(void);
+struct Info *callback_users(void);
+struct Info *callback_groups(void);
 gchar *callback_env_var(void);
 #if GLIB_CHECK_VERSION(2,14,0)
 gchar *callback_dev(void);
@@ -77,25 +77,25 @@ void scan_dev(gboolean reload);
 #endif /* GLIB_CHECK_VERSION(2,14,0) */
 
 static ModuleEntry entries[] = {
-    {N_("Summary"), "summary.png", callback_summary, scan_summary, MODULE_FLAG_NONE},
-    {N_("Operating System"), "os.png", callback_os, scan_os, MODULE_FLAG_NONE},
-    {N_("Security"), "security.png", callback_security, scan_security, MODULE_FLAG_NONE},
-    {N_("Kernel Modules"), "module.png", callback_modules, scan_modules, MODULE_FLAG_NONE},
-    {N_("Boots"), "boot.png", callback_boots, scan_boots, MODULE_FLAG_NONE},
-    {N_("Languages"), "language.png", callback_locales, scan_locales, MODULE_FLAG_NONE},
+    {N_("Summary"), "summary.png", callback_summary, scan_summary, MODULE_FLAG_INFO},
+    {N_("Operating System"), "os.png", callback_os, scan_os, MODULE_FLAG_INFO},
+    {N_("Security"), "security.png", callback_security, scan_security, MODULE_FLAG_INFO},
+    {N_("Kernel Modules"), "module.png", callback_modules, scan_modules, MODULE_FLAG_INFO},
+    {N_("Boots"), "boot.png", callback_boots, scan_boots, MODULE_FLAG_INFO},
+    {N_("Languages"), "language.png", callback_locales, scan_locales, MODULE_FLAG_INFO},
     {N_("Memory Usage"), "memory.png", callback_memory_usage, scan_memory_usage, MODULE_FLAG_NONE},
-    {N_("Filesystems"), "dev_removable.png", callback_fs, scan_fs, MODULE_FLAG_NONE},
-    {N_("Display"), "monitor.png", callback_display, scan_display, MODULE_FLAG_NONE},
-    {N_("Environment Variables"), "environment.png", callback_env_var, scan_env_var, MODULE_FLAG_NONE},
+    {N_("Filesystems"), "dev_removable.png", callback_fs, scan_fs, MODULE_FLAG_INFO},
+    {N_("Display"), "monitor.png", callback_display, scan_display, MODULE_FLAG_INFO},
+    {N_("Environment Variables"), "environment.png", callback_env_var, scan_env_var, MODULE_FLAG_INDEPENDENT},
 #if GLIB_CHECK_VERSION(2,14,0)
-    {N_("Development"), "devel.png", callback_dev, scan_dev, MODULE_FLAG_NONE},
+    {N_("Development"), "devel.png", callback_dev, scan_dev, MODULE_FLAG_INDEPENDENT},
 #endif /* GLIB_CHECK_VERSION(2,14,0) */
-    {N_("Users"), "users.png", callback_users, scan_users, MODULE_FLAG_NONE},
-    {N_("Groups"), "users.png", callback_groups, scan_groups, MODULE_FLAG_NONE},
+    {N_("Users"), "users.png", callback_users, scan_users, MODULE_FLAG_INFO | MODULE_FLAG_INDEPENDENT},
+    {N_("Groups"), "users.png", callback_groups, scan_groups, MODULE_FLAG_INFO | MODULE_FLAG_INDEPENDENT},
     {NULL},
 };
 
-gchar *module_list = NULL;
+GArray *module_list = NULL;
 Computer *computer = NULL;
 gchar *meminfo = NULL;
 gchar *lginterval = NULL;
@@ -290,9 +290,9 @@ void scan_dev(gboolean reload)
        }
 
        if (detect_lang[i].stdout) {
-            found = g_spawn_command_line_sync(detect_lang[i].version_command, &output, &ignored, NULL, NULL);
+            found = h_spawn_command_line_timeout(detect_lang[i].version_command, H_SPAWN_TIMEOUT_PROBE, &output, &ignored, NULL, NULL);
        } else {
-            found = g_spawn_command_line_sync(detect_lang[i].version_command, &ignored, &output, NULL, NULL);
+            found = h_spawn_command_line_timeout(detect_lang[i].version_command, H_SPAWN_TIMEOUT_PROBE, &ignored, &output, NULL, NULL);
        }
        g_free(ignored);
 
@@ -508,7 +508,7 @@ gchar *computer_get_virtualization(void)
     return detect_machine_type();
 }
 
-gchar *callback_summary(void)
+struct Info *callback_summary(void)
 {
     struct Info *info = info_new();
 
@@ -541,10 +541,10 @@ gchar *callback_summary(void)
     info_add_computed_group(info, NULL,  /* getStorageDevices provides group headers */
         idle_free(module_call_method("devices::getStorageDevices")));
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_os(void)
+struct Info *callback_os(void)
 {
     struct Info *info = info_new();
     gchar *distro_icon;
@@ -577,10 +577,10 @@ gchar *callback_os(void)
                    info_field_update(_("Load Average"), 10000),
                    info_field_last());
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_security(void)
+struct Info *callback_security(void)
 {
     struct Info *info = info_new();
 
@@ -636,55 +636,55 @@ gchar *callback_security(void)
         g_dir_close(dir);
     }
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_modules(void)
+struct Info *callback_modules(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Loaded Modules"), module_list);
+    info_add_fields_group(info, _("Loaded Modules"), module_list);
 
     info_set_column_title(info, "TextValue", _("Name"));
     info_set_column_title(info, "Value", _("Description"));
     info_set_column_headers_visible(info, TRUE);
     info_set_view_type(info, SHELL_VIEW_DUAL);
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_boots(void)
+struct Info *callback_boots(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Boots"), computer->os->boots);
+    info_add_fields_group(info, _("Boots"), computer->os->boots);
 
     info_set_column_title(info, "TextValue", _("Date & Time"));
     info_set_column_title(info, "Value", _("Kernel Version"));
     info_set_column_headers_visible(info, TRUE);
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_locales(void)
+struct Info *callback_locales(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Available Languages"), computer->os->languages);
+    info_add_fields_group(info, _("Available Languages"), computer->os->languages);
 
     info_set_column_title(info, "TextValue", _("Language Code"));
     info_set_column_title(info, "Value", _("Name"));
     info_set_view_type(info, SHELL_VIEW_DUAL);
     info_set_column_headers_visible(info, TRUE);
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_fs(void)
+struct Info *callback_fs(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Mounted File Systems"), fs_list);
+    info_add_fields_group(info, _("Mounted File Systems"), fs_list);
 
     info_set_column_title(info, "Extra1", _("Mount Point"));
     info_set_column_title(info, "Progress", _("Usage"));
@@ -694,13 +694,13 @@ gchar *callback_fs(void)
     info_set_zebra_visible(info, TRUE);
     info_set_normalize_percentage(info, FALSE);
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_display(void)
+struct Info *callback_display(void)
 {
     int n = 0;
-    gchar *screens_str = strdup(""), *outputs_str = strdup("");
+    struct InfoGroup *screens, *outputs;
     xinfo *xi = computer->display->xi;
     xrr_info *xrr = xi->xrr;
     glx_info *glx = xi->glx;
@@ -726,12 +726,16 @@ gchar *callback_display(void)
         info_field(_("Release Number"), THISORUNK(xi->release_number) ),
         info_field_last());
 
+    screens = info_add_group(info, _("Screens"), info_field_last());
     for (n = 0; n < xrr->screen_count; n++) {
         gchar *dims = g_strdup_printf(_(/* resolution WxH unit */ "%dx%d pixels"), xrr->screens[n].px_width, xrr->screens[n].px_height);
-        screens_str = h_strdup_cprintf("Screen %d=%s\n", screens_str, xrr->screens[n].number, dims);
-        g_free(dims);
+        info_group_add_fields(screens,
+            info_field(g_strdup_printf("Screen %d", xrr->screens[n].number), dims,
+                       .free_name_on_flatten = TRUE, .free_value_on_flatten = TRUE),
+            info_field_last());
     }
-    info_add_computed_group(info, _("Screens"), screens_str);
+
+    outputs = info_add_group(info, _("Outputs (XRandR)"), info_field_last());
 
     for (n = 0; n < xrr->output_count; n++) {
         gchar *connection = NULL;
@@ -753,12 +757,12 @@ gchar *callback_display(void)
                     xrr->outputs[n].px_width, xrr->outputs[n].px_height,
                     xrr->outputs[n].px_offset_x, xrr->outputs[n].px_offset_y);
 
-        outputs_str = h_strdup_cprintf("%s=%s; %s\n", outputs_str,
-            xrr->outputs[n].name, connection, dims);
+        info_group_add_fields(outputs,
+            info_field_printf(xrr->outputs[n].name, "%s; %s", connection, dims),
+            info_field_last());
 
         g_free(dims);
     }
-    info_add_computed_group(info, _("Outputs (XRandR)"), outputs_str);
 
     info_add_group(info, _("OpenGL (GLX)"),
         info_field(_("Vendor"), THISORUNK(glx->ogl_vendor) ),
@@ -774,32 +778,32 @@ gchar *callback_display(void)
         info_field(_("GLX Version"), THISORUNK(glx->glx_version) ),
         info_field_last());
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_users(void)
+struct Info *callback_users(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Users"), users);
+    info_add_fields_group(info, _("Users"), users);
     info_set_view_type(info, SHELL_VIEW_DUAL);
     info_set_reload_interval(info, 10000);
 
-    return info_flatten(info);
+    return info;
 }
 
-gchar *callback_groups(void)
+struct Info *callback_groups(void)
 {
     struct Info *info = info_new();
 
-    info_add_computed_group(info, _("Group"), groups);
+    info_add_fields_group(info, _("Group"), groups);
 
     info_set_column_title(info, "TextValue", _("Name"));
     info_set_column_title(info, "Value", _("Group ID"));
     info_set_column_headers_visible(info, TRUE);
     info_set_reload_interval(info, 10000);
 
-    return info_flatten(info);
+    return info;
 }
 
 gchar *get_os_kernel(void)
@@ -998,10 +1002,10 @@ void hi_module_deinit(void)
         g_free(computer->os->language);
         g_free(computer->os->homedir);
         g_free(computer->os->kernel_version);
-        g_free(computer->os->languages);
+        info_fields_free(computer->os->languages);
         g_free(computer->os->desktop);
         g_free(computer->os->username);
-        g_free(computer->os->boots);
+        info_fields_free(computer->os->boots);
         g_free(computer->os);
     }
 
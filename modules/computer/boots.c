@@ -31,11 +31,11 @@ scan_boots_real(void)
     scan_os(FALSE);
 
     if (!computer->os->boots)
-      computer->os->boots = strdup("");
+      computer->os->boots = info_fields_new();
     else
       return;
 
-    spawned = g_spawn_command_line_sync("last",
+    spawned = h_spawn_command_line_sync("last",
             &out, &err, NULL, NULL);
     if (spawned && out != NULL) {
         p = out;
@@ -52,10 +52,10 @@ scan_boots_real(void)
                   }
                 }
                 tmp = g_strsplit(p, " ", 0);
-                computer->os->boots =
-                  h_strdup_cprintf("\n%s %s %s %s=%s",
-                    computer->os->boots,
-                    tmp[4], tmp[5], tmp[6], tmp[7], tmp[3]);
+                gchar *date = g_strdup_printf("%s %s %s %s",
+                    tmp[4], tmp[5], tmp[6], tmp[7]);
+                info_fields_add(computer->os->boots, info_field(date, tmp[3]));
+                g_free(date);
                 g_strfreev(tmp);
             }
             p = next_nl + 1;
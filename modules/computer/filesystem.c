@@ -25,7 +25,7 @@
 #include "hardinfo.h"
 #include "computer.h"
 
-gchar *fs_list = NULL;
+GArray *fs_list = NULL;
 
 void
 scan_filesystems(void)
@@ -35,8 +35,8 @@ scan_filesystems(void)
     struct statfs sfs;
     int count = 0;
 
-    g_free(fs_list);
-    fs_list = g_strdup("");
+    info_fields_free(fs_list);
+    fs_list = info_fields_new();
     moreinfo_del_with_prefix("COMP:FS");
 
     mtab = fopen("/etc/mtab", "r");
@@ -88,11 +88,12 @@ scan_filesystems(void)
                         _("Available"), stravail);
                 gchar *key = g_strdup_printf("FS%d", ++count);
                 moreinfo_add_with_prefix("COMP", key, strhash);
-                g_free(key);
 
-                fs_list = h_strdup_cprintf("$FS%d$%s=%.2f %% (%s of %s)|%s\n",
-                                          fs_list,
-                                          count, tmp[0], use_ratio, stravail, strsize, tmp[1]);
+                gchar *usage = g_strdup_printf("%.2f %% (%s of %s)|%s",
+                                               use_ratio, stravail, strsize, tmp[1]);
+                info_fields_add(fs_list, info_field(tmp[0], usage, .tag = key));
+                g_free(usage);
+                g_free(key);
 
                 g_free(strsize);
                 g_free(stravail);
@@ -21,7 +21,7 @@
 #include "hardinfo.h"
 #include "computer.h"
 
-gchar *groups = NULL;
+GArray *groups = NULL;
 
 void
 scan_groups_do(void)
@@ -33,11 +33,14 @@ scan_groups_do(void)
     if (!group_)
         return;
 
-    g_free(groups);
-    groups = g_strdup("");
+    info_fields_free(groups);
+    groups = info_fields_new();
 
     while (group_) {
-        groups = h_strdup_cprintf("%s=%d\n", groups, group_->gr_name, group_->gr_gid);
+        gchar *gid = g_strdup_printf("%d", group_->gr_gid);
+
+        info_fields_add(groups, info_field(group_->gr_name, gid));
+        g_free(gid);
         group_ = getgrent();
     }
     
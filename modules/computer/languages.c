@@ -120,14 +120,14 @@ scan_languages(OperatingSystem * os)
     gboolean spawned;
     gchar *out, *err, *p, *next_nl;
 
-    gchar *ret = NULL;
+    GArray *ret = NULL;
     locale_info *curr = NULL;
     int last = 0;
 
-    spawned = g_spawn_command_line_sync("locale -va",
+    spawned = h_spawn_command_line_sync("locale -va",
             &out, &err, NULL, NULL);
     if (spawned) {
-        ret = g_strdup("");
+        ret = info_fields_new();
         p = out;
         while(1) {
             /* `locale -va` doesn't end the last locale block
@@ -166,7 +166,7 @@ scan_languages(OperatingSystem * os)
                 /* a blank line is the end of a locale */
                 gchar *li_str = locale_info_section(curr);
                 gchar *clean_title = hardinfo_clean_value(curr->title, 0); /* may contain & */
-                ret = h_strdup_cprintf("$%s$%s=%s\n", ret, curr->name, curr->name, clean_title);
+                info_fields_add(ret, info_field(curr->name, clean_title, .tag = curr->name));
                 moreinfo_add_with_prefix("COMP", g_strdup(curr->name), li_str); /* becomes owned by moreinfo */
                 locale_info_free(curr);
                 curr = NULL;
@@ -178,5 +178,6 @@ scan_languages(OperatingSystem * os)
         g_free(out);
         g_free(err);
     }
+    info_fields_free(os->languages);
     os->languages = ret;
 }
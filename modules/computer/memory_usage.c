@@ -20,10 +20,12 @@
 #include "devices.h"
 
 GHashTable *memlabels = NULL;
+/* meminfo and lginterval live in these, rebuilt on every scan */
+static GString *meminfo_str = NULL, *lginterval_str = NULL;
 
 void scan_memory_do(void)
 {
-    gchar **keys, *tmp, *tmp_label, *trans_val;
+    gchar **keys, *contents, *tmp, *tmp_label, *trans_val;
     static gint offset = -1;
     gint i;
 
@@ -44,15 +46,14 @@ void scan_memory_do(void)
         }
     }
 
-    g_file_get_contents("/proc/meminfo", &meminfo, NULL, NULL);
+    if (!g_file_get_contents("/proc/meminfo", &contents, NULL, NULL))
+        contents = g_strdup("");
 
-    keys = g_strsplit(meminfo, "\n", 0);
+    keys = g_strsplit(contents, "\n", 0);
+    g_free(contents);
 
-    g_free(meminfo);
-    g_free(lginterval);
-
-    meminfo = g_strdup("");
-    lginterval = g_strdup("");
+    meminfo_str = h_string_reuse(meminfo_str);
+    lginterval_str = h_string_reuse(lginterval_str);
 
     for (i = offset; keys[i]; i++) {
         gchar **newkeys = g_strsplit(keys[i], ":", 0);
@@ -81,20 +82,20 @@ void scan_memory_do(void)
 
         moreinfo_add_with_prefix("DEV", newkeys[0], g_strdup(trans_val));
 
-        tmp = g_strconcat(meminfo, newkeys[0], "=", trans_val, "|", tmp_label, "\n", NULL);
-        g_free(meminfo);
-        meminfo = tmp;
+        h_string_append_field(meminfo_str, NULL, newkeys[0], "%s|%s",
+                              trans_val, tmp_label);
 
         g_free(trans_val);
 
-        tmp = g_strconcat(lginterval,
-                          "UpdateInterval$", newkeys[0], "=1000\n", NULL);
-        g_free(lginterval);
-        lginterval = tmp;
+        g_string_append_printf(lginterval_str, "UpdateInterval$%s=1000\n",
+                               newkeys[0]);
 
         g_strfreev(newkeys);
     }
     g_strfreev(keys);
+
+    meminfo = meminfo_str->str;
+    lginterval = lginterval_str->str;
 }
 
 void init_memory_labels(void)
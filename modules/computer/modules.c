@@ -38,14 +38,14 @@ void scan_modules_do(void) {
 
     if (!_module_hash_table) { _module_hash_table = g_hash_table_new(g_str_hash, g_str_equal); }
 
-    g_free(module_list);
+    info_fields_free(module_list);
 
     module_list = NULL;
     moreinfo_del_with_prefix("COMP:MOD");
 
     lsmod_path = find_program("lsmod");
     if (!lsmod_path) return;
-    lsmod = popen(lsmod_path, "r");
+    lsmod = h_popen(lsmod_path, "r");
     if (!lsmod) {
         g_free(lsmod_path);
         return;
@@ -70,8 +70,8 @@ void scan_modules_do(void) {
         hashkey = g_strdup_printf("MOD%s", modname);
         buf = g_strdup_printf("/sbin/modinfo %s 2>/dev/null", modname);
 
-        modi = popen(buf, "r");
-        while (fgets(buffer, 1024, modi)) {
+        modi = h_popen(buf, "r");
+        while (modi && fgets(buffer, 1024, modi)) {
             gchar **tmp = g_strsplit(buffer, ":", 2);
 
             GET_STR("author", author);
@@ -87,7 +87,8 @@ void scan_modules_do(void) {
 
             g_strfreev(tmp);
         }
-        pclose(modi);
+        if (modi)
+            h_pclose(modi);
         g_free(buf);
 
         /* old modutils includes quotes in some strings; strip them */
@@ -111,8 +112,10 @@ void scan_modules_do(void) {
         }
 
         /* append this module to the list of modules */
-        module_list = h_strdup_cprintf("$%s$%s=%s\n", module_list, hashkey, modname,
-                                       description ? description : "");
+        if (!module_list)
+            module_list = info_fields_new();
+        info_fields_add(module_list, info_field(modname, description ? description : "",
+                                                .tag = hashkey));
 
         STRIFNULL(filename, _("(Not available)"));
         STRIFNULL(description, _("(Not available)"));
@@ -175,7 +178,7 @@ void scan_modules_do(void) {
         g_free(retpoline);
         g_free(intree);
     }
-    pclose(lsmod);
+    h_pclose(lsmod);
 
     g_free(lsmod_path);
 }
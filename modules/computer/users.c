@@ -20,7 +20,7 @@
 #include "hardinfo.h"
 #include "computer.h"
 
-gchar *users = NULL;
+GArray *users = NULL;
 
 void
 scan_users_do(void)
@@ -31,11 +31,11 @@ scan_users_do(void)
         return;
 
     if (users) {
-        g_free(users);
+        info_fields_free(users);
         moreinfo_del_with_prefix("COMP:USER");
     }
 
-    users = g_strdup("");
+    users = info_fields_new();
 
     while (passwd_) {
         gchar *key = g_strdup_printf("USER%s", passwd_->pw_name);
@@ -52,7 +52,7 @@ scan_users_do(void)
         moreinfo_add_with_prefix("COMP", key, val);
 
         strend(passwd_->pw_gecos, ',');
-        users = h_strdup_cprintf("$%s$%s=%s\n", users, key, passwd_->pw_name, passwd_->pw_gecos);
+        info_fields_add(users, info_field(passwd_->pw_name, passwd_->pw_gecos, .tag = key));
         passwd_ = getpwent();
         g_free(key);
     }
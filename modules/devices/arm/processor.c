@@ -482,13 +482,12 @@ gchar *processor_get_info(GSList * processors)
 {
     Processor *processor;
     gchar *ret, *tmp, *hashkey;
-    gchar *meta; /* becomes owned by more_info? no need to free? */
     GSList *l;
 
     tmp = g_strdup_printf("$!CPU_META$%s=\n", _("SOC/Package Information") );
 
-    meta = processor_meta(processors);
-    moreinfo_add_with_prefix("DEV", "CPU_META", meta);
+    moreinfo_add_func_with_prefix("DEV", "CPU_META",
+            (MoreInfoFunc) processor_meta, processors, NULL);
 
     for (l = processors; l; l = l->next) {
         processor = (Processor *) l->data;
@@ -499,8 +498,8 @@ gchar *processor_get_info(GSList * processors)
                   processor->cpu_mhz, _("MHz"));
 
         hashkey = g_strdup_printf("CPU%d", processor->id);
-        moreinfo_add_with_prefix("DEV", hashkey,
-                processor_get_detailed_info(processor));
+        moreinfo_add_func_with_prefix("DEV", hashkey,
+                (MoreInfoFunc) processor_get_detailed_info, processor, NULL);
         g_free(hashkey);
     }
 
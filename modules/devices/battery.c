@@ -60,7 +60,7 @@ __scan_battery_apcupsd(void)
     int		i;
 
     apcaccess_path = find_program("apcaccess");
-    if (apcaccess_path && (apcaccess = popen(apcaccess_path, "r"))) {
+    if (apcaccess_path && (apcaccess = h_popen(apcaccess_path, "r"))) {
       /* first line isn't important */
       if (fgets(buffer, 512, apcaccess)) {
         /* allocate the key, value hash table */
@@ -91,7 +91,7 @@ __scan_battery_apcupsd(void)
         g_hash_table_destroy(ups_data);
       }
 
-      pclose(apcaccess);
+      h_pclose(apcaccess);
     }
     
     g_free(apcaccess_path);
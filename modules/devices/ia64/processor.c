@@ -196,8 +196,8 @@ gchar *processor_get_info(GSList * processors)
                   processor->cpu_mhz, _("MHz"));
 
         hashkey = g_strdup_printf("CPU%d", processor->id);
-        moreinfo_add_with_prefix("DEV", hashkey,
-                processor_get_detailed_info(processor));
+        moreinfo_add_func_with_prefix("DEV", hashkey,
+                (MoreInfoFunc) processor_get_detailed_info, processor, NULL);
            g_free(hashkey);
     }
 
@@ -59,10 +59,9 @@ static const gchar *find_icon_for_class(uint32_t class)
     return "devices.png";
 }
 
-static gchar *_pci_dev(const pcid *p, gchar *icons) {
+static gchar *_pci_dev_details(const pcid *p) {
     gchar *str;
     gchar *class, *vendor, *svendor, *v_str, *sv_str, *product, *sproduct;
-    gchar *name, *key;
 
     class = UNKIFNULL_AC(p->class_str);
     vendor = UNKIFNULL_AC(p->vendor_id_str);
@@ -91,12 +90,6 @@ static gchar *_pci_dev(const pcid *p, gchar *icons) {
             sv_str = g_strdup(svendor);
     }
 
-    name = g_strdup_printf("%s %s", vendor, product);
-    key = g_strdup_printf("PCI%04x:%02x:%02x.%01x", p->domain, p->bus, p->device, p->function);
-
-    pci_list = h_strdup_cprintf("$%s$%04x:%02x:%02x.%01x=%s\n", pci_list, key, p->domain, p->bus, p->device, p->function, name);
-    icons = h_strdup_cprintf("Icon$%s$%04x:%02x:%02x.%01x=%s\n", icons, key, p->domain, p->bus, p->device, p->function, find_icon_for_class(p->class));
-
     gchar *vendor_device_str;
     if (p->vendor_id == p->sub_vendor_id && p->device_id == p->sub_device_id) {
         vendor_device_str = g_strdup_printf(
@@ -160,48 +153,63 @@ static gchar *_pci_dev(const pcid *p, gchar *icons) {
                 );
 
     g_free(pcie_str);
-
-    moreinfo_add_with_prefix("DEV", key, str); /* str now owned by morinfo */
-
     g_free(vendor_device_str);
     g_free(v_str);
     g_free(sv_str);
-    g_free(name);
-    g_free(key);
 
-    return icons;
+    return str;
+}
+
+/* p becomes owned by moreinfo, which writes its details when shown */
+static void _pci_dev(pcid *p, GString *list, GString *icons) {
+    gchar *vendor, *product, *key, *label;
+
+    vendor = UNKIFNULL_AC(p->vendor_id_str);
+    product = UNKIFNULL_AC(p->device_id_str);
+
+    /* the label is the address, however wide the domain */
+    key = g_strdup_printf("PCI%04x:%02x:%02x.%01x", p->domain, p->bus, p->device, p->function);
+    label = key + strlen("PCI");
+
+    h_string_append_field(list, key, label, "%s %s", vendor, product);
+    g_string_append_printf(icons, "Icon$%s$%s=%s\n", key, label, find_icon_for_class(p->class));
+
+    moreinfo_add_func_with_prefix("DEV", key, (MoreInfoFunc) _pci_dev_details,
+                                  p, (GDestroyNotify) pcid_free);
+    g_free(key);
 }
 
 void scan_pci_do(void) {
+    GString *list, *icons;
 
     if (pci_list) {
         moreinfo_del_with_prefix("DEV:PCI");
         g_free(pci_list);
     }
-    pci_list = g_strdup_printf("[%s]\n", _("PCI Devices"));
-
-    gchar *pci_icons = g_strdup("");
+    list = g_string_new(NULL);
+    icons = g_string_new(NULL);
+    g_string_append_printf(list, "[%s]\n", _("PCI Devices"));
 
-    pcid *list = pci_get_device_list(0,0);
-    pcid *curr = list;
+    pcid *list_head = pci_get_device_list(0,0);
+    pcid *curr = list_head, *next;
 
-    int c = pcid_list_count(list);
-
-    if (c > 0) {
-        while(curr) {
-            pci_icons = _pci_dev(curr, pci_icons);
-            curr=curr->next;
-        }
+    int c = pcid_list_count(list_head);
 
-        pcid_list_free(list);
+    while(curr) {
+        next = curr->next;
+        curr->next = NULL;
+        _pci_dev(curr, list, icons);
+        curr = next;
     }
 
     if (c) {
-        pci_list = g_strconcat(pci_list, "[$ShellParam$]\n", "ViewType=1\n", pci_icons, NULL);
+        g_string_append(list, "[$ShellParam$]\nViewType=1\n");
+        g_string_append_len(list, icons->str, icons->len);
     } else  {
         /* NO PCI? */
-        pci_list = g_strconcat(pci_list, _("No PCI devices found"), "=\n", NULL);
+        h_string_append_field(list, NULL, _("No PCI devices found"), "%s", "");
     }
 
-    g_free(pci_icons);
+    g_string_free(icons, TRUE);
+    pci_list = g_string_free(list, FALSE);
 }
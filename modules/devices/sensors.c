@@ -25,6 +25,8 @@
 #include "udisks2_util.h"
 
 gchar *sensors = NULL;
+/* sensors and lginterval live in these, rebuilt on every scan */
+static GString *sensors_str = NULL, *lginterval_str = NULL;
 GHashTable *sensor_compute = NULL;
 GHashTable *sensor_labels = NULL;
 gboolean hwmon_first_run = TRUE;
@@ -134,13 +136,12 @@ static void add_sensor(const char *type,
                        const char *unit) {
     char key[64];
 
-    sensors = h_strdup_cprintf("%s/%s=%.2f%s|%s\n", sensors,
-        parent, sensor, value, unit, type);
-
     snprintf(key, sizeof(key), "%s/%s", parent, sensor);
+    h_string_append_field(sensors_str, NULL, key, "%.2f%s|%s", value, unit, type);
+
     moreinfo_add_with_prefix("DEV", key, g_strdup_printf("%.2f%s", value, unit));
 
-    lginterval = h_strdup_cprintf("UpdateInterval$%s=1000\n", lginterval, key);
+    g_string_append_printf(lginterval_str, "UpdateInterval$%s=1000\n", key);
 }
 
 static gchar *get_sensor_label_from_conf(gchar *key) {
@@ -530,11 +531,8 @@ void read_sensors_udisks2(void) {
 }
 
 void scan_sensors_do(void) {
-    g_free(sensors);
-    sensors = g_strdup("");
-
-    g_free(lginterval);
-    lginterval = g_strdup("");
+    sensors_str = h_string_reuse(sensors_str);
+    lginterval_str = h_string_reuse(lginterval_str);
 
     read_sensors_hwmon();
     read_sensors_acpi();
@@ -544,6 +542,9 @@ void scan_sensors_do(void) {
     read_sensors_udisks2();
 
     /* FIXME: Add support for  ibm acpi and more sensors */
+
+    sensors = sensors_str->str;
+    lginterval = lginterval_str->str;
 }
 
 void sensors_init(void) {
@@ -555,4 +556,10 @@ void sensors_init(void) {
 void sensors_shutdown(void) {
     g_hash_table_destroy(sensor_labels);
     g_hash_table_destroy(sensor_compute);
+
+    if (sensors_str) {
+        g_string_free(sensors_str, TRUE);
+        g_string_free(lginterval_str, TRUE);
+        sensors = lginterval = NULL;
+    }
 }
@@ -24,56 +24,190 @@
 
 gchar *storage_icons = NULL;
 
+// http://storaged.org/doc/udisks2-api/latest/gdbus-org.freedesktop.UDisks2.Drive.html#gdbus-property-org-freedesktop-UDisks2-Drive.MediaCompatibility
+static const struct {
+    char *media;
+    char *label;
+    char *icon;
+} media_info[] = {
+    { "thumb",                  "Thumb-drive",        "usbfldisk" },
+    { "flash",                  "Flash Card",         "usbfldisk" },
+    { "flash_cf",               "CompactFlash",       "usbfldisk" },
+    { "flash_ms",               "MemoryStick",        "usbfldisk" },
+    { "flash_sm",               "SmartMedia",         "usbfldisk" },
+    { "flash_sd",               "SD",                 "usbfldisk" },
+    { "flash_sdhc",             "SDHC",               "usbfldisk" },
+    { "flash_sdxc",             "SDXC",               "usbfldisk" },
+    { "flash_mmc",              "MMC",                "usbfldisk" },
+    { "floppy",                 "Floppy Disk",        "media-floppy" },
+    { "floppy_zip",             "Zip Disk",           "media-floppy" },
+    { "floppy_jaz",             "Jaz Disk",           "media-floppy" },
+    { "optical",                "Optical Disc",       "cdrom" },
+    { "optical_cd",             "CD-ROM",             "cdrom" },
+    { "optical_cd_r",           "CD-R",               "cdrom" },
+    { "optical_cd_rw",          "CD-RW",              "cdrom" },
+    { "optical_dvd",            "DVD-ROM",            "cdrom" },
+    { "optical_dvd_r",          "DVD-R",              "cdrom" },
+    { "optical_dvd_rw",         "DVD-RW",             "cdrom" },
+    { "optical_dvd_ram",        "DVD-RAM",            "cdrom" },
+    { "optical_dvd_plus_r",     "DVD+R" ,             "cdrom" },
+    { "optical_dvd_plus_rw",    "DVD+RW" ,            "cdrom" },
+    { "optical_dvd_plus_r_dl",  "DVD+R DL",           "cdrom" },
+    { "optical_dvd_plus_rw_dl", "DVD+RW DL",          "cdrom" },
+    { "optical_bd",             "BD-ROM",             "cdrom" },
+    { "optical_bd_r",           "BD-R",               "cdrom" },
+    { "optical_bd_re",          "BD-RE",              "cdrom" },
+    { "optical_hddvd",          "HD DVD-ROM",         "cdrom" },
+    { "optical_hddvd_r",        "HD DVD-R",           "cdrom" },
+    { "optical_hddvd_rw",       "HD DVD-RW",          "cdrom" },
+    { "optical_mo",             "MO Disc",            "cdrom" },
+    { "optical_mrw",            "MRW Media",          "cdrom" },
+    { "optical_mrw_w",          "MRW Media (write)",  "cdrom" },
+    { NULL, NULL }
+};
+
+static gchar *udisks2_drive_label(const udiskd *disk, const gchar **vendor_str) {
+    if (disk->vendor && strlen(disk->vendor) > 0) {
+        *vendor_str = disk->vendor;
+        return g_strdup_printf("%s %s", disk->vendor, disk->model);
+    }
+
+    *vendor_str = disk->model;
+    return g_strdup(disk->model);
+}
+
+static gchar *udisks2_drive_details(const udiskd *disk) {
+    gchar *features = NULL, *moreinfo = NULL;
+    gchar *label, *media_comp = NULL;
+    const gchar *url, *vendor_str, *media_label, *media_curr = NULL;
+    int i, j;
+
+    label = udisks2_drive_label(disk, &vendor_str);
+
+    media_curr = disk->media;
+    if (disk->media){
+        for (j = 0; media_info[j].media != NULL; j++) {
+            if (g_strcmp0(disk->media, media_info[j].media) == 0) {
+                media_curr = media_info[j].label;
+                break;
+            }
+        }
+    }
+
+    if (disk->media_compatibility){
+        for (i = 0; disk->media_compatibility[i] != NULL; i++){
+            media_label = disk->media_compatibility[i];
+
+            for (j = 0; media_info[j].media != NULL; j++) {
+                if (g_strcmp0(disk->media_compatibility[i], media_info[j].media) == 0) {
+                    media_label = media_info[j].label;
+                    break;
+                }
+            }
+
+            if (media_comp == NULL){
+                media_comp = g_strdup(media_label);
+            }
+            else{
+                media_comp = h_strdup_cprintf(", %s", media_comp, media_label);
+            }
+        }
+    }
+
+    url = vendor_get_url(vendor_str);
+    features = h_strdup_cprintf("%s", features, disk->removable ? _("Removable"): _("Fixed"));
+    if (disk->ejectable) {
+        features = h_strdup_cprintf(", %s", features, _("Ejectable"));
+    }
+    if (disk->smart_supported) {
+        features = h_strdup_cprintf(", %s", features, _("Self-monitoring (S.M.A.R.T.)"));
+    }
+    if (disk->pm_supported) {
+        features = h_strdup_cprintf(", %s", features, _("Power Management"));
+    }
+    if (disk->apm_supported) {
+        features = h_strdup_cprintf(", %s", features, _("Advanced Power Management"));
+    }
+    if (disk->aam_supported) {
+        features = h_strdup_cprintf(", %s", features, _("Automatic Acoustic Management"));
+    }
+
+    moreinfo = g_strdup_printf(_("[Drive Information]\n"
+                               "Model=%s\n"),
+                               label);
+    if (url) {
+        moreinfo = h_strdup_cprintf(_("Vendor=%s (%s)\n"),
+                                     moreinfo,
+                                     vendor_get_name(vendor_str),
+                                     url);
+    }
+    else {
+        moreinfo = h_strdup_cprintf(_("Vendor=%s\n"),
+                                     moreinfo,
+                                     vendor_get_name(vendor_str));
+    }
+
+    moreinfo = h_strdup_cprintf(_("Revision=%s\n"
+                                "Block Device=%s\n"
+                                "Serial=%s\n"
+                                "Size=%s\n"
+                                "Features=%s\n"),
+                                moreinfo,
+                                disk->revision,
+                                disk->block_dev,
+                                disk->serial,
+                                size_human_readable((gfloat) disk->size),
+                                features);
+
+    if (disk->rotation_rate > 0) {
+        moreinfo = h_strdup_cprintf(_("Rotation Rate=%d\n"), moreinfo, disk->rotation_rate);
+    }
+    if (media_comp || media_curr) {
+        moreinfo = h_strdup_cprintf(_("Media=%s\n"
+                                    "Media compatibility=%s\n"),
+                                    moreinfo,
+                                    media_curr ? media_curr : _("(None)"),
+                                    media_comp ? media_comp : _("(Unknown)"));
+    }
+    if (disk->connection_bus && strlen(disk->connection_bus) > 0) {
+        moreinfo = h_strdup_cprintf(_("Connection bus=%s\n"), moreinfo, disk->connection_bus);
+    }
+    if (disk->smart_enabled) {
+        moreinfo = h_strdup_cprintf(_("[Self-monitoring (S.M.A.R.T.)]\n"
+                                    "Status=%s\n"
+                                    "Bad Sectors=%ld\n"
+                                    "Power on time=%d days %d hours\n"
+                                    "Temperature=%d°C\n"),
+                                    moreinfo,
+                                    disk->smart_failing ? _("Failing"): _("OK"),
+                                    disk->smart_bad_sectors,
+                                    disk->smart_poweron/(60*60*24), (disk->smart_poweron/60/60) % 24,
+                                    disk->smart_temperature);
+    }
+    if (disk->partition_table || disk->partitions) {
+        moreinfo = h_strdup_cprintf(_("[Partition table]\n"
+                                    "Type=%s\n"
+                                    "Partitions=%s\n"),
+                                    moreinfo,
+                                    disk->partition_table ? disk->partition_table : _("(Unknown)"),
+                                    disk->partitions ? disk->partitions : _("(Unknown)"));
+    }
+
+    g_free(features);
+    g_free(label);
+    g_free(media_comp);
+
+    return moreinfo;
+}
+
 gboolean __scan_udisks2_devices(void) {
     GSList *node, *drives;
     udiskd *disk;
-    gchar *udisks2_storage_list = NULL, *features = NULL, *moreinfo = NULL;
-    gchar *devid, *label, *media_comp = NULL;
-    const gchar *url, *vendor_str, *media_label, *icon, *media_curr = NULL;
+    gchar *udisks2_storage_list = NULL;
+    gchar *devid, *label;
+    const gchar *vendor_str, *icon;
     int n = 0, i, j;
 
-    // http://storaged.org/doc/udisks2-api/latest/gdbus-org.freedesktop.UDisks2.Drive.html#gdbus-property-org-freedesktop-UDisks2-Drive.MediaCompatibility
-    static struct {
-        char *media;
-        char *label;
-        char *icon;
-    } media_info[] = {
-        { "thumb",                  "Thumb-drive",        "usbfldisk" },
-        { "flash",                  "Flash Card",         "usbfldisk" },
-        { "flash_cf",               "CompactFlash",       "usbfldisk" },
-        { "flash_ms",               "MemoryStick",        "usbfldisk" },
-        { "flash_sm",               "SmartMedia",         "usbfldisk" },
-        { "flash_sd",               "SD",                 "usbfldisk" },
-        { "flash_sdhc",             "SDHC",               "usbfldisk" },
-        { "flash_sdxc",             "SDXC",               "usbfldisk" },
-        { "flash_mmc",              "MMC",                "usbfldisk" },
-        { "floppy",                 "Floppy Disk",        "media-floppy" },
-        { "floppy_zip",             "Zip Disk",           "media-floppy" },
-        { "floppy_jaz",             "Jaz Disk",           "media-floppy" },
-        { "optical",                "Optical Disc",       "cdrom" },
-        { "optical_cd",             "CD-ROM",             "cdrom" },
-        { "optical_cd_r",           "CD-R",               "cdrom" },
-        { "optical_cd_rw",          "CD-RW",              "cdrom" },
-        { "optical_dvd",            "DVD-ROM",            "cdrom" },
-        { "optical_dvd_r",          "DVD-R",              "cdrom" },
-        { "optical_dvd_rw",         "DVD-RW",             "cdrom" },
-        { "optical_dvd_ram",        "DVD-RAM",            "cdrom" },
-        { "optical_dvd_plus_r",     "DVD+R" ,             "cdrom" },
-        { "optical_dvd_plus_rw",    "DVD+RW" ,            "cdrom" },
-        { "optical_dvd_plus_r_dl",  "DVD+R DL",           "cdrom" },
-        { "optical_dvd_plus_rw_dl", "DVD+RW DL",          "cdrom" },
-        { "optical_bd",             "BD-ROM",             "cdrom" },
-        { "optical_bd_r",           "BD-R",               "cdrom" },
-        { "optical_bd_re",          "BD-RE",              "cdrom" },
-        { "optical_hddvd",          "HD DVD-ROM",         "cdrom" },
-        { "optical_hddvd_r",        "HD DVD-R",           "cdrom" },
-        { "optical_hddvd_rw",       "HD DVD-RW",          "cdrom" },
-        { "optical_mo",             "MO Disc",            "cdrom" },
-        { "optical_mrw",            "MRW Media",          "cdrom" },
-        { "optical_mrw_w",          "MRW Media (write)",  "cdrom" },
-        { NULL, NULL }
-    };
-
     moreinfo_del_with_prefix("DEV:UDISKS");
     udisks2_storage_list = g_strdup(_("\n[UDisks2]\n"));
 
@@ -81,47 +215,18 @@ gboolean __scan_udisks2_devices(void) {
     for (node = drives; node != NULL; node = node->next) {
         disk = (udiskd *)node->data;
         devid = g_strdup_printf("UDISKS%d", n++);
-
-        if (disk->vendor && strlen(disk->vendor) > 0) {
-            label = g_strdup_printf("%s %s", disk->vendor, disk->model);
-            vendor_str = disk->vendor;
-        }
-        else{
-            label = g_strdup(disk->model);
-            vendor_str = disk->model;
-        }
+        label = udisks2_drive_label(disk, &vendor_str);
 
         icon = NULL;
 
-        media_curr = disk->media;
-        if (disk->media){
-            for (j = 0; media_info[j].media != NULL; j++) {
-                if (g_strcmp0(disk->media, media_info[j].media) == 0) {
-                    media_curr = media_info[j].label;
-                    break;
-                }
-            }
-        }
-
         if (disk->media_compatibility){
-            for (i = 0; disk->media_compatibility[i] != NULL; i++){
-                media_label = disk->media_compatibility[i];
-
+            for (i = 0; disk->media_compatibility[i] != NULL && icon == NULL; i++){
                 for (j = 0; media_info[j].media != NULL; j++) {
                     if (g_strcmp0(disk->media_compatibility[i], media_info[j].media) == 0) {
-                        media_label = media_info[j].label;
-                        if (icon == NULL)
-                            icon = media_info[j].icon;
+                        icon = media_info[j].icon;
                         break;
                     }
                 }
-
-                if (media_comp == NULL){
-                    media_comp = g_strdup(media_label);
-                }
-                else{
-                    media_comp = h_strdup_cprintf(", %s", media_comp, media_label);
-                }
             }
         }
         if (icon == NULL && disk->ejectable && g_strcmp0(disk->connection_bus, "usb") == 0) {
@@ -131,100 +236,14 @@ gboolean __scan_udisks2_devices(void) {
             icon = "hdd";
         }
 
-        url = vendor_get_url(vendor_str);
         udisks2_storage_list = h_strdup_cprintf("$%s$%s=\n", udisks2_storage_list, devid, label);
         storage_icons = h_strdup_cprintf("Icon$%s$%s=%s.png\n", storage_icons, devid, label, icon);
-        features = h_strdup_cprintf("%s", features, disk->removable ? _("Removable"): _("Fixed"));
 
-        if (disk->ejectable) {
-            features = h_strdup_cprintf(", %s", features, _("Ejectable"));
-        }
-        if (disk->smart_supported) {
-            features = h_strdup_cprintf(", %s", features, _("Self-monitoring (S.M.A.R.T.)"));
-        }
-        if (disk->pm_supported) {
-            features = h_strdup_cprintf(", %s", features, _("Power Management"));
-        }
-        if (disk->apm_supported) {
-            features = h_strdup_cprintf(", %s", features, _("Advanced Power Management"));
-        }
-        if (disk->aam_supported) {
-            features = h_strdup_cprintf(", %s", features, _("Automatic Acoustic Management"));
-        }
-
-        moreinfo = g_strdup_printf(_("[Drive Information]\n"
-                                   "Model=%s\n"),
-                                   label);
-        if (url) {
-            moreinfo = h_strdup_cprintf(_("Vendor=%s (%s)\n"),
-                                         moreinfo,
-                                         vendor_get_name(vendor_str),
-                                         url);
-        }
-        else {
-            moreinfo = h_strdup_cprintf(_("Vendor=%s\n"),
-                                         moreinfo,
-                                         vendor_get_name(vendor_str));
-        }
-
-        moreinfo = h_strdup_cprintf(_("Revision=%s\n"
-                                    "Block Device=%s\n"
-                                    "Serial=%s\n"
-                                    "Size=%s\n"
-                                    "Features=%s\n"),
-                                    moreinfo,
-                                    disk->revision,
-                                    disk->block_dev,
-                                    disk->serial,
-                                    size_human_readable((gfloat) disk->size),
-                                    features);
-
-        if (disk->rotation_rate > 0) {
-            moreinfo = h_strdup_cprintf(_("Rotation Rate=%d\n"), moreinfo, disk->rotation_rate);
-        }
-        if (media_comp || media_curr) {
-            moreinfo = h_strdup_cprintf(_("Media=%s\n"
-                                        "Media compatibility=%s\n"),
-                                        moreinfo,
-                                        media_curr ? media_curr : _("(None)"),
-                                        media_comp ? media_comp : _("(Unknown)"));
-        }
-        if (disk->connection_bus && strlen(disk->connection_bus) > 0) {
-            moreinfo = h_strdup_cprintf(_("Connection bus=%s\n"), moreinfo, disk->connection_bus);
-        }
-        if (disk->smart_enabled) {
-            moreinfo = h_strdup_cprintf(_("[Self-monitoring (S.M.A.R.T.)]\n"
-                                        "Status=%s\n"
-                                        "Bad Sectors=%ld\n"
-                                        "Power on time=%d days %d hours\n"
-                                        "Temperature=%d°C\n"),
-                                        moreinfo,
-                                        disk->smart_failing ? _("Failing"): _("OK"),
-                                        disk->smart_bad_sectors,
-                                        disk->smart_poweron/(60*60*24), (disk->smart_poweron/60/60) % 24,
-                                        disk->smart_temperature);
-        }
-        if (disk->partition_table || disk->partitions) {
-            moreinfo = h_strdup_cprintf(_("[Partition table]\n"
-                                        "Type=%s\n"
-                                        "Partitions=%s\n"),
-                                        moreinfo,
-                                        disk->partition_table ? disk->partition_table : _("(Unknown)"),
-                                        disk->partitions ? disk->partitions : _("(Unknown)"));
-        }
-
-        moreinfo_add_with_prefix("DEV", devid, moreinfo);
+        /* disk becomes owned by moreinfo, which writes its details when shown */
+        moreinfo_add_func_with_prefix("DEV", devid, (MoreInfoFunc) udisks2_drive_details,
+                                      disk, (GDestroyNotify) udiskd_free);
         g_free(devid);
-        g_free(features);
         g_free(label);
-        g_free(media_comp);
-        media_comp = NULL;
-
-        features = NULL;
-        moreinfo = NULL;
-        devid = NULL;
-
-        udiskd_free(disk);
     }
     g_slist_free(drives);
 
@@ -259,7 +278,7 @@ void __scan_scsi_devices(void)
     int otype = 0;
     if (proc_scsi = fopen("/proc/scsi/scsi", "r")) {
         otype = 1;
-    } else if (proc_scsi = popen("lsscsi -c", "r")) {
+    } else if (proc_scsi = h_popen("lsscsi -c", "r")) {
         otype = 2;
     }
 
@@ -367,7 +386,7 @@ void __scan_scsi_devices(void)
         if (otype == 1)
             fclose(proc_scsi);
         else if (otype == 2)
-            pclose(proc_scsi);
+            h_pclose(proc_scsi);
     }
 
     if (n) {
@@ -427,7 +446,7 @@ void __scan_ide_devices(void)
 		gchar *tmp = g_strdup_printf("cdrecord dev=/dev/hd%c -prcap 2>/dev/stdout", iface);
 		FILE *prcap;
 
-		if ((prcap = popen(tmp, "r"))) {
+		if ((prcap = h_popen(tmp, "r"))) {
 		    /* we need a timeout so cdrecord does not try to get information on cd drives
 		       with inserted media, which is not possible currently. half second should be
 		       enough. */
@@ -473,7 +492,7 @@ void __scan_ide_devices(void)
 			}
 		    }
 
-		    pclose(prcap);
+		    h_pclose(prcap);
 		    g_timer_destroy(timer);
 		}
 
@@ -97,27 +97,18 @@ static const char* get_usbdev_icon(const usbd *u) {
     return icon;
 }
 
-static void _usb_dev(const usbd *u) {
-    gchar *name, *key, *v_str, *label, *str;
+static gchar *_usb_dev_details(const usbd *u) {
+    gchar *v_str, *str;
     gchar *product, *vendor, *dev_class_str, *dev_subclass_str; /* don't free */
     gchar *if_class_str, *if_subclass_str, *if_protocol_str;    /* don't free */
-    gchar *interfaces = strdup("");
+    GString *interfaces = g_string_new(NULL);
     usbi *i;
-    const char* icon;
 
     vendor = UNKIFNULL_AC(u->vendor);
     product = UNKIFNULL_AC(u->product);
     dev_class_str = UNKIFNULL_AC(u->dev_class_str);
     dev_subclass_str = UNKIFNULL_AC(u->dev_subclass_str);
 
-    name = g_strdup_printf("%s %s", vendor, product);
-    key = g_strdup_printf("USB%03d:%03d:%03d", u->bus, u->dev, 0);
-    label = g_strdup_printf("%03d:%03d", u->bus, u->dev);
-    icon = get_usbdev_icon(u);
-
-    usb_list = h_strdup_cprintf("$%s$%s=%s\n", usb_list, key, label, name);
-    usb_icons = h_strdup_cprintf("Icon$%s$%s=%s.png\n", usb_icons, key, label, icon ? icon: "usb");
-
     const gchar *v_url = vendor_get_url(vendor);
     const gchar *v_name = vendor_get_name(vendor);
     if (v_url != NULL) {
@@ -133,11 +124,10 @@ static void _usb_dev(const usbd *u) {
             if_subclass_str = UNKIFNULL_AC(i->if_subclass_str);
             if_protocol_str = UNKIFNULL_AC(i->if_protocol_str);
 
-            interfaces = h_strdup_cprintf("[%s %d]\n"
+            g_string_append_printf(interfaces, "[%s %d]\n"
                 /* Class */       "%s=[%d] %s\n"
                 /* Sub-class */   "%s=[%d] %s\n"
                 /* Protocol */    "%s=[%d] %s\n",
-                    interfaces,
                     _("Interface"), i->if_number,
                     _("Class"), i->if_class, if_class_str,
                     _("Sub-class"), i->if_subclass, if_subclass_str,
@@ -170,21 +160,42 @@ static void _usb_dev(const usbd *u) {
                 _("Connection"),
                 _("Bus"), u->bus,
                 _("Device"), u->dev,
-                interfaces
+                interfaces->str
                 );
 
-    moreinfo_add_with_prefix("DEV", key, str); /* str now owned by morinfo */
-
     g_free(v_str);
-    g_free(name);
+    g_string_free(interfaces, TRUE);
+
+    return str;
+}
+
+/* u becomes owned by moreinfo, which writes its details when shown */
+static void _usb_dev(usbd *u, GString *list, GString *icons) {
+    gchar *key, *label;
+    gchar *product, *vendor; /* don't free */
+    const char* icon;
+
+    vendor = UNKIFNULL_AC(u->vendor);
+    product = UNKIFNULL_AC(u->product);
+
+    key = g_strdup_printf("USB%03d:%03d:%03d", u->bus, u->dev, 0);
+    label = g_strdup_printf("%03d:%03d", u->bus, u->dev);
+    icon = get_usbdev_icon(u);
+
+    h_string_append_field(list, key, label, "%s %s", vendor, product);
+    g_string_append_printf(icons, "Icon$%s$%s=%s.png\n", key, label, icon ? icon: "usb");
+
+    moreinfo_add_func_with_prefix("DEV", key, (MoreInfoFunc) _usb_dev_details,
+                                  u, (GDestroyNotify) usbd_free);
+
     g_free(key);
     g_free(label);
-    g_free(interfaces);
 }
 
 void __scan_usb(void) {
     usbd *list = usb_get_device_list();
-    usbd *curr = list;
+    usbd *curr = list, *next;
+    GString *devices, *icons;
 
     int c = usbd_list_count(list);
 
@@ -196,17 +207,22 @@ void __scan_usb(void) {
        g_free(usb_icons);
        usb_icons = NULL;
     }
-    usb_list = g_strdup_printf("[%s]\n", _("USB Devices"));
+    devices = g_string_new(NULL);
+    icons = g_string_new(NULL);
+    g_string_append_printf(devices, "[%s]\n", _("USB Devices"));
 
     if (c > 0) {
         while(curr) {
-            _usb_dev(curr);
-            curr=curr->next;
+            next = curr->next;
+            curr->next = NULL;
+            _usb_dev(curr, devices, icons);
+            curr = next;
         }
-
-        usbd_list_free(list);
     } else {
         /* No USB? */
-        usb_list = g_strconcat(usb_list, _("No USB devices found."), "=\n", NULL);
+        h_string_append_field(devices, NULL, _("No USB devices found."), "%s", "");
     }
+
+    usb_list = g_string_free(devices, FALSE);
+    usb_icons = g_string_free(icons, FALSE);
 }
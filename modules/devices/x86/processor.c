@@ -265,13 +265,15 @@ static gint cmp_cpufreq_data_ignore_affected(cpufreq_data *a, cpufreq_data *b) {
 
 gchar *clocks_summary(GSList * processors)
 {
-    gchar *ret = g_strdup_printf("[%s]\n", _("Clocks"));
+    GString *ret = g_string_new(NULL);
     GSList *all_clocks = NULL, *uniq_clocks = NULL;
     GSList *tmp, *l;
     Processor *p;
     cpufreq_data *c, *cur = NULL;
     gint cur_count = 0, i = 0;
 
+    g_string_append_printf(ret, "[%s]\n", _("Clocks"));
+
     /* create list of all clock references */
     for (l = processors; l; l = l->next) {
         p = (Processor*)l->data;
@@ -281,9 +283,9 @@ gchar *clocks_summary(GSList * processors)
     }
 
     if (g_slist_length(all_clocks) == 0) {
-        ret = h_strdup_cprintf("%s=\n", ret, _("(Not Available)") );
+        h_string_append_field(ret, NULL, _("(Not Available)"), "%s", "");
         g_slist_free(all_clocks);
-        return ret;
+        return g_string_free(ret, FALSE);
     }
 
     /* ignore duplicate references */
@@ -311,8 +313,7 @@ gchar *clocks_summary(GSList * processors)
             cur_count = 1;
         } else {
             if (cmp_cpufreq_data_ignore_affected(cur, c) != 0) {
-                ret = h_strdup_cprintf(_("%.2f-%.2f %s=%dx\n"),
-                                ret,
+                g_string_append_printf(ret, _("%.2f-%.2f %s=%dx\n"),
                                 khzint_to_mhzdouble(cur->cpukhz_min),
                                 khzint_to_mhzdouble(cur->cpukhz_max),
                                 _("MHz"),
@@ -324,8 +325,7 @@ gchar *clocks_summary(GSList * processors)
             }
         }
     }
-    ret = h_strdup_cprintf(_("%.2f-%.2f %s=%dx\n"),
-                    ret,
+    g_string_append_printf(ret, _("%.2f-%.2f %s=%dx\n"),
                     khzint_to_mhzdouble(cur->cpukhz_min),
                     khzint_to_mhzdouble(cur->cpukhz_max),
                     _("MHz"),
@@ -333,7 +333,7 @@ gchar *clocks_summary(GSList * processors)
 
     g_slist_free(all_clocks);
     g_slist_free(uniq_clocks);
-    return ret;
+    return g_string_free(ret, FALSE);
 }
 
 #define cmp_cache_test(f) if (a->f < b->f) return -1; if (a->f > b->f) return 1;
@@ -364,13 +364,15 @@ static gint cmp_cache_ignore_id(ProcessorCache *a, ProcessorCache *b) {
 
 gchar *caches_summary(GSList * processors)
 {
-    gchar *ret = g_strdup_printf("[%s]\n", _("Caches"));
+    GString *ret = g_string_new(NULL);
     GSList *all_cache = NULL, *uniq_cache = NULL;
     GSList *tmp, *l;
     Processor *p;
     ProcessorCache *c, *cur = NULL;
     gint cur_count = 0, i = 0;
 
+    g_string_append_printf(ret, "[%s]\n", _("Caches"));
+
     /* create list of all cache references */
     for (l = processors; l; l = l->next) {
         p = (Processor*)l->data;
@@ -385,9 +387,9 @@ gchar *caches_summary(GSList * processors)
     }
 
     if (g_slist_length(all_cache) == 0) {
-        ret = h_strdup_cprintf("%s=\n", ret, _("(Not Available)") );
+        h_string_append_field(ret, NULL, _("(Not Available)"), "%s", "");
         g_slist_free(all_cache);
-        return ret;
+        return g_string_free(ret, FALSE);
     }
 
     /* ignore duplicate references */
@@ -415,8 +417,7 @@ gchar *caches_summary(GSList * processors)
             cur_count = 1;
         } else {
             if (cmp_cache_ignore_id(cur, c) != 0) {
-                ret = h_strdup_cprintf(_("Level %d (%s)#%d=%dx %dKB (%dKB), %d-way set-associative, %d sets\n"),
-                                      ret,
+                g_string_append_printf(ret, _("Level %d (%s)#%d=%dx %dKB (%dKB), %d-way set-associative, %d sets\n"),
                                       cur->level,
                                       C_("cache-type", cur->type),
                                       cur->phy_sock,
@@ -432,8 +433,7 @@ gchar *caches_summary(GSList * processors)
             }
         }
     }
-    ret = h_strdup_cprintf(_("Level %d (%s)#%d=%dx %dKB (%dKB), %d-way set-associative, %d sets\n"),
-                          ret,
+    g_string_append_printf(ret, _("Level %d (%s)#%d=%dx %dKB (%dKB), %d-way set-associative, %d sets\n"),
                           cur->level,
                           C_("cache-type", cur->type),
                           cur->phy_sock,
@@ -445,7 +445,7 @@ gchar *caches_summary(GSList * processors)
 
     g_slist_free(all_cache);
     g_slist_free(uniq_cache);
-    return ret;
+    return g_string_free(ret, FALSE);
 }
 
 #define PROC_SCAN_READ_BUFFER_SIZE 896
@@ -577,7 +577,7 @@ gchar *processor_get_capabilities_from_flags(gchar *strflags, gchar *lookup_pref
     gchar **flags, **old;
     gchar tmp_flag[64] = "";
     const gchar *meaning;
-    gchar *tmp = NULL;
+    GString *tmp = g_string_new(NULL);
     gint j = 0, i = 0;
 
     flags = g_strsplit(strflags, " ", 0);
@@ -587,26 +587,22 @@ gchar *processor_get_capabilities_from_flags(gchar *strflags, gchar *lookup_pref
         if ( sscanf(flags[j], "[%d]", &i) ) {
             /* Some flags are indexes, like [13], and that looks like
              * a new section to hardinfo shell */
-            tmp = h_strdup_cprintf("(%s%d)=\n", tmp,
+            g_string_append_printf(tmp, "(%s%d)=\n",
                 (lookup_prefix) ? lookup_prefix : "",
                 i );
         } else {
             sprintf(tmp_flag, "%s%s", lookup_prefix, flags[j]);
             meaning = x86_flag_meaning(tmp_flag);
 
-            if (meaning) {
-                tmp = h_strdup_cprintf("%s=%s\n", tmp, flags[j], meaning);
-            } else {
-                tmp = h_strdup_cprintf("%s=\n", tmp, flags[j]);
-            }
+            h_string_append_field(tmp, NULL, flags[j], "%s", meaning ? meaning : "");
         }
         j++;
     }
-    if (tmp == NULL || g_strcmp0(tmp, "") == 0)
-        tmp = g_strdup_printf("%s=%s\n", "empty", _("Empty List"));
+    if (tmp->len == 0)
+        h_string_append_field(tmp, NULL, "empty", "%s", _("Empty List"));
 
     g_strfreev(old);
-    return tmp;
+    return g_string_free(tmp, FALSE);
 }
 
 gchar *processor_get_detailed_info(Processor * processor)
@@ -760,40 +756,37 @@ gchar *processor_meta(GSList * processors) {
 gchar *processor_get_info(GSList * processors)
 {
     Processor *processor;
-    gchar *ret, *tmp, *hashkey;
-    gchar *meta; /* becomes owned by more_info? no need to free? */
+    GString *ret;
+    gchar *hashkey;
     GSList *l;
 
-    tmp = g_strdup_printf("$!CPU_META$%s=\n", _("Package Information") );
+    ret = g_string_new(NULL);
+    g_string_append_printf(ret, "[$ShellParam$]\n"
+                  "ViewType=1\n"
+                  "ColumnTitle$Extra1=%s\n"
+                  "ColumnTitle$Extra2=%s\n"
+                  "[Processors]\n", _("Socket:Core"), _("Thread" /*TODO: +s*/));
+    h_string_append_field(ret, "!CPU_META", _("Package Information"), "%s", "");
 
-    meta = processor_meta(processors);
-    moreinfo_add_with_prefix("DEV", "CPU_META", meta);
+    moreinfo_add_func_with_prefix("DEV", "CPU_META",
+            (MoreInfoFunc) processor_meta, processors, NULL);
 
     for (l = processors; l; l = l->next) {
         processor = (Processor *) l->data;
 
-        tmp = g_strdup_printf("%s$CPU%d$%s=%.2f %s|%d:%d|%d\n",
-                  tmp, processor->id,
-                  processor->model_name,
+        hashkey = g_strdup_printf("CPU%d", processor->id);
+        h_string_append_field(ret, hashkey, processor->model_name,
+                  "%.2f %s|%d:%d|%d",
                   processor->cpu_mhz, _("MHz"),
                   processor->cputopo->socket_id,
                   processor->cputopo->core_id,
                   processor->cputopo->id );
 
-        hashkey = g_strdup_printf("CPU%d", processor->id);
-        moreinfo_add_with_prefix("DEV", hashkey,
-                processor_get_detailed_info(processor));
+        moreinfo_add_func_with_prefix("DEV", hashkey,
+                (MoreInfoFunc) processor_get_detailed_info, processor, NULL);
         g_free(hashkey);
     }
 
-    ret = g_strdup_printf("[$ShellParam$]\n"
-                  "ViewType=1\n"
-                  "ColumnTitle$Extra1=%s\n"
-                  "ColumnTitle$Extra2=%s\n"
-                  "[Processors]\n"
-                  "%s", _("Socket:Core"), _("Thread" /*TODO: +s*/), tmp);
-    g_free(tmp);
-
-    return ret;
+    return g_string_free(ret, FALSE);
 }
 
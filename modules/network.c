@@ -58,13 +58,13 @@ void scan_arp(gboolean reload);
 void scan_statistics(gboolean reload);
 
 static ModuleEntry entries[] = {
-    {N_("Interfaces"), "network-interface.png", callback_network, scan_network, MODULE_FLAG_NONE},
-    {N_("IP Connections"), "network-connections.png", callback_connections, scan_connections, MODULE_FLAG_NONE},
-    {N_("Routing Table"), "network.png", callback_route, scan_route, MODULE_FLAG_NONE},
-    {N_("ARP Table"), "module.png", callback_arp, scan_arp, MODULE_FLAG_NONE},
-    {N_("DNS Servers"), "dns.png", callback_dns, scan_dns, MODULE_FLAG_NONE},
-    {N_("Statistics"), "network-statistics.png", callback_statistics, scan_statistics, MODULE_FLAG_NONE},
-    {N_("Shared Directories"), "shares.png", callback_shares, scan_shares, MODULE_FLAG_NONE},
+    {N_("Interfaces"), "network-interface.png", callback_network, scan_network, MODULE_FLAG_INDEPENDENT},
+    {N_("IP Connections"), "network-connections.png", callback_connections, scan_connections, MODULE_FLAG_INDEPENDENT},
+    {N_("Routing Table"), "network.png", callback_route, scan_route, MODULE_FLAG_INDEPENDENT},
+    {N_("ARP Table"), "module.png", callback_arp, scan_arp, MODULE_FLAG_INDEPENDENT},
+    {N_("DNS Servers"), "dns.png", callback_dns, scan_dns, MODULE_FLAG_INDEPENDENT},
+    {N_("Statistics"), "network-statistics.png", callback_statistics, scan_statistics, MODULE_FLAG_INDEPENDENT},
+    {N_("Shared Directories"), "shares.png", callback_shares, scan_shares, MODULE_FLAG_INDEPENDENT},
     {NULL},
 };
 
@@ -92,7 +92,7 @@ void scan_statistics(gboolean reload)
     if ((netstat_path = find_program("netstat"))) {
       gchar *command_line = g_strdup_printf("%s -s", netstat_path);
 
-      if ((netstat = popen(command_line, "r"))) {
+      if ((netstat = h_popen(command_line, "r"))) {
         while (fgets(buffer, 256, netstat)) {
           if (!isspace(buffer[0]) && strchr(buffer, ':')) {
             gchar *tmp;
@@ -120,7 +120,7 @@ void scan_statistics(gboolean reload)
           }
         }
 
-        pclose(netstat);
+        h_pclose(netstat);
       }
 
       g_free(command_line);
@@ -195,7 +195,7 @@ void scan_route(gboolean reload)
     if ((route_path = find_program("route"))) {
       gchar *command_line = g_strdup_printf("%s -n", route_path);
 
-      if ((route = popen(command_line, "r"))) {
+      if ((route = h_popen(command_line, "r"))) {
         /* eat first two lines */
         (void)fgets(buffer, 256, route);
         (void)fgets(buffer, 256, route);
@@ -214,7 +214,7 @@ void scan_route(gboolean reload)
                                              g_strstrip(buffer + 32));
         }
 
-        pclose(route);
+        h_pclose(route);
       }
 
       g_free(command_line);
@@ -271,7 +271,7 @@ void scan_connections(gboolean reload)
     if ((netstat_path = find_program("netstat"))) {
       gchar *command_line = g_strdup_printf("%s -an", netstat_path);
 
-      if ((netstat = popen("netstat -an", "r"))) {
+      if ((netstat = h_popen("netstat -an", "r"))) {
         while (fgets(buffer, 256, netstat)) {
           buffer[6] = '\0';
           buffer[43] = '\0';
@@ -287,7 +287,7 @@ void scan_connections(gboolean reload)
           }
         }
 
-        pclose(netstat);
+        h_pclose(netstat);
       }
 
       g_free(command_line);
@@ -328,6 +328,7 @@ static void scan_net_interfaces_24(void)
     NetInfo ni;
     gchar buffer[256];
     gchar *devid, *detailed;
+    GString *interfaces, *icons;
     gdouble recv_bytes;
     gdouble recv_errors;
     gdouble recv_packets;
@@ -346,18 +347,13 @@ static void scan_net_interfaces_24(void)
     return;
     }
 
-    g_free(network_interfaces);
-
-    g_free(network_icons);
-
-    network_interfaces = g_strdup_printf("[%s]\n", _("Network Interfaces"));
-    network_icons = g_strdup("");
+    interfaces = g_string_new(NULL);
+    icons = g_string_new(NULL);
+    g_string_append_printf(interfaces, "[%s]\n", _("Network Interfaces"));
 
     proc_net = fopen("/proc/net/dev", "r");
-    if (!proc_net)
-        return;
 
-    while (fgets(buffer, 256, proc_net)) {
+    while (proc_net && fgets(buffer, 256, proc_net)) {
     if (strchr(buffer, ':')) {
         gint trash;
         gchar ifacename[16];
@@ -388,16 +384,13 @@ static void scan_net_interfaces_24(void)
 
         devid = g_strdup_printf("NET%s", ifacename);
 
-        network_interfaces =
-        h_strdup_cprintf
-        ("$%s$%s=%s|%.2lf%s|%.2lf%s\n",
-         network_interfaces, devid, ifacename, ni.ip[0] ? ni.ip : "",
+        h_string_append_field(interfaces, devid, ifacename, "%s|%.2lf%s|%.2lf%s",
+         ni.ip[0] ? ni.ip : "",
          trans_mb, _("MiB"), recv_mb, _("MiB"));
         net_get_iface_type(ifacename, &iface_type, &iface_icon, &ni);
 
-        network_icons = h_strdup_cprintf("Icon$%s$%s=%s.png\n",
-                         network_icons, devid,
-                         ifacename, iface_icon);
+        g_string_append_printf(icons, "Icon$%s$%s=%s.png\n",
+                         devid, ifacename, iface_icon);
 
         detailed = g_strdup_printf("[%s]\n"
                        "%s=%s\n" /* Interface Type */
@@ -479,7 +472,13 @@ static void scan_net_interfaces_24(void)
         g_free(devid);
     }
     }
-    fclose(proc_net);
+    if (proc_net)
+        fclose(proc_net);
+
+    g_free(network_interfaces);
+    g_free(network_icons);
+    network_interfaces = g_string_free(interfaces, FALSE);
+    network_icons = g_string_free(icons, FALSE);
 }
 
 void scan_net_interfaces(void)
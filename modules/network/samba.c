@@ -57,7 +57,7 @@ scan_samba_usershares(void)
     gchar *usershare, *cmdline;
     gsize length;
 
-    spawned = g_spawn_command_line_sync("net usershare list",
+    spawned = h_spawn_command_line_sync("net usershare list",
             &out, &err, &status, NULL);
 
     if (spawned && status == 0 && out != NULL) {
@@ -66,7 +66,7 @@ scan_samba_usershares(void)
         while(next_nl = strchr(p, '\n')) {
             cmdline = g_strdup_printf("net usershare info '%s'",
                                       strend(p, '\n'));
-            if (g_spawn_command_line_sync(cmdline,
+            if (h_spawn_command_line_sync(cmdline,
                         &usershare, NULL, NULL, NULL)) {
                 length = strlen(usershare);
                 scan_samba_from_string(usershare, length);
@@ -57,20 +57,16 @@ void cb_copy_to_clipboard()
     ShellModuleEntry *entry = shell_get_main_shell()->selected;
 
     if (entry) {
-	gchar *data = module_entry_function(entry);
 	GtkClipboard *clip =
 	    gtk_clipboard_get(gdk_atom_intern("CLIPBOARD", FALSE));
 	ReportContext *ctx = report_context_text_new(NULL);
 
-	ctx->entry = entry;
-
 	report_header(ctx);
-	report_table(ctx, data);
+	report_module_entry(ctx, entry);
 	report_footer(ctx);
 
-	gtk_clipboard_set_text(clip, ctx->output, -1);
+	gtk_clipboard_set_text(clip, ctx->output->str, -1);
 
-	g_free(data);
 	report_context_free(ctx);
     }
 }
@@ -91,6 +87,12 @@ void cb_toolbar()
     shell_ui_manager_set_visible("/MainMenuBarAction", visible);
 }
 
+void cb_similar_results()
+{
+    params.bench_similar = shell_action_get_active("SimilarResultsAction");
+    shell_do_redisplay();
+}
+
 void cb_about_module(GtkAction * action)
 {
     Shell *shell = shell_get_main_shell();
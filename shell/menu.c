@@ -102,6 +102,10 @@ static GtkToggleActionEntry toggle_entries[] = {
      N_("_Toolbar"), NULL,
      NULL,
      G_CALLBACK(cb_toolbar)},
+    {"SimilarResultsAction", NULL,
+     N_("Compare with Similar _Machines"), NULL,
+     N_("Compares benchmark results with the most similar saved machines"),
+     G_CALLBACK(cb_similar_results)},
 };
 
 /* Implement a handler for GtkUIManager's "add_widget" signal. The UI manager
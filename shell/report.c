@@ -19,6 +19,9 @@
 #include <report.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <math.h>
 #include <shell.h>
 #include <iconcache.h>
 #include <hardinfo.h>
@@ -32,9 +35,85 @@ static FileTypes file_types[] = {
     {"HTML (*.html)", "text/html", ".html", report_context_html_new},
     {"Plain Text (*.txt)", "text/plain", ".txt", report_context_text_new},
     {"Shell Dump (*.txt)", "text/plain", ".txt", report_context_shell_new},
+    {"JSON (*.json)", "application/json", ".json", report_context_json_new},
     {NULL, NULL, NULL, NULL}
 };
 
+/* Output goes to ctx->output; with a file descriptor or a stream set,
+ * it is written there whenever REPORT_BUFFER_SIZE bytes are buffered
+ * and at every report_flush(), so a report never has to be in memory
+ * all at once and can be read from a pipe while it is generated. */
+#define REPORT_BUFFER_SIZE (64 * 1024)
+
+static void report_drain(ReportContext *ctx)
+{
+    gchar *p = ctx->output->str;
+    gsize left = ctx->output->len;
+
+    if (ctx->stream) {
+        if (!ctx->failed &&
+            !g_output_stream_write_all(ctx->stream, p, left, NULL, NULL, NULL))
+            ctx->failed = TRUE;
+    } else if (ctx->fd >= 0) {
+        while (left && !ctx->failed) {
+            gssize n = write(ctx->fd, p, left);
+
+            if (n < 0 && errno != EINTR)
+                ctx->failed = TRUE;
+            if (n > 0) {
+                p += n;
+                left -= n;
+            }
+        }
+    } else {
+        return;   /* kept in memory */
+    }
+
+    g_string_truncate(ctx->output, 0);
+}
+
+static void report_puts(ReportContext *ctx, const gchar *str)
+{
+    g_string_append(ctx->output, str);
+    if (ctx->output->len >= REPORT_BUFFER_SIZE)
+        report_drain(ctx);
+}
+
+static void G_GNUC_PRINTF(2, 3)
+report_printf(ReportContext *ctx, const gchar *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    g_string_append_vprintf(ctx->output, format, args);
+    va_end(args);
+
+    if (ctx->output->len >= REPORT_BUFFER_SIZE)
+        report_drain(ctx);
+}
+
+gboolean report_flush(ReportContext *ctx)
+{
+    report_drain(ctx);
+    if (ctx->stream && !ctx->failed &&
+        !g_output_stream_flush(ctx->stream, NULL, NULL))
+        ctx->failed = TRUE;
+
+    return !ctx->failed;
+}
+
+void report_context_set_fd(ReportContext *ctx, gint fd)
+{
+    ctx->fd = fd;
+}
+
+void report_context_set_stream(ReportContext *ctx, GOutputStream *stream)
+{
+    if (ctx->stream)
+        g_object_unref(ctx->stream);
+    ctx->stream = stream ? g_object_ref(stream) : NULL;
+}
+
 /* virtual functions */
 void report_header(ReportContext * ctx)
 { ctx->header(ctx); }
@@ -128,16 +207,50 @@ void cache_icon(ReportContext *ctx, const gchar *file) {
         g_hash_table_insert(ctx->icon_data, g_strdup(file), make_icon_css(file));
 }
 
-void report_context_configure(ReportContext * ctx, GKeyFile * keyfile)
+static void report_context_reset_icons(ReportContext *ctx)
 {
-    gchar **keys;
-    const gchar *group = "$ShellParam$";
-
     if (ctx->icon_refs) {
         g_hash_table_remove_all(ctx->icon_refs);
         ctx->icon_refs = NULL;
     }
     ctx->icon_refs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+}
+
+/* column is one of info_column_titles[] */
+static void report_context_set_column_title(ReportContext *ctx,
+                                            const gchar *column,
+                                            const gchar *title)
+{
+    if (g_str_equal(column, "Extra1")) {
+            ctx->columns |= REPORT_COL_EXTRA1;
+    } else if (g_str_equal(column, "Extra2")) {
+            ctx->columns |= REPORT_COL_EXTRA2;
+    } else if (g_str_equal(column, "Value")) {
+            ctx->columns |= REPORT_COL_VALUE;
+    } else if (g_str_equal(column, "TextValue")) {
+            ctx->columns |= REPORT_COL_TEXTVALUE;
+    } else if (g_str_equal(column, "Progress")) {
+            ctx->columns |= REPORT_COL_PROGRESS;
+    }
+
+    g_hash_table_replace(ctx->column_titles,
+                         g_strdup(column), g_strdup(title));
+}
+
+static void report_context_set_view_type(ReportContext *ctx, ShellViewType view_type)
+{
+    if (view_type == SHELL_VIEW_PROGRESS) {
+        ctx->columns &= ~REPORT_COL_VALUE;
+        ctx->columns |= REPORT_COL_PROGRESS;
+    }
+}
+
+void report_context_configure(ReportContext * ctx, GKeyFile * keyfile)
+{
+    gchar **keys;
+    const gchar *group = "$ShellParam$";
+
+    report_context_reset_icons(ctx);
 
     keys = g_key_file_get_keys(keyfile, group, NULL, NULL);
     if (keys) {
@@ -162,25 +275,11 @@ void report_context_configure(ReportContext * ctx, GKeyFile * keyfile)
           }
 
           value = g_key_file_get_value(keyfile, group, key, NULL);
-          if (g_str_equal(title, "Extra1")) {
-                  ctx->columns |= REPORT_COL_EXTRA1;
-          } else if (g_str_equal(title, "Extra2")) {
-                  ctx->columns |= REPORT_COL_EXTRA2;
-          } else if (g_str_equal(title, "Value")) {
-                  ctx->columns |= REPORT_COL_VALUE;
-          } else if (g_str_equal(title, "TextValue")) {
-                  ctx->columns |= REPORT_COL_TEXTVALUE;
-          } else if (g_str_equal(title, "Progress")) {
-                  ctx->columns |= REPORT_COL_PROGRESS;
-          }
-
-          g_hash_table_replace(ctx->column_titles,
-                               g_strdup(title), g_strdup(value));
+          report_context_set_column_title(ctx, title, value);
+          g_free(value);
         } else if (g_str_equal(key, "ViewType")) {
-          if (g_key_file_get_integer(keyfile, group, "ViewType", NULL) == SHELL_VIEW_PROGRESS) {
-            ctx->columns &= ~REPORT_COL_VALUE;
-            ctx->columns |= REPORT_COL_PROGRESS;
-          }
+          report_context_set_view_type(ctx,
+              g_key_file_get_integer(keyfile, group, "ViewType", NULL));
         } else if (g_str_has_prefix(key, "Icon$")) {
             gchar *ikey = g_utf8_strchr(key, -1, '$');
             gchar *tag = key_mi_tag(ikey);
@@ -195,16 +294,46 @@ void report_context_configure(ReportContext * ctx, GKeyFile * keyfile)
 
 }
 
+/* the same as report_context_configure() does for [$ShellParam$] */
+static void report_context_configure_info(ReportContext *ctx, struct Info *info)
+{
+    guint i, j;
+
+    report_context_reset_icons(ctx);
+
+    ctx->show_column_headers = info->column_headers_visible;
+    for (i = 0; i < INFO_COLUMN_MAX; i++) {
+        if (info->column_titles[i])
+            report_context_set_column_title(ctx, info_column_titles[i],
+                                            info->column_titles[i]);
+    }
+    report_context_set_view_type(ctx, info->view_type);
+
+    for (i = 0; i < info->groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+
+        for (j = 0; j < group->fields->len; j++) {
+            struct InfoField *field = &g_array_index(group->fields, struct InfoField, j);
+
+            if (field->icon && *field->tag) {
+                cache_icon(ctx, field->icon);
+                g_hash_table_insert(ctx->icon_refs, g_strdup(field->tag),
+                                    g_strdup(field->icon));
+            }
+        }
+    }
+}
+
 static void report_html_details_start(ReportContext *ctx, gchar *key, gchar *value) {
     guint cols = report_get_visible_columns(ctx);
     report_key_value(ctx, key, value);
     ctx->parent_columns = ctx->columns;
     ctx->columns = REPORT_COL_VALUE;
-    ctx->output = h_strdup_cprintf("<tr><td colspan=\"%d\"><table class=\"details\">\n", ctx->output, cols);
+    report_printf(ctx, "<tr><td colspan=\"%d\"><table class=\"details\">\n", cols);
 }
 
 static void report_html_details_end(ReportContext *ctx) {
-    ctx->output = h_strdup_cprintf("</table></td></tr>\n", ctx->output);
+    report_printf(ctx, "</table></td></tr>\n");
     ctx->columns = ctx->parent_columns;
     ctx->parent_columns = 0;
 }
@@ -249,7 +378,7 @@ void report_details(ReportContext *ctx, gchar *key, gchar *value, gchar *details
 
                 if (g_str_equal(value, "...")) {
                     g_free(value);
-                    if (!(value = ctx->entry->fieldfunc(key))) {
+                    if (!(value = module_entry_get_field(ctx->entry, key))) {
                         value = g_strdup("...");
                     }
                 }
@@ -288,7 +417,7 @@ static void report_table_shell_dump(ReportContext *ctx, gchar *key_file_str, int
                 *eq = 0;
                 key = p; value = eq + 1;
 
-                ctx->output = h_strdup_cprintf("%s%s=%s\n", ctx->output, indent, key, value);
+                report_printf(ctx, "%s%s=%s\n", indent, key, value);
                 if (key_wants_details(key) || params.force_all_details) {
                     gchar *mi_tag = key_mi_tag(key);
                     gchar *mi_data = ctx->entry->morefunc(mi_tag); /*const*/
@@ -300,7 +429,7 @@ static void report_table_shell_dump(ReportContext *ctx, gchar *key_file_str, int
                 }
 
             } else
-                ctx->output = h_strdup_cprintf("%s%s\n", ctx->output, indent, p);
+                report_printf(ctx, "%s%s\n", indent, p);
             p = next_nl + 1;
         }
     }
@@ -365,7 +494,7 @@ void report_table(ReportContext * ctx, gchar * text)
 
                 if (g_str_equal(value, "...")) {
                     g_free(value);
-                    if (!(value = ctx->entry->fieldfunc(key))) {
+                    if (!(value = module_entry_get_field(ctx->entry, key))) {
                         value = g_strdup("...");
                     }
                 }
@@ -401,13 +530,88 @@ void report_table(ReportContext * ctx, gchar * text)
     g_key_file_free(key_file);
 }
 
-static void report_html_header(ReportContext * ctx)
+/* report_table() for an Info from module_entry_get_info() */
+void report_info(ReportContext *ctx, struct Info *info)
 {
-    g_free(ctx->output);
+    guint i, j;
 
-    ctx->output =
-	g_strdup_printf
-	("<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0 Final//EN\">\n"
+    /* make only "Value" column visible ("Key" column is always visible) */
+    ctx->columns = REPORT_COL_VALUE;
+    ctx->show_column_headers = FALSE;
+
+    report_context_configure_info(ctx, info);
+
+    for (i = 0; i < info->groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+
+        if (group->name)
+            report_subsubtitle(ctx, (gchar *)group->name);
+        else if (ctx->format == REPORT_FORMAT_JSON)
+            /* no heading in text or HTML, but JSON fields need a group */
+            report_subsubtitle(ctx, NULL);
+
+        for (j = 0; j < group->fields->len; j++) {
+            struct InfoField *field = &g_array_index(group->fields, struct InfoField, j);
+            gchar *flags, *key, *value, *mi_data = NULL;
+
+            if (g_str_equal(field->value, "...")) {
+                if (!(value = module_entry_get_field(ctx->entry, (gchar *)field->name)))
+                    value = g_strdup("...");
+            } else {
+                value = info_field_get_value(field);
+            }
+
+            if (!g_utf8_validate(field->name, -1, NULL) ||
+                !g_utf8_validate(value, -1, NULL)) {
+                g_free(value);
+                continue;
+            }
+
+            /* formatters still take the flags in front of the key */
+            flags = info_field_get_flags(field);
+            key = g_strconcat(flags ? flags : "", field->name, NULL);
+
+            if (*field->tag && (field->report_details || params.force_all_details))
+                mi_data = module_entry_get_moreinfo(ctx->entry, field->tag);
+
+            if (mi_data)
+                report_details(ctx, key, value, mi_data);
+            else
+                report_key_value(ctx, key, value);
+
+            g_free(mi_data);
+            g_free(key);
+            g_free(flags);
+            g_free(value);
+        }
+    }
+}
+
+void report_module_entry(ReportContext *ctx, ShellModuleEntry *entry)
+{
+    struct Info *info;
+    gchar *text;
+
+    ctx->entry = entry;
+
+    /* the shell format is the flattened text itself */
+    if (ctx->format != REPORT_FORMAT_SHELL &&
+        (info = module_entry_get_info(entry))) {
+        report_info(ctx, info);
+        info_free(info);
+        return;
+    }
+
+    if ((text = module_entry_function(entry))) {
+        report_table(ctx, text);
+        g_free(text);
+    }
+}
+
+static void report_html_header(ReportContext * ctx)
+{
+    report_printf(ctx,
+	 "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0 Final//EN\">\n"
 	 "<html><head>\n" "<title>HardInfo (%s) System Report</title>\n"
 	 "<meta http-equiv=\"Content-Type\" content=\"text/html; charset=utf-8\">\n"
 	 "<style>\n" "    body    { background: #fff }\n"
@@ -428,26 +632,26 @@ static void report_html_header(ReportContext * ctx)
 
 static void report_html_footer(ReportContext * ctx)
 {
-    ctx->output = h_strconcat(ctx->output, "</table>", NULL);
-    ctx->output = h_strconcat(ctx->output, "<style>\n", NULL);
+    report_puts(ctx, "</table>");
+    report_puts(ctx, "<style>\n");
     GList *l = NULL, *keys = g_hash_table_get_keys(ctx->icon_data);
     for(l = keys; l; l = l->next) {
         gchar *data = g_hash_table_lookup(ctx->icon_data, (gchar*)l->data);
         if (data)
-            ctx->output = h_strconcat(ctx->output, data, NULL);
+            report_puts(ctx, data);
     }
     g_list_free(keys);
-    ctx->output = h_strconcat(ctx->output, "</style>\n", NULL);
-    ctx->output = h_strconcat(ctx->output, "</html>", NULL);
+    report_puts(ctx, "</style>\n");
+    report_puts(ctx, "</html>");
 }
 
 static void report_html_title(ReportContext * ctx, gchar * text)
 {
     if (!ctx->first_table) {
-      ctx->output = h_strdup_cprintf("</table>", ctx->output);
+      report_printf(ctx, "</table>");
     }
 
-    ctx->output = h_strdup_cprintf("<h1 class=\"title\">%s</h1>", ctx->output, text);
+    report_printf(ctx, "<h1 class=\"title\">%s</h1>", text);
 }
 
 static void report_html_subtitle(ReportContext * ctx, gchar * text)
@@ -455,27 +659,25 @@ static void report_html_subtitle(ReportContext * ctx, gchar * text)
     gint columns = report_get_visible_columns(ctx);
 
     if (!ctx->first_table) {
-      ctx->output = h_strdup_cprintf("</table>", ctx->output);
+      report_printf(ctx, "</table>");
     } else {
       ctx->first_table = FALSE;
     }
 
-    ctx->output = h_strdup_cprintf("<table><tr><td colspan=\"%d\" class=\"stit"
-				  "le\">%s</td></tr>\n",
-				  ctx->output,
-				  columns+1,
-				  text);
+    report_printf(ctx, "<table><tr><td colspan=\"%d\" class=\"stit"
+		       "le\">%s</td></tr>\n",
+		       columns+1,
+		       text);
 }
 
 static void report_html_subsubtitle(ReportContext * ctx, gchar * text)
 {
     gint columns = report_get_visible_columns(ctx);
 
-    ctx->output = h_strdup_cprintf("<tr><td colspan=\"%d\" class=\"ssti"
-				  "tle\">%s</td></tr>\n",
-				  ctx->output,
-				  columns+1,
-				  text);
+    report_printf(ctx, "<tr><td colspan=\"%d\" class=\"ssti"
+		       "tle\">%s</td></tr>\n",
+		       columns+1,
+		       text);
 }
 
 static void
@@ -500,24 +702,21 @@ report_html_key_value(ReportContext * ctx, gchar * key, gchar * value)
     gchar *name = (gchar*)key_get_name(key);
 
     if (columns == 2) {
-      ctx->output = h_strdup_cprintf("<tr%s><td class=\"icon\">%s</td><td class=\"field\">%s</td>"
-                                    "<td class=\"value\">%s</td></tr>\n",
-                                    ctx->output,
-                                    highlight ? " class=\"hilight\"" : "",
-                                    icon, name, value);
+      report_printf(ctx, "<tr%s><td class=\"icon\">%s</td><td class=\"field\">%s</td>"
+                         "<td class=\"value\">%s</td></tr>\n",
+                         highlight ? " class=\"hilight\"" : "",
+                         icon, name, value);
     } else {
       values = g_strsplit(value, "|", columns);
       mc = g_strv_length(values) - 1;
 
-      ctx->output = h_strdup_cprintf("\n<tr%s>\n<td class=\"icon\">%s</td><td class=\"field\">%s</td>", ctx->output, highlight ? " class=\"hilight\"" : "", icon, name);
+      report_printf(ctx, "\n<tr%s>\n<td class=\"icon\">%s</td><td class=\"field\">%s</td>", highlight ? " class=\"hilight\"" : "", icon, name);
 
       for (i = mc; i >= 0; i--) {
-        ctx->output = h_strdup_cprintf("<td class=\"value\">%s</td>",
-                                       ctx->output,
-                                       values[i]);
+        report_printf(ctx, "<td class=\"value\">%s</td>", values[i]);
       }
 
-      ctx->output = h_strdup_cprintf("</tr>\n", ctx->output);
+      report_printf(ctx, "</tr>\n");
 
       g_strfreev(values);
     }
@@ -526,9 +725,6 @@ report_html_key_value(ReportContext * ctx, gchar * key, gchar * value)
 
 static void report_text_header(ReportContext * ctx)
 {
-    g_free(ctx->output);
-
-    ctx->output = g_strdup("");
 }
 
 static void report_text_footer(ReportContext * ctx)
@@ -537,28 +733,18 @@ static void report_text_footer(ReportContext * ctx)
 
 static void report_text_title(ReportContext * ctx, gchar * text)
 {
-    gchar *str = (gchar *) ctx->output;
-    int i = strlen(text);
+    gchar *line = g_strnfill(strlen(text), '*');
 
-    str = h_strdup_cprintf("\n%s\n", str, text);
-    for (; i; i--)
-	str = h_strconcat(str, "*", NULL);
-
-    str = h_strconcat(str, "\n\n", NULL);
-    ctx->output = str;
+    report_printf(ctx, "\n%s\n%s\n\n", text, line);
+    g_free(line);
 }
 
 static void report_text_subtitle(ReportContext * ctx, gchar * text)
 {
-    gchar *str = ctx->output;
-    int i = strlen(text);
-
-    str = h_strdup_cprintf("\n%s\n", str, text);
-    for (; i; i--)
-	str = h_strconcat(str, "-", NULL);
+    gchar *line = g_strnfill(strlen(text), '-');
 
-    str = h_strconcat(str, "\n\n", NULL);
-    ctx->output = str;
+    report_printf(ctx, "\n%s\n%s\n\n", text, line);
+    g_free(line);
 }
 
 static void report_text_subsubtitle(ReportContext * ctx, gchar * text)
@@ -566,7 +752,7 @@ static void report_text_subsubtitle(ReportContext * ctx, gchar * text)
     gchar indent[10] = "   ";
     if (!ctx->in_details)
         indent[0] = 0;
-    ctx->output = h_strdup_cprintf("%s-%s-\n", ctx->output, indent, text);
+    report_printf(ctx, "%s-%s-\n", indent, text);
 }
 
 static void
@@ -584,27 +770,252 @@ report_text_key_value(ReportContext * ctx, gchar * key, gchar * value)
 
     if (columns == 2 || ctx->in_details) {
       if (strlen(value))
-          ctx->output = h_strdup_cprintf("%s%s%s\t\t: %s\n", ctx->output, indent, highlight ? "* " : "", name, value);
+          report_printf(ctx, "%s%s%s\t\t: %s\n", indent, highlight ? "* " : "", name, value);
       else
-          ctx->output = h_strdup_cprintf("%s%s%s\n", ctx->output, indent, highlight ? "* " : "", name);
+          report_printf(ctx, "%s%s%s\n", indent, highlight ? "* " : "", name);
     } else {
       values = g_strsplit(value, "|", columns);
       mc = g_strv_length(values) - 1;
 
-      ctx->output = h_strdup_cprintf("%s%s%s", ctx->output, indent, highlight ? "* " : "", name);
+      report_printf(ctx, "%s%s%s", indent, highlight ? "* " : "", name);
 
       for (i = mc; i >= 0; i--) {
-        ctx->output = h_strdup_cprintf("\t%s",
-                                       ctx->output,
-                                       values[i]);
+        report_printf(ctx, "\t%s", values[i]);
       }
 
-      ctx->output = h_strdup_cprintf("\n", ctx->output);
+      report_printf(ctx, "\n");
 
       g_strfreev(values);
     }
 }
 
+/* JSON, written in one pass as the report is made; nothing is kept
+ * but the stack of objects still open:
+ *
+ * { "schema": "hardinfo-report", "schema_version": 1,
+ *   "hardinfo_version": "...",
+ *   "modules": [ { "name": "...", "entries": [ { "name": "...",
+ *       "groups": [ { "name": "...", "fields": [ <field>, ... ] } ] } ] } ] }
+ *
+ * A group without a heading in the other formats has "name": null.
+ *
+ * <field> is
+ *   { "label": "...", "value": "...", "type": "string|number|boolean",
+ *     "number": 2400.0, "unit": "MHz",    type number; unit if there is one
+ *     "boolean": true,                    type boolean
+ *     "values": [ "...", ... ],           value split in its columns
+ *     "highlight": true,                  the row is selected in the GUI
+ *     "tag": "...",                       its moreinfo tag
+ *     "details": [ { "name": "...", "fields": [ <field>, ... ] } ] }
+ * where everything after "type" appears only when it applies.
+ *
+ * REPORT_JSON_SCHEMA_VERSION changes when something is removed or
+ * changes meaning, not when something is added. */
+enum {
+    JSON_MODULE,
+    JSON_ENTRY,
+    JSON_GROUP,
+    JSON_FIELD,
+    JSON_DETAILS_GROUP,
+    JSON_DETAILS_FIELD,
+};
+
+static void report_json_string(ReportContext *ctx, const gchar *s)
+{
+    const guchar *c;
+
+    g_string_append_c(ctx->output, '"');
+    for (c = (const guchar *)(s ? s : ""); *c; c++) {
+        switch (*c) {
+        case '"':  g_string_append(ctx->output, "\\\""); break;
+        case '\\': g_string_append(ctx->output, "\\\\"); break;
+        case '\n': g_string_append(ctx->output, "\\n"); break;
+        case '\r': g_string_append(ctx->output, "\\r"); break;
+        case '\t': g_string_append(ctx->output, "\\t"); break;
+        default:
+            if (*c < 0x20)
+                g_string_append_printf(ctx->output, "\\u%04x", *c);
+            else
+                g_string_append_c(ctx->output, *c);
+        }
+    }
+    g_string_append_c(ctx->output, '"');
+}
+
+/* closes what is open at level and below it and starts an item there;
+ * FALSE if there is nothing open to put it in */
+static gboolean report_json_open(ReportContext *ctx, gint level, const gchar *close)
+{
+    if (ctx->json_depth < level) {
+        DEBUG("JSON item at level %d with nothing open above it", level);
+        return FALSE;
+    }
+
+    while (ctx->json_depth > level)
+        report_puts(ctx, ctx->json_close[--ctx->json_depth]);
+    report_puts(ctx, ctx->json_items[level]++ ? ",\n" : "\n");
+
+    ctx->json_close[level] = close;
+    ctx->json_depth = level + 1;
+    if (level + 1 < REPORT_JSON_LEVELS)
+        ctx->json_items[level + 1] = 0;
+
+    return TRUE;
+}
+
+static gboolean report_json_is_unit(const gchar *unit)
+{
+    const guchar *c = (const guchar *)unit;
+
+    if (!*c || strlen(unit) > 16 || g_ascii_isdigit(*c) || *c == '/')
+        return FALSE;
+    for (; *c; c++)
+        if (!g_ascii_isalpha(*c) && *c != '%' && *c != '/' && *c < 0x80)
+            return FALSE;
+    return TRUE;
+}
+
+/* "type" and, if the value is one, "number" and "unit" or "boolean" */
+static void report_json_typed(ReportContext *ctx, const gchar *value)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE], *end;
+    gdouble number;
+
+    if (!g_ascii_strcasecmp(value, "yes") || !g_ascii_strcasecmp(value, "true")) {
+        report_puts(ctx, ", \"type\": \"boolean\", \"boolean\": true");
+        return;
+    }
+    if (!g_ascii_strcasecmp(value, "no") || !g_ascii_strcasecmp(value, "false")) {
+        report_puts(ctx, ", \"type\": \"boolean\", \"boolean\": false");
+        return;
+    }
+
+    if (g_ascii_isdigit(value[0]) || (value[0] == '-' && g_ascii_isdigit(value[1]))) {
+        number = g_ascii_strtod(value, &end);
+        while (*end == ' ')
+            end++;
+        if (isfinite(number) && (!*end || report_json_is_unit(end))) {
+            report_printf(ctx, ", \"type\": \"number\", \"number\": %s",
+                          g_ascii_dtostr(buf, sizeof(buf), number));
+            if (*end) {
+                report_puts(ctx, ", \"unit\": ");
+                report_json_string(ctx, end);
+            }
+            return;
+        }
+    }
+
+    report_puts(ctx, ", \"type\": \"string\"");
+}
+
+static void report_json_field(ReportContext *ctx, gchar *key, gchar *value,
+                              gboolean has_details)
+{
+    gint level = ctx->in_details ? JSON_DETAILS_FIELD : JSON_FIELD;
+    gint columns = report_get_visible_columns(ctx);
+    gchar *tag;
+
+    if (!report_json_open(ctx, level, has_details ? "]}" : "}"))
+        return;
+
+    report_puts(ctx, "{\"label\": ");
+    report_json_string(ctx, key_get_name(key));
+    report_puts(ctx, ", \"value\": ");
+    report_json_string(ctx, value);
+
+    if (columns > 2 && !ctx->in_details && strchr(value, '|')) {
+        gchar **values = g_strsplit(value, "|", columns);
+        gint i;
+
+        /* in the order they are shown */
+        report_puts(ctx, ", \"type\": \"string\", \"values\": [");
+        for (i = g_strv_length(values) - 1; i >= 0; i--) {
+            report_json_string(ctx, values[i]);
+            if (i)
+                report_puts(ctx, ", ");
+        }
+        report_puts(ctx, "]");
+        g_strfreev(values);
+    } else {
+        report_json_typed(ctx, value);
+    }
+
+    if (key_is_highlighted(key))
+        report_puts(ctx, ", \"highlight\": true");
+    if ((tag = key_mi_tag(key))) {
+        report_puts(ctx, ", \"tag\": ");
+        report_json_string(ctx, tag);
+        g_free(tag);
+    }
+
+    if (has_details)
+        report_puts(ctx, ", \"details\": [");
+}
+
+static void report_json_header(ReportContext * ctx)
+{
+    report_printf(ctx, "{\"schema\": \"hardinfo-report\", \"schema_version\": %d,\n"
+                       "\"hardinfo_version\": ", REPORT_JSON_SCHEMA_VERSION);
+    report_json_string(ctx, VERSION);
+    report_puts(ctx, ",\n\"modules\": [");
+    ctx->json_depth = 0;
+    ctx->json_items[0] = 0;
+}
+
+static void report_json_footer(ReportContext * ctx)
+{
+    while (ctx->json_depth > 0)
+        report_puts(ctx, ctx->json_close[--ctx->json_depth]);
+    report_puts(ctx, "\n]}\n");
+}
+
+static void report_json_title(ReportContext * ctx, gchar * text)
+{
+    report_json_open(ctx, JSON_MODULE, "]}");
+    report_puts(ctx, "{\"name\": ");
+    report_json_string(ctx, text);
+    report_puts(ctx, ", \"entries\": [");
+}
+
+static void report_json_subtitle(ReportContext * ctx, gchar * text)
+{
+    if (!report_json_open(ctx, JSON_ENTRY, "]}"))
+        return;
+    report_puts(ctx, "{\"name\": ");
+    report_json_string(ctx, text);
+    report_puts(ctx, ", \"groups\": [");
+}
+
+static void report_json_subsubtitle(ReportContext * ctx, gchar * text)
+{
+    gint level = ctx->in_details ? JSON_DETAILS_GROUP : JSON_GROUP;
+
+    if (!report_json_open(ctx, level, "]}"))
+        return;
+    report_puts(ctx, "{\"name\": ");
+    if (text)
+        report_json_string(ctx, text);
+    else
+        report_puts(ctx, "null");
+    report_puts(ctx, ", \"fields\": [");
+}
+
+static void
+report_json_key_value(ReportContext * ctx, gchar * key, gchar * value)
+{
+    report_json_field(ctx, key, value, FALSE);
+}
+
+static void report_json_details_start(ReportContext *ctx, gchar *key, gchar *value)
+{
+    report_json_field(ctx, key, value, TRUE);
+}
+
+static void report_json_details_end(ReportContext *ctx)
+{
+    /* closed by whatever comes next */
+}
+
 static GSList *report_create_module_list_from_dialog(ReportDialog * rd)
 {
     ShellModule *module;
@@ -655,9 +1066,172 @@ static GSList *report_create_module_list_from_dialog(ReportDialog * rd)
     return modules;
 }
 
+/* Scanning ahead: the entries of a report are scanned on a pool of up
+ * to -j worker threads while the report is written in the usual order,
+ * each entry as soon as its scan is done. Entries flagged
+ * MODULE_FLAG_INDEPENDENT share no state with any other entry, so each
+ * is a task of its own. The other entries of modules that depend on
+ * each other (hi_module_get_dependencies()) call into each other, so
+ * they make one task, scanned by one thread in report order. Entries
+ * flagged MODULE_FLAG_NO_PARALLEL (benchmarks) are not scanned ahead,
+ * and only once every task is done. Everything is still scanned
+ * exactly once, so the report is the same either way. */
+typedef struct {
+    GSList *entries;
+    gboolean done;
+} ReportScanTask;
+
+typedef struct {
+    GSList *tasks;
+    GHashTable *task_of;	/* ShellModuleEntry * -> ReportScanTask * */
+    GThreadPool *pool;
+    GMutex lock;
+    GCond cond;
+    gint pending;
+} ReportScanAhead;
+
+static gboolean report_modules_depend(ShellModule *a, ShellModule *b)
+{
+    gchar **(*get_deps) (void);
+    gchar **deps, *name;
+    gboolean found = FALSE;
+    gint i;
+
+    if (!g_module_symbol(a->dll, "hi_module_get_dependencies", (gpointer) & get_deps))
+	return FALSE;
+
+    name = g_path_get_basename(g_module_name(b->dll));
+    for (i = 0, deps = get_deps(); deps[i] && !found; i++)
+	found = g_str_equal(deps[i], name);
+    g_free(name);
+
+    return found;
+}
+
+static void report_scan_task(gpointer data, gpointer user_data)
+{
+    ReportScanTask *task = data;
+    ReportScanAhead *ahead = user_data;
+    GSList *e;
+
+    for (e = task->entries; e; e = e->next)
+	module_entry_scan((ShellModuleEntry *) e->data);
+
+    g_mutex_lock(&ahead->lock);
+    task->done = TRUE;
+    ahead->pending--;
+    g_cond_broadcast(&ahead->cond);
+    g_mutex_unlock(&ahead->lock);
+}
+
+static ReportScanAhead *report_scan_ahead_start(GSList * modules, gint jobs)
+{
+    ReportScanAhead *ahead;
+    ReportScanTask **groups;
+    ShellModule **mods;
+    gint n = g_slist_length(modules), *group_id, i, j, k;
+    GSList *g, *e;
+
+    ahead = g_new0(ReportScanAhead, 1);
+    ahead->task_of = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_mutex_init(&ahead->lock);
+    g_cond_init(&ahead->cond);
+
+    mods = g_new(ShellModule *, n);
+    group_id = g_new(gint, n);
+    groups = g_new0(ReportScanTask *, n);
+    for (i = 0, g = modules; g; g = g->next, i++) {
+	mods[i] = (ShellModule *) g->data;
+	group_id[i] = i;
+    }
+
+    /* modules depending on each other, either way, share a group */
+    for (i = 0; i < n; i++)
+	for (j = 0; j < i; j++) {
+	    gint old = group_id[i];
+
+	    if (old == group_id[j] ||
+		(!report_modules_depend(mods[i], mods[j]) &&
+		 !report_modules_depend(mods[j], mods[i])))
+		continue;
+	    for (k = 0; k <= i; k++)
+		if (group_id[k] == old)
+		    group_id[k] = group_id[j];
+	}
+
+    /* in report order, within and across tasks */
+    for (i = 0; i < n; i++) {
+	for (e = mods[i]->entries; e; e = e->next) {
+	    ShellModuleEntry *entry = (ShellModuleEntry *) e->data;
+	    ReportScanTask *task;
+
+	    if (entry->flags & MODULE_FLAG_NO_PARALLEL)
+		continue;
+
+	    task = (entry->flags & MODULE_FLAG_INDEPENDENT) ? NULL : groups[group_id[i]];
+	    if (!task) {
+		task = g_new0(ReportScanTask, 1);
+		ahead->tasks = g_slist_append(ahead->tasks, task);
+		if (!(entry->flags & MODULE_FLAG_INDEPENDENT))
+		    groups[group_id[i]] = task;
+	    }
+	    task->entries = g_slist_append(task->entries, entry);
+	    g_hash_table_insert(ahead->task_of, entry, task);
+	}
+    }
+    g_free(groups);
+    g_free(group_id);
+    g_free(mods);
+
+    ahead->pending = g_slist_length(ahead->tasks);
+    ahead->pool = g_thread_pool_new(report_scan_task, ahead, jobs, TRUE, NULL);
+    for (g = ahead->tasks; g; g = g->next)
+	g_thread_pool_push(ahead->pool, g->data, NULL);
+
+    DEBUG("scanning ahead in %d tasks with up to %d threads", ahead->pending, jobs);
+
+    return ahead;
+}
+
+/* until entry is scanned, or everything with entry NULL */
+static void report_scan_ahead_wait(ReportScanAhead *ahead, ShellModuleEntry *entry)
+{
+    ReportScanTask *task = entry ? g_hash_table_lookup(ahead->task_of, entry) : NULL;
+
+    g_mutex_lock(&ahead->lock);
+    while (task ? !task->done : ahead->pending > 0)
+	g_cond_wait(&ahead->cond, &ahead->lock);
+    g_mutex_unlock(&ahead->lock);
+}
+
+static void report_scan_ahead_free(ReportScanAhead *ahead)
+{
+    GSList *t;
+
+    g_thread_pool_free(ahead->pool, FALSE, TRUE);
+    for (t = ahead->tasks; t; t = t->next) {
+	g_slist_free(((ReportScanTask *) t->data)->entries);
+	g_free(t->data);
+    }
+    g_slist_free(ahead->tasks);
+    g_hash_table_destroy(ahead->task_of);
+    g_mutex_clear(&ahead->lock);
+    g_cond_clear(&ahead->cond);
+    g_free(ahead);
+}
+
 static void
 report_create_inner_from_module_list(ReportContext * ctx, GSList * modules)
 {
+    ReportScanAhead *ahead = NULL;
+    gint jobs = params.report_jobs;
+
+    if (jobs <= 0)
+	jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    /* scans update the GUI, which is not thread-safe */
+    if (jobs > 1 && !params.gui_running)
+	ahead = report_scan_ahead_start(modules, jobs);
+
     for (; modules; modules = modules->next) {
 	ShellModule *module = (ShellModule *) modules->data;
 	GSList *entries;
@@ -674,12 +1248,19 @@ report_create_inner_from_module_list(ReportContext * ctx, GSList * modules)
 		fprintf(stderr, "\033[2K\033[40;32;1m %s\033[0m\n",
 			entry->name);
 
+	    if (ahead)
+		report_scan_ahead_wait(ahead, (entry->flags & MODULE_FLAG_NO_PARALLEL) ? NULL : entry);
+
 	    ctx->entry = entry;
 	    report_subtitle(ctx, entry->name);
 	    module_entry_scan(entry);
-	    report_table(ctx, module_entry_function(entry));
+	    report_module_entry(ctx, entry);
+	    report_flush(ctx);
 	}
     }
+
+    if (ahead)
+	report_scan_ahead_free(ahead);
 }
 
 void report_module_list_free(GSList * modules)
@@ -749,7 +1330,8 @@ ReportContext *report_context_html_new()
     ctx->details_keyvalue = report_html_key_value;
     ctx->details_end = report_html_details_end;
 
-    ctx->output = g_strdup("");
+    ctx->output = g_string_new(NULL);
+    ctx->fd = -1;
     ctx->format = REPORT_FORMAT_HTML;
 
     ctx->column_titles = g_hash_table_new_full(g_str_hash, g_str_equal,
@@ -778,7 +1360,8 @@ ReportContext *report_context_text_new()
     ctx->details_keyvalue = report_text_key_value;
     ctx->details_end = report_text_footer; /* nothing */
 
-    ctx->output = g_strdup("");
+    ctx->output = g_string_new(NULL);
+    ctx->fd = -1;
     ctx->format = REPORT_FORMAT_TEXT;
 
     ctx->column_titles = g_hash_table_new_full(g_str_hash, g_str_equal,
@@ -788,6 +1371,34 @@ ReportContext *report_context_text_new()
     return ctx;
 }
 
+ReportContext *report_context_json_new()
+{
+    ReportContext *ctx;
+
+    ctx = g_new0(ReportContext, 1);
+    ctx->header = report_json_header;
+    ctx->footer = report_json_footer;
+    ctx->title = report_json_title;
+    ctx->subtitle = report_json_subtitle;
+    ctx->subsubtitle = report_json_subsubtitle;
+    ctx->keyvalue = report_json_key_value;
+
+    ctx->details_start = report_json_details_start;
+    ctx->details_section = report_json_subsubtitle;
+    ctx->details_keyvalue = report_json_key_value;
+    ctx->details_end = report_json_details_end;
+
+    ctx->output = g_string_new(NULL);
+    ctx->fd = -1;
+    ctx->format = REPORT_FORMAT_JSON;
+
+    ctx->column_titles = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                               g_free, g_free);
+    ctx->first_table = TRUE;
+
+    return ctx;
+}
+
 ReportContext *report_context_shell_new()
 {
     ReportContext *ctx;
@@ -801,7 +1412,8 @@ ReportContext *report_context_shell_new()
     /* special format handled in report_table(),
      * doesn't need the others. */
 
-    ctx->output = g_strdup("");
+    ctx->output = g_string_new(NULL);
+    ctx->fd = -1;
     ctx->format = REPORT_FORMAT_SHELL;
 
     ctx->column_titles = g_hash_table_new_full(g_str_hash, g_str_equal,
@@ -818,7 +1430,9 @@ void report_context_free(ReportContext * ctx)
         g_hash_table_destroy(ctx->icon_refs);
     if(ctx->icon_data)
         g_hash_table_destroy(ctx->icon_data);
-    g_free(ctx->output);
+    if (ctx->stream)
+        g_object_unref(ctx->stream);
+    g_string_free(ctx->output, TRUE);
     g_free(ctx);
 }
 
@@ -830,14 +1444,12 @@ void report_create_from_module_list(ReportContext * ctx, GSList * modules)
     report_module_list_free(modules);
 
     report_footer(ctx);
+    report_flush(ctx);
 }
 
-gchar *report_create_from_module_list_format(GSList * modules,
-					     ReportFormat format)
+static ReportContext *report_context_new_for_format(ReportFormat format)
 {
     ReportContext *(*create_context) ();
-    ReportContext *ctx;
-    gchar *retval;
 
     if (format >= N_REPORT_FORMAT)
 	return NULL;
@@ -846,10 +1458,39 @@ gchar *report_create_from_module_list_format(GSList * modules,
     if (!create_context)
 	return NULL;
 
-    ctx = create_context();
+    return create_context();
+}
 
+gchar *report_create_from_module_list_format(GSList * modules,
+					     ReportFormat format)
+{
+    ReportContext *ctx;
+    gchar *retval;
+
+    if (!(ctx = report_context_new_for_format(format)))
+	return NULL;
+
+    report_create_from_module_list(ctx, modules);
+    retval = g_string_free(ctx->output, FALSE);
+    ctx->output = g_string_new(NULL);
+
+    report_context_free(ctx);
+
+    return retval;
+}
+
+gboolean report_create_from_module_list_fd(GSList * modules,
+					   ReportFormat format, gint fd)
+{
+    ReportContext *ctx;
+    gboolean retval;
+
+    if (!(ctx = report_context_new_for_format(format)))
+	return FALSE;
+
+    report_context_set_fd(ctx, fd);
     report_create_from_module_list(ctx, modules);
-    retval = g_strdup(ctx->output);
+    retval = !ctx->failed;
 
     report_context_free(ctx);
 
@@ -862,31 +1503,54 @@ static gboolean report_generate(ReportDialog * rd)
     ReportContext *ctx;
     ReportContext *(*create_context) ();
     gchar *file;
-    FILE *stream;
+    GFile *gfile;
+    GFileOutputStream *stream;
+    gboolean ok;
 
     if (!(file = report_get_filename()))
 	return FALSE;
 
-    if (!(stream = fopen(file, "w+"))) {
-	g_free(file);
-	return FALSE;
-    }
-
+    /* before opening the file, so a failure here leaves it untouched */
     create_context = file_types_get_data_by_name(file_types, file);
 
     if (!create_context) {
 	g_warning(_("Cannot create ReportContext. Programming bug?"));
 	g_free(file);
-	fclose(stream);
+	return FALSE;
+    }
+
+    gfile = g_file_new_for_path(file);
+    stream = g_file_replace(gfile, NULL, FALSE, G_FILE_CREATE_NONE, NULL, NULL);
+    g_object_unref(gfile);
+    if (!stream) {
+	g_free(file);
 	return FALSE;
     }
 
     ctx = create_context();
     modules = report_create_module_list_from_dialog(rd);
 
+    report_context_set_stream(ctx, G_OUTPUT_STREAM(stream));
     report_create_from_module_list(ctx, modules);
-    fputs(ctx->output, stream);
-    fclose(stream);
+
+    ok = !ctx->failed;
+    if (ok) {
+	ok = g_output_stream_close(G_OUTPUT_STREAM(stream), NULL, NULL);
+    } else {
+	/* a cancelled close keeps the file as it was, not half a report */
+	GCancellable *cancel = g_cancellable_new();
+
+	g_cancellable_cancel(cancel);
+	g_output_stream_close(G_OUTPUT_STREAM(stream), cancel, NULL);
+	g_object_unref(cancel);
+    }
+    g_object_unref(stream);
+
+    if (!ok) {
+	report_context_free(ctx);
+	g_free(file);
+	return FALSE;
+    }
 
     if (ctx->format == REPORT_FORMAT_HTML) {
 	GtkWidget *dialog;
@@ -330,6 +330,15 @@ void shell_do_reload(void)
     shell_action_set_enabled("ReportAction", TRUE);
 }
 
+/* shows the selected entry again without rescanning it */
+void shell_do_redisplay(void)
+{
+    if (!params.gui_running || !shell->selected)
+	return;
+
+    module_selected_show_info(shell->selected, FALSE);
+}
+
 void shell_status_update(const gchar * message)
 {
     if (params.gui_running) {
@@ -780,6 +789,7 @@ void shell_init(GSList * modules)
     shell_action_set_enabled("CopyAction", FALSE);
     shell_action_set_active("SidePaneAction", TRUE);
     shell_action_set_active("ToolbarAction", TRUE);
+    shell_action_set_active("SimilarResultsAction", params.bench_similar);
 
 #ifndef HAS_LIBSOUP
     shell_action_set_enabled("SyncManagerAction", FALSE);
@@ -808,7 +818,7 @@ static gboolean update_field(gpointer data)
 
     /* if the entry is still selected, update it */
     if (fu->entry->selected && fu->entry->fieldfunc) {
-        gchar *value = fu->entry->fieldfunc(fu->field_name);
+        gchar *value = module_entry_get_field(fu->entry, fu->field_name);
 
         if (item->is_iter) {
             /*
@@ -1103,6 +1113,61 @@ static void set_view_type(ShellViewType viewtype, gboolean reload)
     }
 }
 
+static void field_update_add(ShellModuleEntry *entry, const gchar *field_name,
+                             gint ms)
+{
+    ShellFieldUpdate *fu = g_new0(ShellFieldUpdate, 1);
+    ShellFieldUpdateSource *sfutbl;
+
+    fu->field_name = g_strdup(field_name);
+    fu->entry = entry;
+
+    sfutbl = g_new0(ShellFieldUpdateSource, 1);
+    sfutbl->source_id = g_timeout_add(ms, update_field, fu);
+    sfutbl->sfu = fu;
+
+    update_sfusrc = g_slist_prepend(update_sfusrc, sfutbl);
+}
+
+/* column is one of info_column_titles[] */
+static void info_tree_set_column_title(const gchar *column, const gchar *title)
+{
+    GtkTreeViewColumn *tree_column = NULL;
+
+    if (g_str_equal(column, "Extra1")) {
+        tree_column = shell->info_tree->col_extra1;
+    } else if (g_str_equal(column, "Extra2")) {
+        tree_column = shell->info_tree->col_extra2;
+    } else if (g_str_equal(column, "Value")) {
+        tree_column = shell->info_tree->col_value;
+    } else if (g_str_equal(column, "TextValue")) {
+        tree_column = shell->info_tree->col_textvalue;
+    } else if (g_str_equal(column, "Progress")) {
+        tree_column = shell->info_tree->col_progress;
+    }
+
+    if (tree_column) {
+        gtk_tree_view_column_set_title(tree_column, title);
+        gtk_tree_view_column_set_visible(tree_column, TRUE);
+    }
+}
+
+static void update_item_set_icon(struct UpdateTableItem *item, const gchar *file)
+{
+    GdkPixbuf *pixbuf = icon_cache_get_pixbuf_at_size(file, 22, 22);
+
+    if (item->is_iter) {
+        gtk_tree_store_set(
+            GTK_TREE_STORE(shell->info_tree->model), item->iter,
+            INFO_TREE_COL_PBUF, pixbuf, -1);
+    } else {
+        GList *children = gtk_container_get_children(GTK_CONTAINER(item->widget));
+        gtk_image_set_from_pixbuf(GTK_IMAGE(children->data), pixbuf);
+        gtk_widget_show(GTK_WIDGET(children->data));
+        g_list_free(children);
+    }
+}
+
 static void group_handle_special(GKeyFile *key_file,
                                  ShellModuleEntry *entry,
                                  const gchar *group,
@@ -1120,20 +1185,11 @@ static void group_handle_special(GKeyFile *key_file,
         gchar *key = keys[i];
 
         if (g_str_has_prefix(key, "UpdateInterval")) {
-            ShellFieldUpdate *fu = g_new0(ShellFieldUpdate, 1);
-            ShellFieldUpdateSource *sfutbl;
             gint ms;
 
             ms = g_key_file_get_integer(key_file, group, key, NULL);
 
-            fu->field_name = g_strdup(g_utf8_strchr(key, -1, '$') + 1);
-            fu->entry = entry;
-
-            sfutbl = g_new0(ShellFieldUpdateSource, 1);
-            sfutbl->source_id = g_timeout_add(ms, update_field, fu);
-            sfutbl->sfu = fu;
-
-            update_sfusrc = g_slist_prepend(update_sfusrc, sfutbl);
+            field_update_add(entry, g_utf8_strchr(key, -1, '$') + 1, ms);
         } else if (g_str_equal(key, "NormalizePercentage")) {
             shell->normalize_percentage =
                 g_key_file_get_boolean(key_file, group, key, NULL);
@@ -1157,28 +1213,10 @@ static void group_handle_special(GKeyFile *key_file,
             headers_visible =
                 g_key_file_get_boolean(key_file, group, key, NULL);
         } else if (g_str_has_prefix(key, "ColumnTitle")) {
-            GtkTreeViewColumn *column = NULL;
             gchar *value, *title = g_utf8_strchr(key, -1, '$') + 1;
 
             value = g_key_file_get_value(key_file, group, key, NULL);
-
-            if (g_str_equal(title, "Extra1")) {
-                column = shell->info_tree->col_extra1;
-            } else if (g_str_equal(title, "Extra2")) {
-                column = shell->info_tree->col_extra2;
-            } else if (g_str_equal(title, "Value")) {
-                column = shell->info_tree->col_value;
-            } else if (g_str_equal(title, "TextValue")) {
-                column = shell->info_tree->col_textvalue;
-            } else if (g_str_equal(title, "Progress")) {
-                column = shell->info_tree->col_progress;
-            }
-
-            if (column) {
-                gtk_tree_view_column_set_title(column, value);
-                gtk_tree_view_column_set_visible(column, TRUE);
-            }
-
+            info_tree_set_column_title(title, value);
             g_free(value);
         } else if (g_str_equal(key, "OrderType")) {
             shell->_order_type =
@@ -1199,20 +1237,9 @@ static void group_handle_special(GKeyFile *key_file,
 
             if (item) {
                 gchar *file = g_key_file_get_value(key_file, group, key, NULL);
-                GdkPixbuf *pixbuf = icon_cache_get_pixbuf_at_size(file, 22, 22);
 
+                update_item_set_icon(item, file);
                 g_free(file);
-
-                if (item->is_iter) {
-                    gtk_tree_store_set(
-                        GTK_TREE_STORE(shell->info_tree->model), item->iter,
-                        INFO_TREE_COL_PBUF, pixbuf, -1);
-                } else {
-                    GList *children = gtk_container_get_children(GTK_CONTAINER(item->widget));
-                    gtk_image_set_from_pixbuf(GTK_IMAGE(children->data), pixbuf);
-                    gtk_widget_show(GTK_WIDGET(children->data));
-                    g_list_free(children);
-                }
             }
         } else if (g_str_equal(key, "Zebra")) {
 #if GTK_CHECK_VERSION(3, 0, 0)
@@ -1228,6 +1255,32 @@ static void group_handle_special(GKeyFile *key_file,
                                       headers_visible);
 }
 
+/* "value|extra1|extra2" */
+static void info_tree_set_value(GtkTreeStore *store, GtkTreeIter *iter,
+                                const gchar *value)
+{
+    /* FIXME: use g_key_file_get_string_list? */
+    if (g_utf8_strchr(value, -1, '|')) {
+        gchar **columns = g_strsplit(value, "|", 0);
+
+        gtk_tree_store_set(store, iter, INFO_TREE_COL_VALUE,
+                           columns[0], -1);
+        if (columns[1]) {
+            gtk_tree_store_set(store, iter, INFO_TREE_COL_EXTRA1,
+                               columns[1], -1);
+            if (columns[2]) {
+                gtk_tree_store_set(store, iter, INFO_TREE_COL_EXTRA2,
+                                   columns[2], -1);
+            }
+        }
+
+        g_strfreev(columns);
+    } else {
+        gtk_tree_store_set(store, iter, INFO_TREE_COL_VALUE, value,
+                           -1);
+    }
+}
+
 static void group_handle_normal(GKeyFile *key_file,
                                 ShellModuleEntry *entry,
                                 const gchar *group,
@@ -1255,7 +1308,7 @@ static void group_handle_normal(GKeyFile *key_file,
         value = g_key_file_get_value(key_file, group, key, NULL);
         if (entry->fieldfunc && value && g_str_equal(value, "...")) {
             g_free(value);
-            value = entry->fieldfunc(key);
+            value = module_entry_get_field(entry, key);
         }
 
         if ((key && value) && g_utf8_validate(key, -1, NULL) &&
@@ -1266,26 +1319,7 @@ static void group_handle_normal(GKeyFile *key_file,
                 gtk_tree_store_append(store, &child, &parent);
             }
 
-            /* FIXME: use g_key_file_get_string_list? */
-            if (g_utf8_strchr(value, -1, '|')) {
-                gchar **columns = g_strsplit(value, "|", 0);
-
-                gtk_tree_store_set(store, &child, INFO_TREE_COL_VALUE,
-                                   columns[0], -1);
-                if (columns[1]) {
-                    gtk_tree_store_set(store, &child, INFO_TREE_COL_EXTRA1,
-                                       columns[1], -1);
-                    if (columns[2]) {
-                        gtk_tree_store_set(store, &child, INFO_TREE_COL_EXTRA2,
-                                           columns[2], -1);
-                    }
-                }
-
-                g_strfreev(columns);
-            } else {
-                gtk_tree_store_set(store, &child, INFO_TREE_COL_VALUE, value,
-                                   -1);
-            }
+            info_tree_set_value(store, &child, value);
 
             strend(key, '#');
 
@@ -1495,6 +1529,72 @@ static void module_selected_show_info_list(GKeyFile *key_file,
     gtk_tree_view_set_show_expanders(GTK_TREE_VIEW(shell->info_tree->view),
                                      ngroups > 1);
 }
+/* a titled table for rows fields, in the detail view */
+static GtkWidget *detail_view_add_table(const gchar *name, gint rows)
+{
+    gchar *tmp = g_strdup_printf("<b>%s</b>", name);
+    GtkWidget *label = gtk_label_new(tmp);
+    gtk_label_set_use_markup(GTK_LABEL(label), TRUE);
+    GtkWidget *frame = gtk_frame_new(NULL);
+    gtk_frame_set_label_widget(GTK_FRAME(frame), label);
+    gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_NONE);
+    g_free(tmp);
+
+    gtk_container_set_border_width(GTK_CONTAINER(frame), 12);
+    gtk_box_pack_start(GTK_BOX(shell->detail_view->view), frame, FALSE,
+                       FALSE, 0);
+
+    GtkWidget *table = gtk_table_new(rows, 2, FALSE);
+    gtk_container_set_border_width(GTK_CONTAINER(table), 4);
+    gtk_container_add(GTK_CONTAINER(frame), table);
+
+    gtk_widget_show(table);
+    gtk_widget_show(label);
+    gtk_widget_show(frame);
+
+    return table;
+}
+
+/* returns the box with the value's icon and label, for update_tbl */
+static GtkWidget *detail_view_add_field(GtkWidget *table, gint row,
+                                        const gchar *label, const gchar *value)
+{
+    gchar *key_markup;
+
+    key_markup = g_strdup_printf("<span color=\"#666\">%s</span>", label);
+
+    GtkWidget *key_label = gtk_label_new(key_markup);
+    gtk_label_set_use_markup(GTK_LABEL(key_label), TRUE);
+    gtk_misc_set_alignment(GTK_MISC(key_label), 1.0f, 0.5f);
+
+    GtkWidget *value_label = gtk_label_new(value);
+    gtk_label_set_use_markup(GTK_LABEL(value_label), TRUE);
+    gtk_label_set_selectable(GTK_LABEL(value_label), TRUE);
+#if !GTK_CHECK_VERSION(3, 0, 0)
+    gtk_label_set_line_wrap(GTK_LABEL(value_label), TRUE);
+#endif
+    gtk_misc_set_alignment(GTK_MISC(value_label), 0.0f, 0.5f);
+
+    GtkWidget *value_icon = gtk_image_new();
+
+    GtkWidget *value_box = gtk_hbox_new(FALSE, 4);
+    gtk_box_pack_start(GTK_BOX(value_box), value_icon, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(value_box), value_label, TRUE, TRUE, 0);
+
+    gtk_widget_show(key_label);
+    gtk_widget_show(value_box);
+    gtk_widget_show(value_label);
+
+    gtk_table_attach(GTK_TABLE(table), key_label, 0, 1, row, row + 1,
+                     GTK_FILL, GTK_FILL, 6, 4);
+    gtk_table_attach(GTK_TABLE(table), value_box, 1, 2, row, row + 1,
+                     GTK_FILL | GTK_EXPAND, GTK_FILL, 0, 4);
+
+    g_free(key_markup);
+
+    return value_box;
+}
+
 static void module_selected_show_info_detail(GKeyFile *key_file,
                                              ShellModuleEntry *entry,
                                              gchar **groups)
@@ -1510,25 +1610,10 @@ static void module_selected_show_info_detail(GKeyFile *key_file,
         if (entry && groups[i][0] == '$') {
             group_handle_special(key_file, entry, groups[i], keys);
         } else {
-            gchar *tmp = g_strdup_printf("<b>%s</b>", groups[i]);
-            GtkWidget *label = gtk_label_new(tmp);
-            gtk_label_set_use_markup(GTK_LABEL(label), TRUE);
-            GtkWidget *frame = gtk_frame_new(NULL);
-            gtk_frame_set_label_widget(GTK_FRAME(frame), label);
-            gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_NONE);
-            g_free(tmp);
-
-            gtk_container_set_border_width(GTK_CONTAINER(frame), 12);
-            gtk_box_pack_start(GTK_BOX(shell->detail_view->view), frame, FALSE,
-                               FALSE, 0);
-
-            GtkWidget *table = gtk_table_new(nkeys, 2, FALSE);
-            gtk_container_set_border_width(GTK_CONTAINER(table), 4);
-            gtk_container_add(GTK_CONTAINER(frame), table);
+            GtkWidget *table = detail_view_add_table(groups[i], nkeys);
 
             gint j;
             for (j = 0; keys[j]; j++) {
-                gchar *key_markup;
                 gchar *value;
                 gchar *name = NULL, *label = NULL, *tag = NULL;
                 key_get_components(keys[j], NULL, &tag, &name, &label, NULL, TRUE);
@@ -1537,38 +1622,10 @@ static void module_selected_show_info_detail(GKeyFile *key_file,
 
                 if (entry && entry->fieldfunc && value && g_str_equal(value, "...")) {
                     g_free(value);
-                    value = entry->fieldfunc(name);
+                    value = module_entry_get_field(entry, name);
                 }
 
-                key_markup =
-                    g_strdup_printf("<span color=\"#666\">%s</span>", label);
-
-                GtkWidget *key_label = gtk_label_new(key_markup);
-                gtk_label_set_use_markup(GTK_LABEL(key_label), TRUE);
-                gtk_misc_set_alignment(GTK_MISC(key_label), 1.0f, 0.5f);
-
-                GtkWidget *value_label = gtk_label_new(value);
-                gtk_label_set_use_markup(GTK_LABEL(value_label), TRUE);
-                gtk_label_set_selectable(GTK_LABEL(value_label), TRUE);
-#if !GTK_CHECK_VERSION(3, 0, 0)
-                gtk_label_set_line_wrap(GTK_LABEL(value_label), TRUE);
-#endif
-                gtk_misc_set_alignment(GTK_MISC(value_label), 0.0f, 0.5f);
-
-                GtkWidget *value_icon = gtk_image_new();
-
-                GtkWidget *value_box = gtk_hbox_new(FALSE, 4);
-                gtk_box_pack_start(GTK_BOX(value_box), value_icon, FALSE, FALSE, 0);
-                gtk_box_pack_start(GTK_BOX(value_box), value_label, TRUE, TRUE, 0);
-
-                gtk_widget_show(key_label);
-                gtk_widget_show(value_box);
-                gtk_widget_show(value_label);
-
-                gtk_table_attach(GTK_TABLE(table), key_label, 0, 1, j, j + 1,
-                                 GTK_FILL, GTK_FILL, 6, 4);
-                gtk_table_attach(GTK_TABLE(table), value_box, 1, 2, j, j + 1,
-                                 GTK_FILL | GTK_EXPAND, GTK_FILL, 0, 4);
+                GtkWidget *value_box = detail_view_add_field(table, j, label, value);
 
                 struct UpdateTableItem *item = g_new0(struct UpdateTableItem, 1);
                 item->is_iter = FALSE;
@@ -1583,23 +1640,172 @@ static void module_selected_show_info_detail(GKeyFile *key_file,
                 }
 
                 g_free(value);
-                g_free(key_markup);
                 g_free(label);
             }
-
-            gtk_widget_show(table);
-            gtk_widget_show(label);
-            gtk_widget_show(frame);
         }
 
         g_strfreev(keys);
     }
 }
 
+/*
+ * Entries whose callback returns a struct Info (MODULE_FLAG_INFO) are shown
+ * from it directly; the functions above parse the INI text of the others.
+ */
+
+static gchar *info_field_get_shown_value(ShellModuleEntry *entry,
+                                         const struct InfoField *field)
+{
+    if (entry->fieldfunc && g_strcmp0(field->value, "...") == 0)
+        return module_entry_get_field(entry, (gchar *)field->name);
+
+    return info_field_get_value(field);
+}
+
+/* sets up the field's icon and updates, and files item in update_tbl */
+static void info_field_add_item(ShellModuleEntry *entry,
+                                const struct InfoField *field,
+                                struct UpdateTableItem *item)
+{
+    if (field->icon)
+        update_item_set_icon(item, field->icon);
+
+    /* update_field() finds the row by the name it asks hi_get_field() for */
+    if (field->update_interval) {
+        g_hash_table_insert(update_tbl, g_strdup(field->name), item);
+        field_update_add(entry, field->name, field->update_interval);
+    } else {
+        g_hash_table_insert(update_tbl,
+                            g_strdup(*field->tag ? field->tag : field->name), item);
+    }
+}
+
+static void info_apply_params(ShellModuleEntry *entry, struct Info *info)
+{
+    gint i;
+
+    shell->normalize_percentage = info->normalize_percentage;
+
+    if (info->reload_interval)
+        g_timeout_add(info->reload_interval, reload_section, entry);
+
+    for (i = 0; i < INFO_COLUMN_MAX; i++) {
+        if (info->column_titles[i])
+            info_tree_set_column_title(info_column_titles[i],
+                                       info->column_titles[i]);
+    }
+
+#if !GTK_CHECK_VERSION(3, 0, 0)
+    if (info->zebra_visible)
+        gtk_tree_view_set_rules_hint(GTK_TREE_VIEW(shell->info_tree->view), TRUE);
+#endif
+
+    gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(shell->info_tree->view),
+                                      info->column_headers_visible);
+}
+
+static void info_show_list(ShellModuleEntry *entry, struct Info *info)
+{
+    GtkTreeStore *store = GTK_TREE_STORE(shell->info_tree->model);
+    guint ngroups = info->groups->len;
+    guint i, j;
+
+    gtk_tree_store_clear(store);
+
+    g_object_ref(shell->info_tree->model);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(shell->info_tree->view), NULL);
+
+    for (i = 0; i < ngroups; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+        GtkTreeIter parent;
+
+        if (ngroups > 1) {
+            gtk_tree_store_append(store, &parent, NULL);
+            gtk_tree_store_set(store, &parent, INFO_TREE_COL_NAME, group->name, -1);
+        }
+
+        for (j = 0; j < group->fields->len; j++) {
+            struct InfoField *field = &g_array_index(group->fields, struct InfoField, j);
+            struct UpdateTableItem *item;
+            GtkTreeIter child;
+            gchar *value, *flags;
+
+            value = info_field_get_shown_value(entry, field);
+            if (!value || !g_utf8_validate(field->name, -1, NULL) ||
+                !g_utf8_validate(value, -1, NULL)) {
+                g_free(value);
+                continue;
+            }
+
+            gtk_tree_store_append(store, &child, ngroups > 1 ? &parent : NULL);
+            info_tree_set_value(store, &child, value);
+
+            flags = info_field_get_flags(field);
+            gtk_tree_store_set(store, &child, INFO_TREE_COL_NAME, field->name,
+                               INFO_TREE_COL_DATA, flags, -1);
+
+            item = g_new0(struct UpdateTableItem, 1);
+            item->is_iter = TRUE;
+            item->iter = gtk_tree_iter_copy(&child);
+            info_field_add_item(entry, field, item);
+
+            g_free(flags);
+            g_free(value);
+        }
+    }
+
+    info_apply_params(entry, info);
+
+    g_object_unref(shell->info_tree->model);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(shell->info_tree->view),
+                            shell->info_tree->model);
+    gtk_tree_view_expand_all(GTK_TREE_VIEW(shell->info_tree->view));
+    gtk_tree_view_set_show_expanders(GTK_TREE_VIEW(shell->info_tree->view),
+                                     ngroups > 1);
+}
+
+static void info_show_detail(ShellModuleEntry *entry, struct Info *info)
+{
+    guint i, j;
+
+    detail_view_clear(shell->detail_view);
+
+    for (i = 0; i < info->groups->len; i++) {
+        struct InfoGroup *group = &g_array_index(info->groups, struct InfoGroup, i);
+        GtkWidget *table;
+        gint row = 0;
+
+        table = detail_view_add_table(group->name ? group->name : "",
+                                      group->fields->len);
+
+        for (j = 0; j < group->fields->len; j++) {
+            struct InfoField *field = &g_array_index(group->fields, struct InfoField, j);
+            struct UpdateTableItem *item;
+            GtkWidget *value_box;
+            gchar *value;
+
+            if (!(value = info_field_get_shown_value(entry, field)))
+                continue;
+
+            value_box = detail_view_add_field(table, row++, field->name, value);
+
+            item = g_new0(struct UpdateTableItem, 1);
+            item->is_iter = FALSE;
+            item->widget = g_object_ref(value_box);
+            info_field_add_item(entry, field, item);
+
+            g_free(value);
+        }
+    }
+
+    info_apply_params(entry, info);
+}
+
 static void
 module_selected_show_info(ShellModuleEntry *entry, gboolean reload)
 {
     GdkWindow *gdk_window = gtk_widget_get_window(GTK_WIDGET(shell->info_tree->view));
+    struct Info *info;
     gsize ngroups;
     gint i;
 
@@ -1612,29 +1818,41 @@ module_selected_show_info(ShellModuleEntry *entry, gboolean reload)
     }
     shell_clear_field_updates();
 
-    GKeyFile *key_file = g_key_file_new();
-    gchar *key_data = module_entry_function(entry);
+    if ((info = module_entry_get_info(entry))) {
+        set_view_type(info->view_type, reload);
 
-    g_key_file_load_from_data(key_file, key_data, strlen(key_data), 0, NULL);
-    set_view_type(g_key_file_get_integer(key_file, "$ShellParam$",
-                                         "ViewType", NULL), reload);
+        if (shell->view_type == SHELL_VIEW_DETAIL) {
+            info_show_detail(entry, info);
+        } else {
+            info_show_list(entry, info);
+        }
 
-    gchar **groups = g_key_file_get_groups(key_file, &ngroups);
+        info_free(info);
+    } else {
+        GKeyFile *key_file = g_key_file_new();
+        gchar *key_data = module_entry_function(entry);
 
-    for (i = 0; groups[i]; i++) {
-	if (groups[i][0] == '$')
-	    ngroups--;
-    }
+        g_key_file_load_from_data(key_file, key_data, strlen(key_data), 0, NULL);
+        set_view_type(g_key_file_get_integer(key_file, "$ShellParam$",
+                                             "ViewType", NULL), reload);
 
-    if (shell->view_type == SHELL_VIEW_DETAIL) {
-        module_selected_show_info_detail(key_file, entry, groups);
-    } else {
-        module_selected_show_info_list(key_file, entry, groups, ngroups);
-    }
+        gchar **groups = g_key_file_get_groups(key_file, &ngroups);
 
-    g_strfreev(groups);
-    g_key_file_free(key_file);
-    g_free(key_data);
+        for (i = 0; groups[i]; i++) {
+            if (groups[i][0] == '$')
+                ngroups--;
+        }
+
+        if (shell->view_type == SHELL_VIEW_DETAIL) {
+            module_selected_show_info_detail(key_file, entry, groups);
+        } else {
+            module_selected_show_info_list(key_file, entry, groups, ngroups);
+        }
+
+        g_strfreev(groups);
+        g_key_file_free(key_file);
+        g_free(key_data);
+    }
 
     switch (shell->view_type) {
     case SHELL_VIEW_PROGRESS_DUAL: